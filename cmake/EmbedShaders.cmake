@@ -0,0 +1,62 @@
+# Embeds WGSL sources into a C++ header as constexpr std::string_view constants, run as a build step:
+#   cmake -DSHADER_DIR=<dir> -DSHADERS=<a.wgsl;b.wgsl> -DOUTPUT=<header> -P EmbedShaders.cmake
+# Each shader in SHADERS becomes EmbeddedShaders::<NAME>_WGSL (shader.wgsl -> SHADER_WGSL).
+# A line '#include "name.wgsl"' is replaced by that file (relative to the including file), once per shader,
+# so snippets can be shared between shaders. WGSL has no preprocessor of its own
+cmake_minimum_required(VERSION 3.20)
+
+foreach(variable SHADER_DIR SHADERS OUTPUT)
+    if(NOT DEFINED ${variable})
+        message(FATAL_ERROR "EmbedShaders.cmake needs -D${variable}=...")
+    endif()
+endforeach()
+
+# Expands the includes of path into out_var, files already in EMBED_INCLUDED are skipped
+function(expand_includes path out_var)
+    file(READ "${path}" content)
+    get_filename_component(directory "${path}" DIRECTORY)
+    # Directives only count at the start of a line
+    string(REGEX MATCHALL "(^|\n)#include \"[^\"\n]+\"" directives "${content}")
+    foreach(directive IN LISTS directives)
+        string(REGEX REPLACE "^\n?#include \"([^\"]+)\"$" "\\1" name "${directive}")
+        string(REGEX MATCH "^\n?" lineStart "${directive}")
+        get_filename_component(included "${directory}/${name}" ABSOLUTE)
+        if(NOT EXISTS "${included}")
+            message(FATAL_ERROR "${path}: cannot include ${name}")
+        endif()
+        get_property(seen GLOBAL PROPERTY EMBED_INCLUDED)
+        if("${included}" IN_LIST seen)
+            set(expanded "// ${name} is already included")
+        else()
+            set_property(GLOBAL APPEND PROPERTY EMBED_INCLUDED "${included}")
+            expand_includes("${included}" expanded)
+        endif()
+        string(REPLACE "${directive}" "${lineStart}${expanded}" content "${content}")
+    endforeach()
+    set(${out_var} "${content}" PARENT_SCOPE)
+endfunction()
+
+set(header "// Generated by cmake/EmbedShaders.cmake from ${SHADER_DIR}, do not edit\n")
+string(APPEND header "#pragma once\n#include <string_view>\n\nnamespace EmbeddedShaders {\n")
+foreach(shader IN LISTS SHADERS)
+    get_filename_component(path "${SHADER_DIR}/${shader}" ABSOLUTE)
+    set_property(GLOBAL PROPERTY EMBED_INCLUDED "${path}")
+    expand_includes("${path}" source)
+    if(source MATCHES "\\)wgsl\"")
+        message(FATAL_ERROR "${shader} contains the raw string delimiter )wgsl\"")
+    endif()
+
+    get_filename_component(name "${shader}" NAME_WE)
+    string(TOUPPER "${name}" name)
+    string(MAKE_C_IDENTIFIER "${name}" name)
+    string(APPEND header "\n// ${shader}\ninline constexpr std::string_view ${name}_WGSL = R\"wgsl(${source})wgsl\";\n")
+endforeach()
+string(APPEND header "\n}\n")
+
+# Leave the header alone when nothing changed, so an unrelated shader edit does not rebuild everything
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+endif()
+if(NOT previous STREQUAL header)
+    file(WRITE "${OUTPUT}" "${header}")
+endif()
@@ -0,0 +1,46 @@
+// Size report of the web build: raw, gzip and brotli bytes of every file the page downloads, against budgets.
+// Usage: node scripts/size-report.mjs [dist directory] [--strict]  (--strict exits 1 when a budget is exceeded)
+import { readFileSync, existsSync } from 'node:fs';
+import { join } from 'node:path';
+import { gzipSync, brotliCompressSync, constants } from 'node:zlib';
+
+// Compressed (brotli) byte budgets, what a CDN serves
+const BUDGETS = {
+    'index.wasm': 256 * 1024,
+    'index.js': 48 * 1024,
+    'index.html': 8 * 1024,
+    'life-host.js': 4 * 1024,
+};
+
+const args = process.argv.slice(2);
+const strict = args.includes('--strict');
+const dist = args.find((arg) => !arg.startsWith('--')) ?? 'dist';
+
+const kib = (bytes) => (bytes / 1024).toFixed(1).padStart(8) + ' KiB';
+let over = 0;
+let totals = [0, 0, 0];
+console.log('file'.padEnd(12) + 'raw'.padStart(12) + 'gzip'.padStart(12) + 'brotli'.padStart(12) + '  budget');
+for (const [name, budget] of Object.entries(BUDGETS)) {
+    const path = join(dist, name);
+    if (!existsSync(path)) {
+        console.log(name.padEnd(12) + '  missing, build first (npm run build:release)');
+        over++;
+        continue;
+    }
+    const data = readFileSync(path);
+    const sizes = [
+        data.length,
+        gzipSync(data, { level: 9 }).length,
+        brotliCompressSync(data, { params: { [constants.BROTLI_PARAM_QUALITY]: 11 } }).length,
+    ];
+    totals = totals.map((total, i) => total + sizes[i]);
+    const exceeded = sizes[2] > budget;
+    if (exceeded) over++;
+    console.log(name.padEnd(12) + sizes.map(kib).join('') + '  ' + kib(budget).trim() + (exceeded ? '  OVER' : ''));
+}
+console.log('total'.padEnd(12) + totals.map(kib).join(''));
+
+if (over > 0) {
+    console.warn(over + ' file(s) over budget or missing');
+    if (strict) process.exit(1);
+}
@@ -0,0 +1,52 @@
+#include "CellEditor.h"
+#include "Trace.h"
+
+CellEditor::CellEditor(wgpu::Device device, wgpu::Queue queue, uint32_t width, uint32_t height)
+    : queue(queue)
+    , width(width)
+    , height(height)
+{
+    wgpu::BufferDescriptor editDesc {};
+    editDesc.setDefault();
+    editDesc.label = "Cell edits";
+    editDesc.size = EDIT_BUFFER_SIZE;
+    editDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+    editBuffer = device.createBuffer(editDesc);
+    staging.reserve(1 + MAX_EDITS_PER_FRAME);
+}
+
+CellEditor::~CellEditor()
+{
+    if (editBuffer) editBuffer.release();
+}
+
+void CellEditor::setCell(int64_t x, int64_t y, bool alive)
+{
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    const uint32_t index = static_cast<uint32_t>((y + 1) * (width + 2) + x + 1);
+    pending[index] = alive ? 1 : 0;
+}
+
+void CellEditor::stamp(const Grid& pattern, int64_t x, int64_t y)
+{
+    for (uint32_t py = 0; py < pattern.getHeight(); py++) {
+        for (uint32_t px = 0; px < pattern.getWidth(); px++) {
+            if (pattern.getCell(px, py)) setCell(x + px, y - py, true);
+        }
+    }
+}
+
+uint32_t CellEditor::upload()
+{
+    if (pending.empty()) return 0;
+    TRACE_SCOPE("CellEditor::upload");
+    staging.assign(1, 0);
+    for (auto it = pending.begin(); it != pending.end() && staging.size() <= MAX_EDITS_PER_FRAME;) {
+        staging.push_back(it->first << 1 | it->second);
+        it = pending.erase(it);
+    }
+    const uint32_t count = static_cast<uint32_t>(staging.size() - 1);
+    staging[0] = count;
+    queue.writeBuffer(editBuffer, 0, staging.data(), staging.size() * sizeof(uint32_t));
+    return count;
+}
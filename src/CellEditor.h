@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "webgpu.hpp"
+#include "Grid.h"
+
+// Pointer edits (draw, erase, stamp) of the GPU board. The board only lives on the GPU, so edits are not uploaded
+// as rectangles of cells (that would need a CPU copy of every untouched cell in them). Instead each frame's edits
+// are deduplicated, packed as (storage index << 1 | state) words into a small buffer with a single writeBuffer,
+// and applied by editMain (shader.wgsl), a scatter pass with one invocation per edited cell. Upload size and GPU
+// work follow the number of edited cells, never the board size, and the full board is never re-sent
+class CellEditor
+{
+public:
+    // Edits beyond this wait for the next frame, so a huge stamp is spread out instead of stalling one frame
+    static constexpr uint32_t MAX_EDITS_PER_FRAME = 1u << 16;
+    // Mirrors CellEdits in shader.wgsl: the edit count followed by the packed cells
+    static constexpr uint64_t EDIT_BUFFER_SIZE = (1 + MAX_EDITS_PER_FRAME) * sizeof(uint32_t);
+
+private:
+    wgpu::Queue queue{nullptr};
+    wgpu::Buffer editBuffer{nullptr};
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // Storage index to state, a cell edited twice before the upload keeps its last state
+    std::unordered_map<uint32_t, uint8_t> pending;
+    std::vector<uint32_t> staging;
+
+public:
+    // width x height is the board, stored with a one-cell halo (see storageIndex in shader.wgsl)
+    CellEditor(wgpu::Device device, wgpu::Queue queue, uint32_t width, uint32_t height);
+    ~CellEditor();
+    CellEditor(const CellEditor&) = delete;
+    CellEditor& operator=(const CellEditor&) = delete;
+
+    // Bound as binding 5 of the cell bind groups
+    const wgpu::Buffer& getEditBuffer() const { return editBuffer; }
+
+    // Cells off the board are dropped, whatever the topology
+    void setCell(int64_t x, int64_t y, bool alive);
+    // Live cells of pattern with its top-left cell at (x, y). Pattern rows run down the screen,
+    // which is towards smaller y on the board (vertexMain puts y = 0 at the bottom)
+    void stamp(const Grid& pattern, int64_t x, int64_t y);
+    void clear() { pending.clear(); }
+    bool hasPending() const { return !pending.empty(); }
+
+    // Uploads up to MAX_EDITS_PER_FRAME pending edits and returns how many editMain has to apply
+    uint32_t upload();
+};
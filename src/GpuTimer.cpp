@@ -0,0 +1,144 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer(wgpu::Device device, wgpu::Queue queue, bool timestampsSupported)
+    : device(device)
+    , queue(queue)
+    , timestampsSupported(timestampsSupported)
+{
+    if (!timestampsSupported) return;
+
+    wgpu::QuerySetDescriptor querySetDesc {};
+    querySetDesc.setDefault();
+    querySetDesc.label = "Pass timestamps";
+    querySetDesc.type = wgpu::QueryType::Timestamp;
+    querySetDesc.count = QUERY_COUNT;
+    querySet = device.createQuerySet(querySetDesc);
+
+    wgpu::BufferDescriptor resolveDesc {};
+    resolveDesc.setDefault();
+    resolveDesc.label = "Timestamp resolve";
+    resolveDesc.size = QUERY_BUFFER_SIZE;
+    resolveDesc.usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc;
+    resolveBuffer = device.createBuffer(resolveDesc);
+
+    wgpu::BufferDescriptor readbackDesc {};
+    readbackDesc.setDefault();
+    readbackDesc.label = "Timestamp readback";
+    readbackDesc.size = QUERY_BUFFER_SIZE;
+    readbackDesc.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+    for (auto& readback : readbacks) {
+        readback.buffer = device.createBuffer(readbackDesc);
+    }
+
+    // The GPU path still works without timings, so a failure here only disables them
+    if (!querySet || !resolveBuffer) {
+        this->timestampsSupported = false;
+        return;
+    }
+
+    computeTimestampWrites.setDefault();
+    computeTimestampWrites.querySet = querySet;
+    computeTimestampWrites.beginningOfPassWriteIndex = 0;
+    computeTimestampWrites.endOfPassWriteIndex = 1;
+
+    renderTimestampWrites.setDefault();
+    renderTimestampWrites.querySet = querySet;
+    renderTimestampWrites.beginningOfPassWriteIndex = 2;
+    renderTimestampWrites.endOfPassWriteIndex = 3;
+}
+
+GpuTimer::~GpuTimer()
+{
+    for (auto& readback : readbacks) {
+        if (readback.buffer) readback.buffer.release();
+    }
+    if (resolveBuffer) resolveBuffer.release();
+    if (querySet) querySet.release();
+}
+
+void GpuTimer::beginFrame()
+{
+    encodeStart = std::chrono::steady_clock::now();
+    activeReadback = -1;
+    if (!timestampsSupported) return;
+    for (uint32_t i = 0; i < READBACK_COUNT; i++) {
+        if (!readbacks[i].busy) {
+            activeReadback = static_cast<int>(i);
+            return;
+        }
+    }
+}
+
+const wgpu::ComputePassTimestampWrites* GpuTimer::getComputeTimestampWrites() const
+{
+    return activeReadback >= 0 ? &computeTimestampWrites : nullptr;
+}
+
+const wgpu::RenderPassTimestampWrites* GpuTimer::getRenderTimestampWrites() const
+{
+    return activeReadback >= 0 ? &renderTimestampWrites : nullptr;
+}
+
+void GpuTimer::resolve(const wgpu::CommandEncoder& encoder)
+{
+    if (activeReadback < 0) return;
+    encoder.resolveQuerySet(querySet, 0, QUERY_COUNT, resolveBuffer, 0);
+    encoder.copyBufferToBuffer(resolveBuffer, 0, readbacks[activeReadback].buffer, 0, QUERY_BUFFER_SIZE);
+}
+
+void GpuTimer::afterSubmit()
+{
+    // One submit-to-done measurement in flight at a time is plenty for percentiles
+    if (!workDonePending) {
+        workDonePending = true;
+        submitTime = std::chrono::steady_clock::now();
+        workDoneCallback = queue.onSubmittedWorkDone([this](wgpu::QueueWorkDoneStatus status) {
+            workDonePending = false;
+            if (status != wgpu::QueueWorkDoneStatus::Success) return;
+            const auto elapsed = std::chrono::steady_clock::now() - submitTime;
+            samples[static_cast<uint32_t>(Pass::SubmitToDone)].push(
+                std::chrono::duration<double, std::milli>(elapsed).count());
+        });
+    }
+
+    if (activeReadback >= 0) {
+        const uint32_t readbackIndex = static_cast<uint32_t>(activeReadback);
+        Readback& readback = readbacks[readbackIndex];
+        readback.busy = true;
+        readback.mapCallback = readback.buffer.mapAsync(wgpu::MapMode::Read, 0, QUERY_BUFFER_SIZE,
+            [this, readbackIndex](wgpu::BufferMapAsyncStatus status) {
+                if (status == wgpu::BufferMapAsyncStatus::Success) {
+                    readTimestamps(readbackIndex);
+                } else {
+                    readbacks[readbackIndex].busy = false;
+                }
+            });
+        activeReadback = -1;
+    }
+
+    const auto encodeTime = std::chrono::steady_clock::now() - encodeStart;
+    samples[static_cast<uint32_t>(Pass::Encode)].push(std::chrono::duration<double, std::milli>(encodeTime).count());
+}
+
+void GpuTimer::readTimestamps(uint32_t readbackIndex)
+{
+    Readback& readback = readbacks[readbackIndex];
+    const auto* timestamps = static_cast<const uint64_t*>(
+        readback.buffer.getConstMappedRange(0, QUERY_BUFFER_SIZE));
+    if (timestamps) {
+        auto record = [this](Pass pass, uint64_t begin, uint64_t end) {
+            // Timestamps can be quantized or reset by the browser, drop non-monotonic pairs
+            if (end <= begin) return;
+            samples[static_cast<uint32_t>(pass)].push(static_cast<double>(end - begin) / 1e6);
+        };
+        record(Pass::Compute, timestamps[0], timestamps[1]);
+        record(Pass::Render, timestamps[2], timestamps[3]);
+    }
+    readback.buffer.unmap();
+    readback.busy = false;
+}
+
+double GpuTimer::getPercentileMs(Pass pass, double percentile) const
+{
+    return samples[static_cast<uint32_t>(pass)].percentile(percentile);
+}
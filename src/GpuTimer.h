@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "webgpu.hpp"
+#include "RollingStats.h"
+
+// Per-pass GPU timings for Life::renderFrame.
+// With the timestamp-query feature, the compute and render passes write begin/end timestamps that are
+// resolved and read back asynchronously (a few readback buffers in flight, frames are skipped rather than stalled).
+// Submit-to-done CPU time from onSubmittedWorkDone is always collected and is the only timing without the feature,
+// and so is the CPU time renderFrame spends encoding and submitting the frame
+class GpuTimer
+{
+public:
+    enum class Pass : uint32_t {
+        Compute = 0,
+        Render = 1,
+        SubmitToDone = 2,
+        Encode = 3,  // CPU: beginFrame to the end of afterSubmit
+    };
+    static constexpr uint32_t PASS_COUNT = 4;
+
+private:
+    struct Readback {
+        wgpu::Buffer buffer{nullptr};
+        bool busy = false;
+        std::unique_ptr<wgpu::BufferMapCallback> mapCallback;
+    };
+
+    // Two timestamps (begin, end) per timed pass
+    static constexpr uint32_t QUERY_COUNT = 4;
+    static constexpr uint64_t QUERY_BUFFER_SIZE = QUERY_COUNT * sizeof(uint64_t);
+    static constexpr uint32_t READBACK_COUNT = 3;
+    static constexpr size_t SAMPLE_WINDOW = 240;
+
+    wgpu::Device device{nullptr};
+    wgpu::Queue queue{nullptr};
+    bool timestampsSupported = false;
+    wgpu::QuerySet querySet{nullptr};
+    wgpu::Buffer resolveBuffer{nullptr};
+    std::array<Readback, READBACK_COUNT> readbacks;
+    int activeReadback = -1;
+    wgpu::ComputePassTimestampWrites computeTimestampWrites{};
+    wgpu::RenderPassTimestampWrites renderTimestampWrites{};
+
+    std::unique_ptr<wgpu::QueueWorkDoneCallback> workDoneCallback;
+    bool workDonePending = false;
+    std::chrono::steady_clock::time_point submitTime;
+    std::chrono::steady_clock::time_point encodeStart;
+
+    std::array<RollingStats<SAMPLE_WINDOW>, PASS_COUNT> samples;
+
+    void readTimestamps(uint32_t readbackIndex);
+
+public:
+    // Pending map/work-done callbacks point back at the timer, so it is neither copyable nor movable
+    GpuTimer(wgpu::Device device, wgpu::Queue queue, bool timestampsSupported);
+    ~GpuTimer();
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    bool hasTimestamps() const { return timestampsSupported; }
+
+    // Call once per submitted frame, before encoding, to pick a free readback buffer (if any) and start the encode time
+    void beginFrame();
+    // Pass descriptors point at these, nullptr when this frame is not being timed
+    const wgpu::ComputePassTimestampWrites* getComputeTimestampWrites() const;
+    const wgpu::RenderPassTimestampWrites* getRenderTimestampWrites() const;
+    // Appends the query resolve and readback copy, call after the last timed pass
+    void resolve(const wgpu::CommandEncoder& encoder);
+    // Starts the asynchronous readbacks, call right after queue.submit
+    void afterSubmit();
+
+    // Milliseconds at percentile over the rolling window, -1 while no samples exist
+    double getPercentileMs(Pass pass, double percentile) const;
+};
@@ -0,0 +1,105 @@
+#include "HistoryRecorder.h"
+#include "Trace.h"
+#include <cstring>
+
+HistoryRecorder::HistoryRecorder(wgpu::Device device, wgpu::Queue queue, uint32_t width, uint32_t height,
+                                 size_t memoryBudget)
+    : queue(queue)
+    , packedSize(static_cast<uint64_t>(width) * height / 8)
+    , history(width, height, memoryBudget)
+{
+    wgpu::BufferDescriptor packedDesc {};
+    packedDesc.setDefault();
+    packedDesc.label = "Packed board";
+    packedDesc.size = packedSize;
+    packedDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    packedBuffer = device.createBuffer(packedDesc);
+
+    wgpu::BufferDescriptor readbackDesc {};
+    readbackDesc.setDefault();
+    readbackDesc.label = "Packed board readback";
+    readbackDesc.size = packedSize;
+    readbackDesc.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+    for (auto& readback : readbacks) {
+        readback.buffer = device.createBuffer(readbackDesc);
+    }
+}
+
+HistoryRecorder::~HistoryRecorder()
+{
+    for (auto& readback : readbacks) {
+        if (readback.buffer) readback.buffer.release();
+    }
+    if (packedBuffer) packedBuffer.release();
+}
+
+bool HistoryRecorder::beginFrame()
+{
+    activeReadback = -1;
+    for (uint32_t i = 0; i < READBACK_COUNT; i++) {
+        if (!readbacks[i].busy) {
+            activeReadback = static_cast<int>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void HistoryRecorder::resolve(const wgpu::CommandEncoder& encoder)
+{
+    if (activeReadback < 0) return;
+    encoder.copyBufferToBuffer(packedBuffer, 0, readbacks[activeReadback].buffer, 0, packedSize);
+}
+
+void HistoryRecorder::afterSubmit(uint64_t generation)
+{
+    if (activeReadback < 0) return;
+    const uint32_t readbackIndex = static_cast<uint32_t>(activeReadback);
+    Readback& readback = readbacks[readbackIndex];
+    readback.busy = true;
+    readback.generation = generation;
+    readback.epoch = epoch;
+    readback.mapCallback = readback.buffer.mapAsync(wgpu::MapMode::Read, 0, packedSize,
+        [this, readbackIndex](wgpu::BufferMapAsyncStatus status) {
+            if (status == wgpu::BufferMapAsyncStatus::Success) {
+                readBoard(readbackIndex);
+            } else {
+                readbacks[readbackIndex].busy = false;
+            }
+        });
+    activeReadback = -1;
+}
+
+void HistoryRecorder::readBoard(uint32_t readbackIndex)
+{
+    TRACE_SCOPE("HistoryRecorder::readBoard");
+    Readback& readback = readbacks[readbackIndex];
+    const void* packed = readback.buffer.getConstMappedRange(0, packedSize);
+    if (packed && readback.epoch == epoch) {
+        // Rows are whole 64-cell words, so pairs of packMain's 32-bit words are History words (little endian)
+        History::Words board(packedSize / sizeof(uint64_t));
+        std::memcpy(board.data(), packed, packedSize);
+        history.record(readback.generation, board);
+    }
+    readback.buffer.unmap();
+    readback.busy = false;
+}
+
+bool HistoryRecorder::upload(uint64_t generation)
+{
+    const std::optional<History::Words> board = history.at(generation);
+    if (!board) return false;
+    upload(*board);
+    return true;
+}
+
+void HistoryRecorder::upload(const History::Words& board)
+{
+    queue.writeBuffer(packedBuffer, 0, board.data(), packedSize);
+}
+
+void HistoryRecorder::reset()
+{
+    epoch++;
+    history.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include "webgpu.hpp"
+#include "History.h"
+
+// Feeds the GPU board into a History for rewinding. packMain (shader.wgsl) packs each new generation to one bit
+// per cell, which is copied to one of a few readback buffers and recorded once the map completes, trailing the
+// simulation by a frame or two like PeriodMonitor. Seeking goes the other way: the board of a recorded generation
+// is uploaded packed (1/32 of the cell buffer) and expanded by unpackMain
+class HistoryRecorder
+{
+private:
+    struct Readback {
+        wgpu::Buffer buffer{nullptr};
+        bool busy = false;
+        uint64_t generation = 0;
+        uint64_t epoch = 0;
+        std::unique_ptr<wgpu::BufferMapCallback> mapCallback;
+    };
+
+    static constexpr uint32_t READBACK_COUNT = 4;
+
+    wgpu::Queue queue{nullptr};
+    wgpu::Buffer packedBuffer{nullptr};
+    uint64_t packedSize = 0;
+    std::array<Readback, READBACK_COUNT> readbacks;
+    int activeReadback = -1;
+    // Bumped when the board jumps, readbacks still in flight for the old timeline are dropped
+    uint64_t epoch = 0;
+    History history;
+
+    void readBoard(uint32_t readbackIndex);
+
+public:
+    // width must be a multiple of 64 (whole History words per row)
+    HistoryRecorder(wgpu::Device device, wgpu::Queue queue, uint32_t width, uint32_t height,
+                    size_t memoryBudget = History::DEFAULT_MEMORY_BUDGET);
+    ~HistoryRecorder();
+    HistoryRecorder(const HistoryRecorder&) = delete;
+    HistoryRecorder& operator=(const HistoryRecorder&) = delete;
+
+    // Bound as binding 6 of the cell bind groups
+    const wgpu::Buffer& getPackedBuffer() const { return packedBuffer; }
+    uint64_t getPackedSize() const { return packedSize; }
+    const History& getHistory() const { return history; }
+
+    // Picks a free readback, call before the pack pass. Returns false when every readback is busy,
+    // the generation is then not recorded (and the next one starts a new keyframe)
+    bool beginFrame();
+    // Copies the packed board to the readback picked by beginFrame, call after the pack pass
+    void resolve(const wgpu::CommandEncoder& encoder);
+    // Starts the asynchronous readback of generation's board, call right after queue.submit
+    void afterSubmit(uint64_t generation);
+
+    // Records a board packed on the host (the CPU-seeded first generation)
+    void record(uint64_t generation, const History::Words& board) { history.record(generation, board); }
+    // Writes the board of generation into the packed buffer for unpackMain, false when it is not in the history
+    bool upload(uint64_t generation);
+    // Writes a board packed on the host (GRID_SIZE squared cells) into the packed buffer for unpackMain
+    void upload(const History::Words& board);
+    // Drops the readbacks in flight, call when the simulation jumps to another generation
+    void discardPending() { epoch++; }
+    // Forgets everything, call whenever the board is replaced
+    void reset();
+};
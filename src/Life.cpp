@@ -1,23 +1,101 @@
 #include "Life.h"
 #include "webgpu.hpp"
-#include "Shader.h"
+#include "EmbeddedShaders.h"
+#include "Trace.h"
+#include "CounterRng.h"
+#include "Grid.h"
+#include "Engine.h"
+#include "LeniaEngine.h"
+#include <cmath>
+#include <iostream>
 #include <random>
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
 #include <emscripten/html5.h>
+#endif
+
+namespace {
+
+#ifndef __EMSCRIPTEN__
+const std::chrono::steady_clock::time_point PROCESS_START = std::chrono::steady_clock::now();
+#endif
+
+// Page time on the web (ms since navigation start), time since the process started natively
+double nowMs()
+{
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - PROCESS_START).count();
+#endif
+}
+
+}
 
 Life::Life()
-    : cellStateArray(GRID_SIZE * GRID_SIZE)
+    : Life(std::random_device{}(), DEFAULT_DENSITY)
+{
+}
+
+Life::Life(uint64_t seed, double density)
+    : boardSeed(seed)
+    , boardDensity(density)
     , lastFrameTime(std::chrono::steady_clock::now())
 {
+    startupMs.fill(-1.0);
     requestAdapter();
-    requestDevice();
-    createSurface();
-    configureSurface();
+}
+
+Life::Life(uint64_t seed, double density, const Headless& headless)
+    : boardSeed(seed)
+    , boardDensity(density)
+    , lastFrameTime(std::chrono::steady_clock::now())
+    , headless(headless)
+{
+    startupMs.fill(-1.0);
+    requestAdapter();
+}
+
+void Life::createResources()
+{
+    TRACE_SCOPE("Life::createResources");
+    createGpuTimer();
+    createPeriodMonitor();
+    createCellEditor();
+    createHistoryRecorder();
+    if (headless) {
+        createOffscreenTarget();
+    } else {
+        createSurface();
+        configureSurface();
+    }
     createBindGroupLayout();
+    // Pipelines compile in the background while the buffers are made and the first board is uploaded
     createPipelines();
     createVertexBuffer();
     createStorageBuffers();
     createUniformBuffer();
+    createSeedBuffer();
     createBindGroup();
+    this->seed(boardSeed, boardDensity);
+}
+
+void Life::markStartup(StartupMilestone milestone)
+{
+    double& time = startupMs[static_cast<uint32_t>(milestone)];
+    if (time < 0.0) time = nowMs();
+}
+
+void Life::failStartup(const std::string& message)
+{
+    std::cerr << Life::InitializationError(message).what() << std::endl;
+    startupFailed = true;
+}
+
+void Life::setOnReady(ReadyCallback callback)
+{
+    onReady = std::move(callback);
+    if (ready && onReady) onReady(*this);
 }
 
 Life::~Life()
@@ -27,25 +105,90 @@ Life::~Life()
 
 void Life::requestAdapter()
 {
+    // The browser ignores the instance, wgpu-native needs a real one
+    if (!instance) instance = wgpu::createInstance();
+    if (!instance) throw Life::InitializationError("Failed to create instance");
+
     wgpu::RequestAdapterOptions adapterOptions {};
     adapterOptions.setDefault();
-    adapter = instance.requestAdapter(adapterOptions);
-    if (!adapter) throw Life::InitializationError("Failed to request adapter");
+    adapterOptions.forceFallbackAdapter = headless && headless->softwareAdapter;
+    adapterRequest = instance.requestAdapter(adapterOptions,
+        [this](wgpu::RequestAdapterStatus status, wgpu::Adapter result, const char* message) {
+            if (status != wgpu::RequestAdapterStatus::Success || !result) {
+                failStartup(std::string("Failed to request adapter: ") + (message ? message : "no adapter"));
+                return;
+            }
+            adapter = result;
+            markStartup(StartupMilestone::Adapter);
+            requestDevice();
+        });
 }
 
 void Life::requestDevice()
 {
+    // Timestamp queries are optional, only request them when the adapter exposes them
+    timestampQuerySupported = adapter.hasFeature(wgpu::FeatureName::TimestampQuery);
+    const WGPUFeatureName timestampFeature = WGPUFeatureName_TimestampQuery;
+
     wgpu::DeviceDescriptor deviceDesc {};
     deviceDesc.setDefault();
-    device = adapter.requestDevice(deviceDesc);
-    if (!device) throw Life::InitializationError("Failed to request device");
-    queue = device.getQueue();
-    if (!queue) throw Life::InitializationError("Failed to get queue");
+    if (timestampQuerySupported) {
+        deviceDesc.requiredFeatureCount = 1;
+        deviceDesc.requiredFeatures = &timestampFeature;
+    }
+    deviceRequest = adapter.requestDevice(deviceDesc,
+        [this](wgpu::RequestDeviceStatus status, wgpu::Device result, const char* message) {
+            if (status != wgpu::RequestDeviceStatus::Success || !result) {
+                failStartup(std::string("Failed to request device: ") + (message ? message : "no device"));
+                return;
+            }
+            device = result;
+            queue = device.getQueue();
+            if (!queue) {
+                failStartup("Failed to get queue");
+                return;
+            }
+            markStartup(StartupMilestone::Device);
+            try {
+                createResources();
+            } catch (const std::exception& e) {
+                failStartup(e.what());
+                return;
+            }
+            markStartup(StartupMilestone::Resources);
+            ready = true;
+            if (onReady) onReady(*this);
+        });
+}
+
+void Life::createGpuTimer()
+{
+    gpuTimer = std::make_unique<GpuTimer>(device, queue, timestampQuerySupported);
+}
+
+void Life::createPeriodMonitor()
+{
+    periodMonitor = std::make_unique<PeriodMonitor>(device);
+    if (!periodMonitor->getSummaryBuffer()) throw Life::InitializationError("Failed to create board summary buffer");
+}
 
+void Life::createCellEditor()
+{
+    cellEditor = std::make_unique<CellEditor>(device, queue, GRID_SIZE, GRID_SIZE);
+    if (!cellEditor->getEditBuffer()) throw Life::InitializationError("Failed to create cell edit buffer");
+}
+
+void Life::createHistoryRecorder()
+{
+    historyRecorder = std::make_unique<HistoryRecorder>(device, queue, GRID_SIZE, GRID_SIZE);
+    if (!historyRecorder->getPackedBuffer()) throw Life::InitializationError("Failed to create packed board buffer");
 }
 
 void Life::createSurface()
 {
+#ifndef __EMSCRIPTEN__
+    throw Life::InitializationError("Native builds have no canvas, construct Life with Life::Headless");
+#else
     wgpu::SurfaceDescriptorFromCanvasHTMLSelector surfaceSelector {};
     surfaceSelector.setDefault();
     surfaceSelector.selector = "#canvas";
@@ -56,10 +199,12 @@ void Life::createSurface()
     surface = instance.createSurface(surfaceDesc);
 
     if (!surface) throw Life::InitializationError("Failed to create surface");    
+#endif
 }
 
 void Life::configureSurface()
 {
+#ifdef __EMSCRIPTEN__
     surfaceConfig.setDefault();
     surfaceConfig.device = device;
     surfaceConfig.format = getSurface().getPreferredFormat(adapter);
@@ -69,11 +214,35 @@ void Life::configureSurface()
     surfaceConfig.width = width;
     surfaceConfig.height = height;
     surface.configure(surfaceConfig);
+#endif
+}
+
+void Life::createOffscreenTarget()
+{
+    // surfaceConfig only describes the target here (format and size), no surface is ever configured with it
+    surfaceConfig.setDefault();
+    surfaceConfig.device = device;
+    surfaceConfig.format = OFFSCREEN_FORMAT;
+    surfaceConfig.usage = wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::CopySrc;
+    surfaceConfig.width = headless->width;
+    surfaceConfig.height = headless->height;
+
+    wgpu::TextureDescriptor textureDesc {};
+    textureDesc.setDefault();
+    textureDesc.label = "Offscreen target";
+    textureDesc.dimension = wgpu::TextureDimension::_2D;
+    textureDesc.size = wgpu::Extent3D(surfaceConfig.width, surfaceConfig.height, 1);
+    textureDesc.format = surfaceConfig.format;
+    textureDesc.usage = surfaceConfig.usage;
+    textureDesc.mipLevelCount = 1;
+    textureDesc.sampleCount = 1;
+    offscreenTexture = device.createTexture(textureDesc);
+    if (!offscreenTexture) throw Life::InitializationError("Failed to create offscreen target");
 }
 
 void Life::createBindGroupLayout()
 {
-    std::array<wgpu::BindGroupLayoutEntry, 3> entries;
+    std::array<wgpu::BindGroupLayoutEntry, 11> entries;
 
     // Binding 0: Grid uniform buffer
     wgpu::BindGroupLayoutEntry uniformBindGroupLayoutEntry {};
@@ -94,7 +263,7 @@ void Life::createBindGroupLayout()
                                                    wgpu::ShaderStage::Fragment | 
                                                    wgpu::ShaderStage::Compute;
     inputStorageBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
-    inputStorageBindGroupLayoutEntry.buffer.minBindingSize = cellStateArray.size() * sizeof(uint32_t);
+    inputStorageBindGroupLayoutEntry.buffer.minBindingSize = STATE_BUFFER_SIZE;
     entries[1] = inputStorageBindGroupLayoutEntry;
 
     // Binding 2: Cell state OUTPUT buffer (read-write storage)
@@ -103,13 +272,86 @@ void Life::createBindGroupLayout()
     outputStorageBindGroupLayoutEntry.binding = 2;
     outputStorageBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Compute;
     outputStorageBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::Storage;
-    outputStorageBindGroupLayoutEntry.buffer.minBindingSize = cellStateArray.size() * sizeof(uint32_t);
+    outputStorageBindGroupLayoutEntry.buffer.minBindingSize = STATE_BUFFER_SIZE;
     entries[2] = outputStorageBindGroupLayoutEntry;
 
+    // Binding 3: Seed parameters uniform buffer (only read by seedMain)
+    wgpu::BindGroupLayoutEntry seedBindGroupLayoutEntry {};
+    seedBindGroupLayoutEntry.setDefault();
+    seedBindGroupLayoutEntry.binding = 3;
+    seedBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Compute;
+    seedBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::Uniform;
+    seedBindGroupLayoutEntry.buffer.minBindingSize = sizeof(SeedParams);
+    entries[3] = seedBindGroupLayoutEntry;
+
+    // Binding 4: Board summary (hash written by hashMain, changed cells counted by computeMain, read back by PeriodMonitor)
+    wgpu::BindGroupLayoutEntry summaryBindGroupLayoutEntry {};
+    summaryBindGroupLayoutEntry.setDefault();
+    summaryBindGroupLayoutEntry.binding = 4;
+    summaryBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Compute;
+    summaryBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::Storage;
+    summaryBindGroupLayoutEntry.buffer.minBindingSize = PeriodMonitor::getSummarySize();
+    entries[4] = summaryBindGroupLayoutEntry;
+
+    // Binding 5: Pointer edits (written by CellEditor, applied by editMain)
+    wgpu::BindGroupLayoutEntry editBindGroupLayoutEntry {};
+    editBindGroupLayoutEntry.setDefault();
+    editBindGroupLayoutEntry.binding = 5;
+    editBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Compute;
+    editBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+    editBindGroupLayoutEntry.buffer.minBindingSize = CellEditor::EDIT_BUFFER_SIZE;
+    entries[5] = editBindGroupLayoutEntry;
+
+    // Binding 6: Bit-packed board (written by packMain for HistoryRecorder, read by unpackMain when seeking)
+    wgpu::BindGroupLayoutEntry packedBindGroupLayoutEntry {};
+    packedBindGroupLayoutEntry.setDefault();
+    packedBindGroupLayoutEntry.binding = 6;
+    packedBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Compute;
+    packedBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::Storage;
+    packedBindGroupLayoutEntry.buffer.minBindingSize = historyRecorder->getPackedSize();
+    entries[6] = packedBindGroupLayoutEntry;
+
+    // Binding 7: Summed-area table of the Larger than Life passes (scratch, only touched by ltl*Main)
+    wgpu::BindGroupLayoutEntry ltlTableBindGroupLayoutEntry {};
+    ltlTableBindGroupLayoutEntry.setDefault();
+    ltlTableBindGroupLayoutEntry.binding = 7;
+    ltlTableBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Compute;
+    ltlTableBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::Storage;
+    ltlTableBindGroupLayoutEntry.buffer.minBindingSize = LTL_TABLE_SIZE;
+    entries[7] = ltlTableBindGroupLayoutEntry;
+
+    // Binding 8: Lenia kernel weights (written by uploadLeniaKernel, read by leniaMain)
+    wgpu::BindGroupLayoutEntry leniaKernelBindGroupLayoutEntry {};
+    leniaKernelBindGroupLayoutEntry.setDefault();
+    leniaKernelBindGroupLayoutEntry.binding = 8;
+    leniaKernelBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Compute;
+    leniaKernelBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+    leniaKernelBindGroupLayoutEntry.buffer.minBindingSize = LENIA_KERNEL_SIZE;
+    entries[8] = leniaKernelBindGroupLayoutEntry;
+
+    // Binding 9: Occupancy mip of the volume (written by voxelMain and voxelMipMain, read by voxelFragmentMain).
+    // The volume itself lives in the cell buffers, which keeps the compute stage at 8 storage buffers
+    wgpu::BindGroupLayoutEntry voxelOccupancyBindGroupLayoutEntry {};
+    voxelOccupancyBindGroupLayoutEntry.setDefault();
+    voxelOccupancyBindGroupLayoutEntry.binding = 9;
+    voxelOccupancyBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Fragment | wgpu::ShaderStage::Compute;
+    voxelOccupancyBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::Storage;
+    voxelOccupancyBindGroupLayoutEntry.buffer.minBindingSize = VOXEL_OCCUPANCY_SIZE;
+    entries[9] = voxelOccupancyBindGroupLayoutEntry;
+
+    // Binding 10: Voxel camera uniform buffer (written by writeVoxelCamera, read by voxelFragmentMain)
+    wgpu::BindGroupLayoutEntry voxelCameraBindGroupLayoutEntry {};
+    voxelCameraBindGroupLayoutEntry.setDefault();
+    voxelCameraBindGroupLayoutEntry.binding = 10;
+    voxelCameraBindGroupLayoutEntry.visibility = wgpu::ShaderStage::Fragment;
+    voxelCameraBindGroupLayoutEntry.buffer.type = wgpu::BufferBindingType::Uniform;
+    voxelCameraBindGroupLayoutEntry.buffer.minBindingSize = sizeof(VoxelCamera);
+    entries[10] = voxelCameraBindGroupLayoutEntry;
+
     wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc {};
     bindGroupLayoutDesc.setDefault();
     bindGroupLayoutDesc.label = "Cell bind group layout";
-    bindGroupLayoutDesc.entryCount = 3;
+    bindGroupLayoutDesc.entryCount = entries.size();
     bindGroupLayoutDesc.entries = entries.data();
 
     bindGroupLayout = getDevice().createBindGroupLayout(bindGroupLayoutDesc);
@@ -118,85 +360,228 @@ void Life::createBindGroupLayout()
 
 void Life::createPipelines()
 {
-    wgpu::ShaderModule cellShaderModule = Shader::loadModuleFromFile(
-        getDevice(),
-        "/shaders/shader.wgsl"
-    );
-
-    wgpu::PipelineLayoutDescriptor layoutDesc {};
-    layoutDesc.setDefault();
-    layoutDesc.bindGroupLayoutCount = 1;
-    layoutDesc.bindGroupLayouts = reinterpret_cast<const WGPUBindGroupLayout*>(&getBindGroupLayout());
-    wgpu::PipelineLayout pipelineLayout = getDevice().createPipelineLayout(layoutDesc);
-
-    // Vertex setup
-    wgpu::VertexAttribute vertexAttribute {};
-    vertexAttribute.setDefault();
-    vertexAttribute.format = wgpu::VertexFormat::Float32x2;
-    vertexAttribute.offset = 0;
-    vertexAttribute.shaderLocation = 0;
-
-    wgpu::VertexBufferLayout vertexBufferLayout {};
-    vertexBufferLayout.setDefault();
-    vertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
-    vertexBufferLayout.arrayStride = 8;
-    vertexBufferLayout.attributeCount = 1;
-    vertexBufferLayout.attributes = &vertexAttribute;
-
-    // Pipeline descriptor
-    wgpu::RenderPipelineDescriptor pipelineDesc {};
-    pipelineDesc.setDefault();
-    pipelineDesc.label = "Cell pipeline";
-    pipelineDesc.layout = pipelineLayout;
-
-    pipelineDesc.vertex.module = cellShaderModule;
-    pipelineDesc.vertex.entryPoint = "vertexMain";
-    pipelineDesc.vertex.bufferCount = 1;
-    pipelineDesc.vertex.buffers = &vertexBufferLayout;
-
-    wgpu::ColorTargetState colorTarget {};
-    colorTarget.setDefault();
-    colorTarget.format = surfaceConfig.format;
-    colorTarget.writeMask = wgpu::ColorWriteMask::All;
-
-    wgpu::FragmentState fragmentState {};
-    fragmentState.setDefault();
-    fragmentState.module = cellShaderModule;
-    fragmentState.entryPoint = "fragmentMain";
-    fragmentState.targetCount = 1;
-    fragmentState.targets = &colorTarget;
-
-    pipelineDesc.fragment = &fragmentState;
-
-    renderPipeline = getDevice().createRenderPipeline(pipelineDesc);
-
-    // Create compute pipeline
-    wgpu::PipelineLayoutDescriptor computeLayoutDesc {};
-    computeLayoutDesc.setDefault();
-    computeLayoutDesc.bindGroupLayoutCount = 1;
-    computeLayoutDesc.bindGroupLayouts = reinterpret_cast<const WGPUBindGroupLayout*>(&getBindGroupLayout());
-    wgpu::PipelineLayout computePipelineLayout = getDevice().createPipelineLayout(computeLayoutDesc);
-
-    // Define the override constant
-    wgpu::ConstantEntry constantEntry {};
-    constantEntry.key = "WORKGROUP_SIZE";
-    constantEntry.value = static_cast<double>(WORKGROUP_SIZE);
-
-    wgpu::ComputePipelineDescriptor computePipelineDesc {};
-    computePipelineDesc.setDefault();
-    computePipelineDesc.label = "Simulation pipeline";
-    computePipelineDesc.layout = computePipelineLayout;
-    computePipelineDesc.compute.module = cellShaderModule;
-    computePipelineDesc.compute.entryPoint = "computeMain";
-    computePipelineDesc.compute.constantCount = 1;
-    computePipelineDesc.compute.constants = &constantEntry;
-
-    simulationPipeline = getDevice().createComputePipeline(computePipelineDesc);
-    if (!simulationPipeline) throw Life::InitializationError("Failed to create compute pipeline");
-
-    // Clean up temporary resources
-    computePipelineLayout.release();
-    cellShaderModule.release();
+    TRACE_SCOPE("Life::createPipelines");
+    pipelineCache = std::make_unique<PipelineCache>(getDevice(), getBindGroupLayout(), EmbeddedShaders::SHADER_WGSL);
+
+    // Everything requested here compiles in parallel
+    const PipelineCache::Constants workgroupConstants {{"WORKGROUP_SIZE", static_cast<double>(WORKGROUP_SIZE)}};
+    requestRenderPipeline();
+    simulationPipelineKey = pipelineCache->requestCompute("computeMain", workgroupConstants);
+    seedPipelineKey = pipelineCache->requestCompute("seedMain", workgroupConstants);
+    hashPipelineKey = pipelineCache->requestCompute("hashMain", workgroupConstants);
+    packPipelineKey = pipelineCache->requestCompute("packMain", workgroupConstants);
+    requestHaloPipeline();
+    if (!rule.isConway()) requestLtlPipelines();
+    if (leniaRule) requestLeniaPipeline();
+    if (latticeRule) requestLatticePipeline();
+    if (voxelRule) requestVoxelPipelines();
+    // Editing and seeking are not needed for the first frame, they finish compiling behind it
+    PipelineCache::Constants editConstants = getStateConstants();
+    editConstants.insert(workgroupConstants.begin(), workgroupConstants.end());
+    editPipelineKey = pipelineCache->requestCompute("editMain", editConstants);
+    unpackPipelineKey = pipelineCache->requestCompute("unpackMain", workgroupConstants);
+}
+
+void Life::requestHaloPipeline()
+{
+    // The topology is baked in, so haloMain compiles down to the one gluing in use
+    haloPipelineKey = pipelineCache->requestCompute("haloMain", {
+        {"WORKGROUP_SIZE", static_cast<double>(WORKGROUP_SIZE)},
+        {"TOPOLOGY", static_cast<double>(static_cast<uint32_t>(topology))},
+    });
+}
+
+void Life::requestLtlPipelines()
+{
+    // Each rule (and topology) is its own set of variants, rules used before switch at once
+    PipelineCache::Constants constants {
+        {"WORKGROUP_SIZE", static_cast<double>(WORKGROUP_SIZE)},
+        {"TOPOLOGY", static_cast<double>(static_cast<uint32_t>(topology))},
+        {"LTL_RADIUS", static_cast<double>(rule.radius)},
+    };
+    ltlRowsPipelineKey = pipelineCache->requestCompute("ltlRowsMain", constants);
+    ltlColumnsPipelineKey = pipelineCache->requestCompute("ltlColumnsMain", constants);
+    constants.erase("TOPOLOGY");
+    constants["LTL_INCLUDE_CENTER"] = rule.includeCenter ? 1.0 : 0.0;
+    constants["LTL_BIRTH_MIN"] = rule.birthMin;
+    constants["LTL_BIRTH_MAX"] = rule.birthMax;
+    constants["LTL_SURVIVE_MIN"] = rule.surviveMin;
+    constants["LTL_SURVIVE_MAX"] = rule.surviveMax;
+    ltlPipelineKey = pipelineCache->requestCompute("ltlMain", constants);
+}
+
+bool Life::isLtlReady() const
+{
+    return pipelineCache->isReady(ltlRowsPipelineKey) && pipelineCache->isReady(ltlColumnsPipelineKey) &&
+           pipelineCache->isReady(ltlPipelineKey);
+}
+
+void Life::dispatchLtl(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup)
+{
+    constexpr uint32_t LINE_WORKGROUP_SIZE = WORKGROUP_SIZE * WORKGROUP_SIZE;
+    const uint32_t tableWidth = GRID_SIZE + 2 * rule.radius + 1;
+    pass.setBindGroup(0, bindGroup, 0, nullptr);
+    pass.setPipeline(pipelineCache->getCompute(ltlRowsPipelineKey));
+    pass.dispatchWorkgroups((tableWidth - 1 + LINE_WORKGROUP_SIZE - 1) / LINE_WORKGROUP_SIZE, 1, 1);
+    pass.setPipeline(pipelineCache->getCompute(ltlColumnsPipelineKey));
+    pass.dispatchWorkgroups((tableWidth + LINE_WORKGROUP_SIZE - 1) / LINE_WORKGROUP_SIZE, 1, 1);
+    pass.setPipeline(pipelineCache->getCompute(ltlPipelineKey));
+    const uint32_t workgroupCount = (GRID_SIZE + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    pass.dispatchWorkgroups(workgroupCount, workgroupCount, 1);
+}
+
+PipelineCache::Constants Life::getStateConstants() const
+{
+    return {{"CONTINUOUS", leniaRule ? 1.0 : 0.0}};
+}
+
+PipelineCache::Constants Life::getRenderConstants() const
+{
+    PipelineCache::Constants constants = getStateConstants();
+    constants["LATTICE"] = latticeRule ? static_cast<double>(static_cast<uint32_t>(latticeRule->kind)) : 0.0;
+    return constants;
+}
+
+void Life::requestLatticePipeline()
+{
+    // Only triangleMain reads past the halo and needs the topology
+    PipelineCache::Constants constants {
+        {"WORKGROUP_SIZE", static_cast<double>(WORKGROUP_SIZE)},
+        {"LATTICE_BIRTH", static_cast<double>(latticeRule->birth)},
+        {"LATTICE_SURVIVE", static_cast<double>(latticeRule->survive)},
+    };
+    if (latticeRule->kind == LatticeRule::Kind::Hex) {
+        latticePipelineKey = pipelineCache->requestCompute("hexMain", constants);
+    } else {
+        constants["TOPOLOGY"] = static_cast<double>(static_cast<uint32_t>(topology));
+        latticePipelineKey = pipelineCache->requestCompute("triangleMain", constants);
+    }
+}
+
+std::pair<uint32_t, uint32_t> Life::getLatticeVertices() const
+{
+    if (!latticeRule) return {0, SQUARE_VERTEX_COUNT};
+    if (latticeRule->kind == LatticeRule::Kind::Hex) return {SQUARE_VERTEX_COUNT, HEX_VERTEX_COUNT};
+    return {SQUARE_VERTEX_COUNT + HEX_VERTEX_COUNT, TRIANGLE_VERTEX_COUNT};
+}
+
+void Life::requestRenderPipeline()
+{
+    // The raymarcher has nothing to specialize, the cells' variants the state kind and the lattice
+    if (voxelRule) {
+        renderPipelineKey = pipelineCache->requestRender("voxelVertexMain", "voxelFragmentMain", surfaceConfig.format);
+    } else {
+        renderPipelineKey = pipelineCache->requestRender("vertexMain", "fragmentMain", surfaceConfig.format,
+                                                         getRenderConstants());
+    }
+}
+
+void Life::requestVoxelPipelines()
+{
+    // The rule is baked in as neighbour count masks like the lattices', each mip level reads the one below it
+    voxelPipelineKey = pipelineCache->requestCompute("voxelMain", {
+        {"VOXEL_SURVIVE", static_cast<double>(voxelRule->getSurviveMask())},
+        {"VOXEL_BIRTH", static_cast<double>(voxelRule->getBirthMask())},
+    });
+    voxelMipPipelineKeys.clear();
+    for (uint32_t level = 2; level <= VOXEL_MIP_LEVELS; level++) {
+        voxelMipPipelineKeys.push_back(
+            pipelineCache->requestCompute("voxelMipMain", {{"VOXEL_MIP_LEVEL", static_cast<double>(level)}}));
+    }
+    voxelHashPipelineKey = pipelineCache->requestCompute("voxelHashMain");
+}
+
+bool Life::isVoxelReady() const
+{
+    const bool mipsReady = std::all_of(voxelMipPipelineKeys.begin(), voxelMipPipelineKeys.end(),
+                                       [this](const std::string& key) { return pipelineCache->isReady(key); });
+    return mipsReady && pipelineCache->isReady(voxelPipelineKey) && pipelineCache->isReady(voxelHashPipelineKey);
+}
+
+void Life::dispatchVoxel(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup)
+{
+    // voxelMain flags the bricks it leaves live (mip level 1), every level above is built from the one below
+    constexpr uint32_t BRICK_WORKGROUPS = VOXEL_BRICKS / VOXEL_WORKGROUP_SIZE;
+    pass.setBindGroup(0, bindGroup, 0, nullptr);
+    pass.setPipeline(pipelineCache->getCompute(voxelPipelineKey));
+    pass.dispatchWorkgroups(BRICK_WORKGROUPS, BRICK_WORKGROUPS, BRICK_WORKGROUPS);
+    for (uint32_t level = 2; level <= VOXEL_MIP_LEVELS; level++) {
+        const uint32_t side = VOXEL_BRICKS >> (level - 1);
+        const uint32_t workgroups = (side + VOXEL_WORKGROUP_SIZE - 1) / VOXEL_WORKGROUP_SIZE;
+        pass.setPipeline(pipelineCache->getCompute(voxelMipPipelineKeys[level - 2]));
+        pass.dispatchWorkgroups(workgroups, workgroups, workgroups);
+    }
+}
+
+void Life::writeVoxelCamera()
+{
+    voxelCameraDirty = false;
+    // Orbit around the middle of the volume with z up, 45 degrees (FIELD_OF_VIEW) of vertical field of view
+    const float half = static_cast<float>(VOXEL_SIZE) / 2;
+    const float distance = voxelDistance * static_cast<float>(VOXEL_SIZE);
+    const float forward[3] = {
+        -std::cos(voxelPitch) * std::cos(voxelYaw),
+        -std::cos(voxelPitch) * std::sin(voxelYaw),
+        -std::sin(voxelPitch),
+    };
+    // right = forward x z, up = right x forward (forward is never parallel to z, setVoxelView clamps the pitch)
+    const float rightLength = std::hypot(forward[0], forward[1]);
+    const float right[3] = {forward[1] / rightLength, -forward[0] / rightLength, 0.0f};
+    const float up[3] = {
+        right[1] * forward[2] - right[2] * forward[1],
+        right[2] * forward[0] - right[0] * forward[2],
+        right[0] * forward[1] - right[1] * forward[0],
+    };
+    constexpr float FIELD_OF_VIEW = 0.785398f;
+    const float tanHalfFov = std::tan(FIELD_OF_VIEW / 2);
+    const float aspect = surfaceConfig.height > 0
+        ? static_cast<float>(surfaceConfig.width) / static_cast<float>(surfaceConfig.height)
+        : 1.0f;
+    VoxelCamera camera {};
+    for (int i = 0; i < 3; i++) {
+        camera.eye[i] = half - forward[i] * distance;
+        camera.right[i] = right[i] * tanHalfFov * aspect;
+        camera.up[i] = up[i] * tanHalfFov;
+        camera.forward[i] = forward[i];
+    }
+    getQueue().writeBuffer(voxelCameraBuffer, 0, &camera, sizeof(camera));
+}
+
+void Life::requestLeniaPipeline()
+{
+    // The kernel weights live in leniaKernelBuffer, only the radius and growth function are baked in
+    leniaPipelineKey = pipelineCache->requestCompute("leniaMain", {
+        {"TOPOLOGY", static_cast<double>(static_cast<uint32_t>(topology))},
+        {"LENIA_RADIUS", static_cast<double>(leniaRule->radius)},
+        {"LENIA_MU", leniaRule->mu},
+        {"LENIA_SIGMA", leniaRule->sigma},
+        {"LENIA_TICKS", static_cast<double>(leniaRule->ticks)},
+    });
+}
+
+void Life::dispatchLenia(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup)
+{
+    pass.setPipeline(pipelineCache->getCompute(leniaPipelineKey));
+    pass.setBindGroup(0, bindGroup, 0, nullptr);
+    pass.dispatchWorkgroups(GRID_SIZE / LENIA_TILE, GRID_SIZE / LENIA_TILE, 1);
+}
+
+void Life::uploadLeniaKernel()
+{
+    const std::vector<float> weights = leniaRule->kernel();
+    getQueue().writeBuffer(leniaKernelBuffer, 0, weights.data(), weights.size() * sizeof(float));
+}
+
+void Life::dispatchHalo(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup)
+{
+    // Dispatches in one pass see each other's writes, so this can directly follow the pass that wrote the board.
+    // While a new topology's variant compiles there is nothing to dispatch, refillHalo catches up afterwards.
+    // Volumes wrap in voxelMain and have no halo, the cells past the board are their bricks
+    if (haloRefillPending || voxelRule) return;
+    constexpr uint32_t HALO_WORKGROUP_SIZE = WORKGROUP_SIZE * WORKGROUP_SIZE;
+    pass.setPipeline(pipelineCache->getCompute(haloPipelineKey));
+    pass.setBindGroup(0, bindGroup, 0, nullptr);
+    pass.dispatchWorkgroups((HALO_CELL_COUNT + HALO_WORKGROUP_SIZE - 1) / HALO_WORKGROUP_SIZE, 1, 1);
 }
 
 void Life::createVertexBuffer()
@@ -225,20 +610,23 @@ void Life::createUniformBuffer()
 
     constexpr uint64_t BUFFER_OFFSET = 0;
     getQueue().writeBuffer(uniformBuffer, BUFFER_OFFSET, GRID_DIMENSIONS, sizeof(GRID_DIMENSIONS));
+
+    // Written before the first voxel draw, see writeVoxelCamera
+    wgpu::BufferDescriptor cameraDesc {};
+    cameraDesc.setDefault();
+    cameraDesc.label = "Voxel camera";
+    cameraDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+    cameraDesc.size = sizeof(VoxelCamera);
+    voxelCameraBuffer = getDevice().createBuffer(cameraDesc);
+    if (!voxelCameraBuffer) throw Life::InitializationError("Failed to create voxel camera buffer");
 }
 
 void Life::createStorageBuffers()
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 1);
-    for (auto& cell : cellStateArray) {
-        cell = dis(gen);
-    }
-    
+    // Contents come from the seed compute pass (see Life::seed), nothing is uploaded from the host
     wgpu::BufferDescriptor bufferDesc {};
     bufferDesc.label = "Cell State Storage";
-    bufferDesc.size = cellStateArray.size() * sizeof(uint32_t);
+    bufferDesc.size = STATE_BUFFER_SIZE;
     bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst; 
     
     // Create read buffer
@@ -248,19 +636,52 @@ void Life::createStorageBuffers()
     // Create write buffer
     cellBuffers.write = device.createBuffer(bufferDesc);
     if (!cellBuffers.write) throw Life::InitializationError("Failed to create write storage buffer");
-    
-    // Initialize both buffers with the same data
-    constexpr uint64_t BUFFER_OFFSET = 0;
-    queue.writeBuffer(cellBuffers.read, BUFFER_OFFSET, cellStateArray.data(), 
-                     cellStateArray.size() * sizeof(uint32_t));
-    queue.writeBuffer(cellBuffers.write, BUFFER_OFFSET, cellStateArray.data(), 
-                     cellStateArray.size() * sizeof(uint32_t));
+
+    // Rebuilt by every Larger than Life step, sized for the largest radius so rules switch without new bind groups
+    wgpu::BufferDescriptor ltlTableDesc {};
+    ltlTableDesc.setDefault();
+    ltlTableDesc.label = "Larger than Life table";
+    ltlTableDesc.size = LTL_TABLE_SIZE;
+    ltlTableDesc.usage = wgpu::BufferUsage::Storage;
+    ltlTableBuffer = device.createBuffer(ltlTableDesc);
+    if (!ltlTableBuffer) throw Life::InitializationError("Failed to create Larger than Life table buffer");
+
+    // Rewritten per Lenia rule, sized for the largest radius like the table
+    wgpu::BufferDescriptor leniaKernelDesc {};
+    leniaKernelDesc.setDefault();
+    leniaKernelDesc.label = "Lenia kernel";
+    leniaKernelDesc.size = LENIA_KERNEL_SIZE;
+    leniaKernelDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+    leniaKernelBuffer = device.createBuffer(leniaKernelDesc);
+    if (!leniaKernelBuffer) throw Life::InitializationError("Failed to create Lenia kernel buffer");
+    if (leniaRule) uploadLeniaKernel();
+
+    // Rebuilt by every 3D step, or uploaded with a soup
+    wgpu::BufferDescriptor voxelOccupancyDesc {};
+    voxelOccupancyDesc.setDefault();
+    voxelOccupancyDesc.label = "Voxel occupancy";
+    voxelOccupancyDesc.size = VOXEL_OCCUPANCY_SIZE;
+    voxelOccupancyDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+    voxelOccupancyBuffer = device.createBuffer(voxelOccupancyDesc);
+    if (!voxelOccupancyBuffer) throw Life::InitializationError("Failed to create voxel occupancy buffer");
+}
+
+void Life::createSeedBuffer()
+{
+    wgpu::BufferDescriptor bufferDesc {};
+    bufferDesc.setDefault();
+    bufferDesc.label = "Seed parameters";
+    bufferDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+    bufferDesc.size = sizeof(SeedParams);
+
+    seedBuffer = getDevice().createBuffer(bufferDesc);
+    if (!seedBuffer) throw Life::InitializationError("Failed to create seed buffer");
 }
 
 void Life::createBindGroup()
 {
     // Create bind group A (reads from cellBuffers.read, writes to cellBuffers.write)
-    std::array<wgpu::BindGroupEntry, 3> readEntries;
+    std::array<wgpu::BindGroupEntry, 11> readEntries;
 
     readEntries[0].setDefault();
     readEntries[0].binding = 0;
@@ -272,14 +693,62 @@ void Life::createBindGroup()
     readEntries[1].binding = 1;
     readEntries[1].buffer = cellBuffers.read;  // INPUT buffer
     readEntries[1].offset = 0;
-    readEntries[1].size = cellStateArray.size() * sizeof(uint32_t);
+    readEntries[1].size = STATE_BUFFER_SIZE;
 
     // Binding 2 - OUTPUT buffer
     readEntries[2].setDefault();
     readEntries[2].binding = 2;
     readEntries[2].buffer = cellBuffers.write;  // OUTPUT buffer
     readEntries[2].offset = 0;
-    readEntries[2].size = cellStateArray.size() * sizeof(uint32_t);
+    readEntries[2].size = STATE_BUFFER_SIZE;
+
+    readEntries[3].setDefault();
+    readEntries[3].binding = 3;
+    readEntries[3].buffer = seedBuffer;
+    readEntries[3].offset = 0;
+    readEntries[3].size = sizeof(SeedParams);
+
+    readEntries[4].setDefault();
+    readEntries[4].binding = 4;
+    readEntries[4].buffer = periodMonitor->getSummaryBuffer();
+    readEntries[4].offset = 0;
+    readEntries[4].size = PeriodMonitor::getSummarySize();
+
+    readEntries[5].setDefault();
+    readEntries[5].binding = 5;
+    readEntries[5].buffer = cellEditor->getEditBuffer();
+    readEntries[5].offset = 0;
+    readEntries[5].size = CellEditor::EDIT_BUFFER_SIZE;
+
+    readEntries[6].setDefault();
+    readEntries[6].binding = 6;
+    readEntries[6].buffer = historyRecorder->getPackedBuffer();
+    readEntries[6].offset = 0;
+    readEntries[6].size = historyRecorder->getPackedSize();
+
+    readEntries[7].setDefault();
+    readEntries[7].binding = 7;
+    readEntries[7].buffer = ltlTableBuffer;
+    readEntries[7].offset = 0;
+    readEntries[7].size = LTL_TABLE_SIZE;
+
+    readEntries[8].setDefault();
+    readEntries[8].binding = 8;
+    readEntries[8].buffer = leniaKernelBuffer;
+    readEntries[8].offset = 0;
+    readEntries[8].size = LENIA_KERNEL_SIZE;
+
+    readEntries[9].setDefault();
+    readEntries[9].binding = 9;
+    readEntries[9].buffer = voxelOccupancyBuffer;
+    readEntries[9].offset = 0;
+    readEntries[9].size = VOXEL_OCCUPANCY_SIZE;
+
+    readEntries[10].setDefault();
+    readEntries[10].binding = 10;
+    readEntries[10].buffer = voxelCameraBuffer;
+    readEntries[10].offset = 0;
+    readEntries[10].size = sizeof(VoxelCamera);
 
     wgpu::BindGroupDescriptor readBindGroupDesc {};
     readBindGroupDesc.setDefault();
@@ -292,7 +761,7 @@ void Life::createBindGroup()
     if (!cellBuffers.readBindGroup) throw Life::InitializationError("Failed to create read bindGroup");
 
     // Create bind group B (reads from cellBuffers.write, writes to cellBuffers.read)
-    std::array<wgpu::BindGroupEntry, 3> writeEntries;
+    std::array<wgpu::BindGroupEntry, 11> writeEntries;
 
     writeEntries[0].setDefault();
     writeEntries[0].binding = 0;
@@ -304,13 +773,61 @@ void Life::createBindGroup()
     writeEntries[1].binding = 1;
     writeEntries[1].buffer = cellBuffers.write;
     writeEntries[1].offset = 0;
-    writeEntries[1].size = cellStateArray.size() * sizeof(uint32_t);
+    writeEntries[1].size = STATE_BUFFER_SIZE;
 
     writeEntries[2].setDefault();
     writeEntries[2].binding = 2;
     writeEntries[2].buffer = cellBuffers.read;
     writeEntries[2].offset = 0;
-    writeEntries[2].size = cellStateArray.size() * sizeof(uint32_t);
+    writeEntries[2].size = STATE_BUFFER_SIZE;
+
+    writeEntries[3].setDefault();
+    writeEntries[3].binding = 3;
+    writeEntries[3].buffer = seedBuffer;
+    writeEntries[3].offset = 0;
+    writeEntries[3].size = sizeof(SeedParams);
+
+    writeEntries[4].setDefault();
+    writeEntries[4].binding = 4;
+    writeEntries[4].buffer = periodMonitor->getSummaryBuffer();
+    writeEntries[4].offset = 0;
+    writeEntries[4].size = PeriodMonitor::getSummarySize();
+
+    writeEntries[5].setDefault();
+    writeEntries[5].binding = 5;
+    writeEntries[5].buffer = cellEditor->getEditBuffer();
+    writeEntries[5].offset = 0;
+    writeEntries[5].size = CellEditor::EDIT_BUFFER_SIZE;
+
+    writeEntries[6].setDefault();
+    writeEntries[6].binding = 6;
+    writeEntries[6].buffer = historyRecorder->getPackedBuffer();
+    writeEntries[6].offset = 0;
+    writeEntries[6].size = historyRecorder->getPackedSize();
+
+    writeEntries[7].setDefault();
+    writeEntries[7].binding = 7;
+    writeEntries[7].buffer = ltlTableBuffer;
+    writeEntries[7].offset = 0;
+    writeEntries[7].size = LTL_TABLE_SIZE;
+
+    writeEntries[8].setDefault();
+    writeEntries[8].binding = 8;
+    writeEntries[8].buffer = leniaKernelBuffer;
+    writeEntries[8].offset = 0;
+    writeEntries[8].size = LENIA_KERNEL_SIZE;
+
+    writeEntries[9].setDefault();
+    writeEntries[9].binding = 9;
+    writeEntries[9].buffer = voxelOccupancyBuffer;
+    writeEntries[9].offset = 0;
+    writeEntries[9].size = VOXEL_OCCUPANCY_SIZE;
+
+    writeEntries[10].setDefault();
+    writeEntries[10].binding = 10;
+    writeEntries[10].buffer = voxelCameraBuffer;
+    writeEntries[10].offset = 0;
+    writeEntries[10].size = sizeof(VoxelCamera);
 
     wgpu::BindGroupDescriptor writeBindGroupDesc {};
     writeBindGroupDesc.setDefault();
@@ -325,17 +842,29 @@ void Life::createBindGroup()
 
 void Life::cleanup()
 {
+    for (auto& renderBundle : renderBundles) {
+        if (renderBundle) renderBundle.release();
+    }
     if (bindGroup) bindGroup.release();
     if (cellBuffers.writeBindGroup) cellBuffers.writeBindGroup.release();
     if (cellBuffers.readBindGroup) cellBuffers.readBindGroup.release();
     if (cellBuffers.write) cellBuffers.write.release();
     if (cellBuffers.read) cellBuffers.read.release();
+    if (ltlTableBuffer) ltlTableBuffer.release();
+    if (leniaKernelBuffer) leniaKernelBuffer.release();
+    if (voxelOccupancyBuffer) voxelOccupancyBuffer.release();
+    if (voxelCameraBuffer) voxelCameraBuffer.release();
     if (bindGroupLayout) bindGroupLayout.release();
+    if (seedBuffer) seedBuffer.release();
     if (uniformBuffer) uniformBuffer.release();
     if (vertexBuffer) vertexBuffer.release();
-    if (renderPipeline) renderPipeline.release();
-    if (simulationPipeline) simulationPipeline.release();
+    pipelineCache.reset();
     if (surface) surface.release();
+    if (offscreenTexture) offscreenTexture.release();
+    gpuTimer.reset();
+    periodMonitor.reset();
+    cellEditor.reset();
+    historyRecorder.reset();
     if (queue) queue.release();
     if (device) device.release();
     if (adapter) adapter.release();
@@ -344,74 +873,626 @@ void Life::cleanup()
 
 void Life::renderFrame()
 {
-    if (!shouldUpdateCells()) {
+    // Nothing is drawn before the device is up and the render pipeline is built, the seeded board is waiting by then
+    const bool rendering = !headless || !headless->computeOnly;
+    if (!ready || (rendering && !pipelineCache->isReady(renderPipelineKey))) return;
+
+    // A new topology's halo has to be in place before anything reads the board
+    if (haloRefillPending) {
+        if (!pipelineCache->isReady(haloPipelineKey)) return;
+        refillHalo();
+    }
+
+    // The newest streamed board replaces whatever is on the GPU
+    if (streamUploadPending && pipelineCache->isReady(unpackPipelineKey)) showStreamedBoard();
+
+    // The first frames are drawn while the compute variants may still be compiling, the board holds still until then
+    const bool computeReady = pipelineCache->isReady(simulationPipelineKey) && pipelineCache->isReady(haloPipelineKey) &&
+                              pipelineCache->isReady(hashPipelineKey) && pipelineCache->isReady(packPipelineKey) &&
+                              (voxelRule ? isVoxelReady()
+                               : leniaRule ? pipelineCache->isReady(leniaPipelineKey)
+                               : latticeRule ? pipelineCache->isReady(latticePipelineKey)
+                               : rule.isConway() || isLtlReady());
+
+    // Edits change the board, so whatever repeated before no longer does. They wait while editMain is compiling.
+    // Volumes take none, editMain would write into their bricks
+    if (voxelRule && cellEditor->hasPending()) cellEditor->clear();
+    const bool edited = computeReady && cellEditor->hasPending() && pipelineCache->isReady(editPipelineKey);
+    if (edited) periodMonitor->reset();
+
+    // A halted or paused board submits nothing at all, except one render pass after a resize or seek.
+    // Edits are drawn right away, without waiting for the next step. A streamed board is only stepped by the server
+    const bool halted = isHalted();
+    uint32_t stepCount = 0;
+    if (computeReady && !halted && !streaming) {
+        if (requestedSteps > 0) stepCount = requestedSteps;
+        else if (!paused && shouldUpdateCells()) stepCount = stepsPerFrame;
+    }
+    requestedSteps = 0;
+    // Stepping a still board gives the same board, and both ping-pong buffers already hold it: only the generation
+    // moves on, nothing is submitted or presented (the surface keeps showing the last frame)
+    if (stepCount > 0 && isStill()) {
+        step += stepCount;
+        stepCount = 0;
+    }
+    const bool stepping = stepCount > 0;
+    if (!stepping && !edited && !redrawPending) {
         return;
     }
+    redrawPending = false;
+    TRACE_SCOPE("Life::renderFrame");
+    // Starts the encode timing, so it covers the encoder creation
+    gpuTimer->beginFrame();
     
     // Create command encoder
-    wgpu::CommandEncoder encoder = getDevice().createCommandEncoder();
+    wgpu::CommandEncoder encoder {nullptr};
+    {
+        TRACE_SCOPE("createCommandEncoder");
+        encoder = getDevice().createCommandEncoder();
+    }
+
+    // Scatter the edits into the current generation, then refresh its halo in case they touched the border
+    if (edited) {
+        TRACE_SCOPE("encodeEdits");
+        const uint32_t editCount = cellEditor->upload();
+        constexpr uint32_t EDIT_WORKGROUP_SIZE = WORKGROUP_SIZE * WORKGROUP_SIZE;
+        wgpu::ComputePassEncoder editPass = encoder.beginComputePass();
+        editPass.setPipeline(pipelineCache->getCompute(editPipelineKey));
+        editPass.setBindGroup(0, getCurrentGenerationBindGroup(), 0, nullptr);
+        editPass.dispatchWorkgroups((editCount + EDIT_WORKGROUP_SIZE - 1) / EDIT_WORKGROUP_SIZE, 1, 1);
+        dispatchHalo(editPass, getCurrentGenerationBindGroup());
+        editPass.end();
+    }
 
     // Compute Shader Pass
-    wgpu::ComputePassEncoder computePass = encoder.beginComputePass();
-    computePass.setPipeline(getSimulationPipeline());
-    
-    // Alternate between bind groups each step
-    wgpu::BindGroup currentBindGroup = (step % 2 == 0) 
-        ? cellBuffers.readBindGroup 
-        : cellBuffers.writeBindGroup;
-    computePass.setBindGroup(0, currentBindGroup, 0, nullptr);
+    bool hashed = false;
+    if (stepping) {
+        TRACE_SCOPE("encodeCompute");
+        // Clears the summary computeMain counts changed cells into and hashMain hashes into
+        hashed = periodMonitor->beginFrame(encoder);
+        wgpu::ComputePassDescriptor computePassDesc {};
+        computePassDesc.setDefault();
+        computePassDesc.timestampWrites = gpuTimer->getComputeTimestampWrites();
+        wgpu::ComputePassEncoder computePass = encoder.beginComputePass(computePassDesc);
+        
+        // Calculate workgroup count
+        const uint32_t workgroupCount = (GRID_SIZE + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        // Dispatches in one pass see each other's writes, so a batch of generations shares one pass (and its timing),
+        // alternating between the bind groups
+        for (uint32_t i = 0; i < stepCount; i++) {
+            if (voxelRule) {
+                dispatchVoxel(computePass, getSteppingBindGroup());
+            } else if (leniaRule) {
+                dispatchLenia(computePass, getSteppingBindGroup());
+            } else if (latticeRule) {
+                computePass.setPipeline(pipelineCache->getCompute(latticePipelineKey));
+                computePass.setBindGroup(0, getSteppingBindGroup(), 0, nullptr);
+                computePass.dispatchWorkgroups(workgroupCount, workgroupCount, 1);
+            } else if (rule.isConway()) {
+                computePass.setPipeline(getSimulationPipeline());
+                computePass.setBindGroup(0, getSteppingBindGroup(), 0, nullptr);
+                computePass.dispatchWorkgroups(workgroupCount, workgroupCount, 1);
+            } else {
+                dispatchLtl(computePass, getSteppingBindGroup());
+            }
+            // The next generation reads its neighbours across the edges from the halo
+            dispatchHalo(computePass, getSteppingBindGroup());
+            step++;
+        }
+        
+        computePass.end();
+
+        // Hash the last generation of the batch, which the next step reads as its input.
+        // Its own untimed pass, so the compute timings stay comparable
+        if (hashed) {
+            wgpu::ComputePassEncoder hashPass = encoder.beginComputePass();
+            hashPass.setBindGroup(0, getSteppingBindGroup(), 0, nullptr);
+            if (voxelRule) {
+                constexpr uint32_t BRICK_WORKGROUPS = VOXEL_BRICKS / VOXEL_WORKGROUP_SIZE;
+                hashPass.setPipeline(pipelineCache->getCompute(voxelHashPipelineKey));
+                hashPass.dispatchWorkgroups(BRICK_WORKGROUPS, BRICK_WORKGROUPS, BRICK_WORKGROUPS);
+            } else {
+                hashPass.setPipeline(pipelineCache->getCompute(hashPipelineKey));
+                hashPass.dispatchWorkgroups(workgroupCount, workgroupCount, 1);
+            }
+            hashPass.end();
+            periodMonitor->resolve(encoder);
+        }
+    }
+
+    // Record the generation the next frame steps from, whether it was just stepped or just edited
+    bool recorded = false;
+    if (stepping || edited) {
+        TRACE_SCOPE("encodeRecord");
+        recorded = encodeRecord(encoder, getSteppingBindGroup());
+    }
+
+    // ========== RENDER PASS - Draw the cells ==========
+    wgpu::TextureView view {nullptr};
+    if (rendering) {
+        TRACE_SCOPE("getCurrentTexture");
+        if (offscreenTexture) {
+            view = offscreenTexture.createView();
+        } else {
+            wgpu::SurfaceTexture surfaceTexture {};
+            getSurface().getCurrentTexture(&surfaceTexture);
+            wgpu::Texture texture = surfaceTexture.texture;
+            view = texture.createView();
+        }
+    }
+
+    if (rendering) {
+        TRACE_SCOPE("encodeRender");
+        if (voxelRule && voxelCameraDirty) writeVoxelCamera();
+        wgpu::RenderPassColorAttachment colorAttachment {};
+        colorAttachment.view = view;
+        colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+        colorAttachment.loadOp = wgpu::LoadOp::Clear;
+        colorAttachment.storeOp = wgpu::StoreOp::Store;
+        colorAttachment.clearValue = wgpu::Color(0.0, 0.0, 0.4, 1.0);
+
+        wgpu::RenderPassDescriptor renderPassDesc {};
+        renderPassDesc.colorAttachmentCount = 1;
+        renderPassDesc.colorAttachments = &colorAttachment;
+        renderPassDesc.timestampWrites = gpuTimer->getRenderTimestampWrites();
+
+        wgpu::RenderPassEncoder renderPass = encoder.beginRenderPass(renderPassDesc);
+        // Draw the newest generation, the one the next step reads
+        if (useRenderBundles) {
+            if (!renderBundles[0]) createRenderBundles();
+            renderPass.executeBundles(1, &renderBundles[step % 2]);
+        } else {
+            encodeDraw(renderPass, getSteppingBindGroup());
+        }
+        renderPass.end();
+    }
+    gpuTimer->resolve(encoder);
+
+    // Submit all commands
+    {
+        TRACE_SCOPE("submit");
+        wgpu::CommandBuffer commandBuffer = encoder.finish();
+        getQueue().submit(commandBuffer);
+        gpuTimer->afterSubmit();
+        if (hashed) periodMonitor->afterSubmit(step);
+        if (recorded) historyRecorder->afterSubmit(step);
+    }
+    markStartup(StartupMilestone::FirstFrame);
+    if (stepping) markStartup(StartupMilestone::FirstGeneration);
     
-    // Calculate workgroup count
+    if (view) view.release();
+}
+
+template <typename RenderEncoder>
+void Life::encodeDraw(const RenderEncoder& encoder, const wgpu::BindGroup& bindGroup) const
+{
+    encoder.setPipeline(getRenderPipeline());
+    encoder.setVertexBuffer(0, getVertexBuffer(), 0, sizeof(VERTICES));
+    encoder.setBindGroup(0, bindGroup, 0, nullptr);
+    if (voxelRule) {
+        // One triangle over the whole target, voxelFragmentMain casts a ray per pixel
+        encoder.draw(3, 1, 0, 0);
+        return;
+    }
+    const auto [firstVertex, vertexCount] = getLatticeVertices();
+    encoder.draw(vertexCount, GRID_SIZE * GRID_SIZE, firstVertex, 0);
+}
+
+void Life::createRenderBundles()
+{
+    TRACE_SCOPE("Life::createRenderBundles");
+    // Nothing in the draw changes between frames except which buffer holds the board, so each parity is recorded once
+    // and a frame only replays it (the render pipeline and bind groups live as long as Life)
+    const WGPUTextureFormat colorFormat = surfaceConfig.format;
+    wgpu::RenderBundleEncoderDescriptor bundleEncoderDesc {};
+    bundleEncoderDesc.setDefault();
+    bundleEncoderDesc.colorFormatCount = 1;
+    bundleEncoderDesc.colorFormats = &colorFormat;
+    bundleEncoderDesc.sampleCount = 1;
+    const std::array<const wgpu::BindGroup*, 2> bindGroups = {&cellBuffers.readBindGroup, &cellBuffers.writeBindGroup};
+    for (size_t parity = 0; parity < renderBundles.size(); parity++) {
+        wgpu::RenderBundleEncoder bundleEncoder = getDevice().createRenderBundleEncoder(bundleEncoderDesc);
+        encodeDraw(bundleEncoder, *bindGroups[parity]);
+        wgpu::RenderBundleDescriptor bundleDesc {};
+        bundleDesc.setDefault();
+        bundleDesc.label = parity == 0 ? "Cells render bundle A" : "Cells render bundle B";
+        renderBundles[parity] = bundleEncoder.finish(bundleDesc);
+        bundleEncoder.release();
+        if (!renderBundles[parity]) throw Life::RuntimeError("Failed to create the render bundle");
+    }
+}
+
+void Life::seed(uint64_t seed, double density)
+{
+    TRACE_SCOPE("Life::seed");
+    boardSeed = seed;
+    boardDensity = density;
+    // The old timeline is gone, generation 0 starts the new one
+    historyRecorder->reset();
+
+    const bool gpuSeed = !haloRefillPending && pipelineCache->isReady(seedPipelineKey) &&
+                         pipelineCache->isReady(haloPipelineKey) && pipelineCache->isReady(packPipelineKey);
+    if (voxelRule) {
+        uploadVoxelSoup();
+    } else if (leniaRule) {
+        uploadLeniaSoup();
+    } else if (gpuSeed) {
+        const CounterRng::Key key = CounterRng::makeKey(seed);
+        const SeedParams params {{key.lo, key.hi}, CounterRng::threshold(density), 0};
+        getQueue().writeBuffer(seedBuffer, 0, &params, sizeof(params));
+
+        // Generation 0 reads cellBuffers.read, which is the OUTPUT of bind group B
+        wgpu::CommandEncoder encoder = getDevice().createCommandEncoder();
+        wgpu::ComputePassEncoder computePass = encoder.beginComputePass();
+        computePass.setPipeline(pipelineCache->getCompute(seedPipelineKey));
+        computePass.setBindGroup(0, cellBuffers.writeBindGroup, 0, nullptr);
+        const uint32_t workgroupCount = (GRID_SIZE + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        computePass.dispatchWorkgroups(workgroupCount, workgroupCount, 1);
+        dispatchHalo(computePass, cellBuffers.writeBindGroup);
+        computePass.end();
+
+        const bool recorded = encodeRecord(encoder, cellBuffers.readBindGroup);
+
+        wgpu::CommandBuffer commandBuffer = encoder.finish();
+        getQueue().submit(commandBuffer);
+        if (recorded) historyRecorder->afterSubmit(0);
+    } else {
+        uploadSeededBoard();
+    }
+    step = 0;
+    accumulatedTime = UPDATE_INTERVAL_SECONDS;
+    periodMonitor->reset();
+    cellEditor->clear();
+    redrawPending = true;
+}
+
+void Life::uploadSeededBoard()
+{
+    TRACE_SCOPE("Life::uploadSeededBoard");
+    Grid board(GRID_SIZE, GRID_SIZE);
+    board.fillRandom(boardDensity, boardSeed);
+
+    std::vector<uint32_t> cells(static_cast<size_t>(PADDED_SIZE) * PADDED_SIZE, 0);
+    for (int y = -1; y <= GRID_SIZE; y++) {
+        for (int x = -1; x <= GRID_SIZE; x++) {
+            const bool inside = x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE;
+            const std::optional<Topology::Cell> source = inside
+                ? Topology::Cell{x, y}
+                : Topology::haloSource(topology, x, y, GRID_SIZE, GRID_SIZE);
+            if (!source) continue;
+            cells[static_cast<size_t>(y + 1) * PADDED_SIZE + (x + 1)] =
+                board.getCell(static_cast<uint32_t>(source->x), static_cast<uint32_t>(source->y));
+        }
+    }
+    // Generation 0 reads cellBuffers.read
+    getQueue().writeBuffer(cellBuffers.read, 0, cells.data(), CELL_STATE_SIZE);
+    historyRecorder->record(0, History::pack(board));
+}
+
+void Life::uploadLeniaSoup()
+{
+    TRACE_SCOPE("Life::uploadLeniaSoup");
+    const std::vector<float> soup = LeniaEngine::makeSoup(GRID_SIZE, GRID_SIZE, boardSeed, boardDensity);
+    // leniaMain reads across the edges itself, the halo only has to be right for the other passes
+    std::vector<float> states(static_cast<size_t>(PADDED_SIZE) * PADDED_SIZE, 0.0f);
+    for (int y = -1; y <= GRID_SIZE; y++) {
+        for (int x = -1; x <= GRID_SIZE; x++) {
+            const bool inside = x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE;
+            const std::optional<Topology::Cell> source = inside
+                ? Topology::Cell{x, y}
+                : Topology::haloSource(topology, x, y, GRID_SIZE, GRID_SIZE);
+            if (!source) continue;
+            states[static_cast<size_t>(y + 1) * PADDED_SIZE + (x + 1)] =
+                soup[static_cast<size_t>(source->y) * GRID_SIZE + source->x];
+        }
+    }
+    // f32 bits in the u32 cells, generation 0 reads cellBuffers.read
+    static_assert(sizeof(float) == sizeof(uint32_t));
+    getQueue().writeBuffer(cellBuffers.read, 0, states.data(), CELL_STATE_SIZE);
+}
+
+void Life::uploadVoxelSoup()
+{
+    TRACE_SCOPE("Life::uploadVoxelSoup");
+    const VoxelVolume soup = VoxelVolume::makeSoup(VOXEL_SIZE, boardSeed, boardDensity);
+    // Each 64-bit brick is voxelMain's pair of u32 words (z 0-1 low, z 2-3 high), generation 0 reads cellBuffers.read
+    getQueue().writeBuffer(cellBuffers.read, 0, soup.getBricks().data(), VOXEL_STATE_SIZE);
+
+    // The occupancy mip voxelMain and voxelMipMain would have left: a flag per brick, then per 2x2x2 block below
+    std::vector<uint32_t> occupancy(VOXEL_OCCUPANCY_SIZE / sizeof(uint32_t), 0);
+    for (size_t brick = 0; brick < soup.getBricks().size(); brick++) occupancy[brick] = soup.getBricks()[brick] != 0;
+    size_t belowOffset = 0;
+    size_t offset = soup.getBricks().size();
+    for (uint32_t level = 2, side = VOXEL_BRICKS / 2; level <= VOXEL_MIP_LEVELS; level++, side /= 2) {
+        const uint32_t belowSide = side * 2;
+        for (uint32_t z = 0; z < belowSide; z++) {
+            for (uint32_t y = 0; y < belowSide; y++) {
+                for (uint32_t x = 0; x < belowSide; x++) {
+                    const size_t child = belowOffset + (static_cast<size_t>(z) * belowSide + y) * belowSide + x;
+                    occupancy[offset + (static_cast<size_t>(z / 2) * side + y / 2) * side + x / 2] |= occupancy[child];
+                }
+            }
+        }
+        belowOffset = offset;
+        offset += static_cast<size_t>(side) * side * side;
+    }
+    getQueue().writeBuffer(voxelOccupancyBuffer, 0, occupancy.data(), VOXEL_OCCUPANCY_SIZE);
+}
+
+bool Life::encodeRecord(wgpu::CommandEncoder& encoder, const wgpu::BindGroup& bindGroup)
+{
+    // History packs one bit per cell of the board, continuous states and volumes are not recorded
+    if (leniaRule || voxelRule || !historyRecorder->beginFrame()) return false;
+    constexpr uint32_t PACK_WORKGROUP_SIZE = WORKGROUP_SIZE * WORKGROUP_SIZE;
+    constexpr uint32_t PACKED_WORD_COUNT = GRID_SIZE * GRID_SIZE / 32;
+    wgpu::ComputePassEncoder packPass = encoder.beginComputePass();
+    packPass.setPipeline(pipelineCache->getCompute(packPipelineKey));
+    packPass.setBindGroup(0, bindGroup, 0, nullptr);
+    packPass.dispatchWorkgroups((PACKED_WORD_COUNT + PACK_WORKGROUP_SIZE - 1) / PACK_WORKGROUP_SIZE, 1, 1);
+    packPass.end();
+    historyRecorder->resolve(encoder);
+    return true;
+}
+
+bool Life::seekGeneration(uint64_t generation)
+{
+    TRACE_SCOPE("Life::seekGeneration");
+    // Generations stepped for free on a still board are not recorded, but they are all the board on the GPU
+    const std::optional<uint64_t>& stillGeneration = periodMonitor->getStillGeneration();
+    if (skipStillSteps && stillGeneration && generation >= *stillGeneration && generation <= step) {
+        step = static_cast<uint32_t>(generation);
+        return true;
+    }
+    if (leniaRule || voxelRule || generation > UINT32_MAX || !pipelineCache->isReady(unpackPipelineKey)) return false;
+    if (!historyRecorder->upload(generation)) return false;
+    unpackUploadedBoard(generation);
+    return true;
+}
+
+void Life::unpackUploadedBoard(uint64_t generation)
+{
+    step = static_cast<uint32_t>(generation);
+
+    // Expand the uploaded board into the buffer the next step reads, then glue its edges
+    wgpu::CommandEncoder encoder = getDevice().createCommandEncoder();
+    wgpu::ComputePassEncoder computePass = encoder.beginComputePass();
+    computePass.setPipeline(pipelineCache->getCompute(unpackPipelineKey));
+    computePass.setBindGroup(0, getCurrentGenerationBindGroup(), 0, nullptr);
     const uint32_t workgroupCount = (GRID_SIZE + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
     computePass.dispatchWorkgroups(workgroupCount, workgroupCount, 1);
-    
+    dispatchHalo(computePass, getCurrentGenerationBindGroup());
     computePass.end();
-    
-    step++;
+    wgpu::CommandBuffer commandBuffer = encoder.finish();
+    getQueue().submit(commandBuffer);
 
-    // ========== RENDER PASS - Draw the cells ==========
-    wgpu::SurfaceTexture surfaceTexture {};
-    getSurface().getCurrentTexture(&surfaceTexture);
-    wgpu::Texture texture = surfaceTexture.texture;
-    wgpu::TextureView view = texture.createView();
-
-    wgpu::RenderPassColorAttachment colorAttachment {};
-    colorAttachment.view = view;
-    colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
-    colorAttachment.loadOp = wgpu::LoadOp::Clear;
-    colorAttachment.storeOp = wgpu::StoreOp::Store;
-    colorAttachment.clearValue = wgpu::Color(0.0, 0.0, 0.4, 1.0);
-
-    wgpu::RenderPassDescriptor renderPassDesc {};
-    renderPassDesc.colorAttachmentCount = 1;
-    renderPassDesc.colorAttachments = &colorAttachment;
-
-    wgpu::RenderPassEncoder renderPass = encoder.beginRenderPass(renderPassDesc);
-    renderPass.setPipeline(getRenderPipeline());
-    renderPass.setVertexBuffer(0, getVertexBuffer(), 0, sizeof(VERTICES));
-    
-    // Use the SAME bind group that was just written to by compute pass
-    renderPass.setBindGroup(0, currentBindGroup, 0, nullptr);
-    
-    constexpr uint32_t VERTEX_COUNT = sizeof(VERTICES) / sizeof(float) / 2;
-    renderPass.draw(VERTEX_COUNT, GRID_SIZE * GRID_SIZE, 0, 0);
-    renderPass.end();
+    // Readbacks in flight belong to the generations after this one, and so do pending edits and the detected cycle
+    historyRecorder->discardPending();
+    periodMonitor->reset();
+    cellEditor->clear();
+    redrawPending = true;
+}
 
-    // Submit all commands
+bool Life::receiveStreamMessage(const uint8_t* data, size_t size)
+{
+    if (leniaRule || latticeRule || voxelRule) return false;
+    if (!streamDecoder) streamDecoder = std::make_unique<DeltaStream::Decoder>(GRID_SIZE, GRID_SIZE);
+    if (!streamDecoder->apply(data, size)) return false;
+    // The local timeline has nothing to do with the streamed one
+    if (!streaming) historyRecorder->reset();
+    streaming = true;
+    streamUploadPending = true;
+    return true;
+}
+
+void Life::resetStream()
+{
+    if (streamDecoder) streamDecoder->reset();
+}
+
+void Life::showStreamedBoard()
+{
+    TRACE_SCOPE("Life::showStreamedBoard");
+    streamUploadPending = false;
+    // Streamed generations can be rewound like simulated ones
+    const uint64_t generation = streamDecoder->getGeneration();
+    historyRecorder->record(generation, streamDecoder->getBoard());
+    historyRecorder->upload(streamDecoder->getBoard());
+    unpackUploadedBoard(generation);
+}
+
+const wgpu::BindGroup& Life::getCurrentGenerationBindGroup() const
+{
+    // Stepping uses the other bind group, which reads this one's output as its input
+    return (step % 2 == 0) ? cellBuffers.writeBindGroup : cellBuffers.readBindGroup;
+}
+
+const wgpu::BindGroup& Life::getSteppingBindGroup() const
+{
+    // Alternate between bind groups each step
+    return (step % 2 == 0) ? cellBuffers.readBindGroup : cellBuffers.writeBindGroup;
+}
+
+void Life::setTopology(Topology::Kind kind)
+{
+    TRACE_SCOPE("Life::setTopology");
+    Topology::validate(kind, GRID_SIZE, GRID_SIZE);
+    validateRules(rule, leniaRule, latticeRule, voxelRule, kind);
+    topology = kind;
+    // Before startup finishes the first board is simply seeded with this topology
+    if (!pipelineCache) return;
+    requestHaloPipeline();
+    if (!rule.isConway()) requestLtlPipelines();
+    if (leniaRule) requestLeniaPipeline();
+    if (latticeRule) requestLatticePipeline();
+    periodMonitor->reset();
+
+    // The current generation was written with the old halo, refill it before it is stepped.
+    // Topologies used before are cached and switch at once
+    haloRefillPending = true;
+    if (pipelineCache->isReady(haloPipelineKey)) refillHalo();
+}
+
+void Life::validateRules(const LtlRule& rule, const std::optional<LeniaRule>& leniaRule,
+                         const std::optional<LatticeRule>& latticeRule, const std::optional<VoxelRule>& voxelRule,
+                         Topology::Kind kind)
+{
+    const bool supported = kind == Topology::Kind::Torus || kind == Topology::Kind::Plane;
+    if (!rule.isConway() && !supported) {
+        throw Engine::ConfigurationError("Larger than Life rules only run on the torus and the plane, not " +
+                                         std::string(Topology::getName(kind)));
+    }
+    if (leniaRule && !supported) {
+        throw Engine::ConfigurationError("Lenia only runs on the torus and the plane, not " +
+                                         std::string(Topology::getName(kind)));
+    }
+    // GRID_SIZE is even, so the torus keeps the row and cell parities the lattices depend on across its edges
+    if (latticeRule && !supported) {
+        throw Engine::ConfigurationError("hexagonal and triangular lattices only run on the torus and the plane, not " +
+                                         std::string(Topology::getName(kind)));
+    }
+    if (latticeRule && (leniaRule || !rule.isConway())) {
+        throw Engine::ConfigurationError("Lenia and Larger than Life rules only run on the square lattice");
+    }
+    // voxelMain wraps every axis itself
+    if (voxelRule && kind != Topology::Kind::Torus) {
+        throw Engine::ConfigurationError("3D rules only run on the torus, not " + std::string(Topology::getName(kind)));
+    }
+    if (voxelRule && (leniaRule || latticeRule || !rule.isConway())) {
+        throw Engine::ConfigurationError("3D rules replace the board, not with Lenia, lattices or Larger than Life");
+    }
+}
+
+void Life::setRule(const LtlRule& newRule)
+{
+    TRACE_SCOPE("Life::setRule");
+    validateRules(newRule, leniaRule, latticeRule, voxelRule, topology);
+    rule = newRule;
+    // Before startup finishes the pipelines are requested with the others
+    if (!pipelineCache) return;
+    if (!rule.isConway()) requestLtlPipelines();
+    // The board holds still until the rule's variants are built, and repeats seen under the old rule mean nothing
+    periodMonitor->reset();
+    redrawPending = true;
+}
+
+void Life::setLeniaRule(const std::optional<LeniaRule>& newRule)
+{
+    TRACE_SCOPE("Life::setLeniaRule");
+    validateRules(rule, newRule, latticeRule, voxelRule, topology);
+    const bool modeChanged = newRule.has_value() != leniaRule.has_value();
+    leniaRule = newRule;
+    // Before startup finishes the pipelines are requested with the others and the first board is seeded as Lenia
+    if (!pipelineCache) return;
+    if (leniaRule) {
+        requestLeniaPipeline();
+        uploadLeniaKernel();
+    }
+    if (modeChanged) {
+        // Cells are read as the other kind of state from here on: new render and edit variants (the bundles recorded
+        // the old render pipeline)
+        requestRenderPipeline();
+        PipelineCache::Constants editConstants = getStateConstants();
+        editConstants["WORKGROUP_SIZE"] = static_cast<double>(WORKGROUP_SIZE);
+        editPipelineKey = pipelineCache->requestCompute("editMain", editConstants);
+        for (auto& renderBundle : renderBundles) {
+            if (renderBundle) renderBundle.release();
+            renderBundle = nullptr;
+        }
+    }
+    seed(boardSeed, boardDensity);
+}
+
+void Life::setLatticeRule(const std::optional<LatticeRule>& newRule)
+{
+    TRACE_SCOPE("Life::setLatticeRule");
+    validateRules(rule, leniaRule, newRule, voxelRule, topology);
+    const bool shapeChanged = (newRule ? newRule->kind : std::optional<LatticeRule::Kind>()) !=
+                              (latticeRule ? latticeRule->kind : std::optional<LatticeRule::Kind>());
+    latticeRule = newRule;
+    // Before startup finishes the pipelines are requested with the others
+    if (!pipelineCache) return;
+    if (latticeRule) requestLatticePipeline();
+    if (shapeChanged) {
+        // Another render variant and vertex range, which the bundles recorded
+        requestRenderPipeline();
+        for (auto& renderBundle : renderBundles) {
+            if (renderBundle) renderBundle.release();
+            renderBundle = nullptr;
+        }
+    }
+    // Like setRule: the board holds still until the variant is built, and earlier repeats mean nothing
+    periodMonitor->reset();
+    redrawPending = true;
+}
+
+void Life::setVoxelRule(const std::optional<VoxelRule>& newRule)
+{
+    TRACE_SCOPE("Life::setVoxelRule");
+    validateRules(rule, leniaRule, latticeRule, newRule, topology);
+    const bool modeChanged = newRule.has_value() != voxelRule.has_value();
+    voxelRule = newRule;
+    // Before startup finishes the pipelines are requested with the others and the first volume is seeded
+    if (!pipelineCache) return;
+    if (voxelRule) requestVoxelPipelines();
+    if (modeChanged) {
+        // The raymarcher instead of the cells or back, which the bundles recorded
+        requestRenderPipeline();
+        for (auto& renderBundle : renderBundles) {
+            if (renderBundle) renderBundle.release();
+            renderBundle = nullptr;
+        }
+    }
+    // Like Lenia the cell buffers hold another kind of state from here on, so either mode starts from a fresh soup
+    // (the board needs its halo refilled from a volume's bricks). Rule changes within 3D reseed too, like Lenia's
+    seed(boardSeed, boardDensity);
+}
+
+void Life::setVoxelView(float yaw, float pitch, float distance)
+{
+    constexpr float MAX_PITCH = 1.5f;
+    voxelYaw = yaw;
+    voxelPitch = std::clamp(pitch, -MAX_PITCH, MAX_PITCH);
+    voxelDistance = std::max(distance, 0.1f);
+    voxelCameraDirty = true;
+    if (voxelRule) redrawPending = true;
+}
+
+void Life::refillHalo()
+{
+    TRACE_SCOPE("Life::refillHalo");
+    haloRefillPending = false;
+    wgpu::CommandEncoder encoder = getDevice().createCommandEncoder();
+    wgpu::ComputePassEncoder computePass = encoder.beginComputePass();
+    dispatchHalo(computePass, getCurrentGenerationBindGroup());
+    computePass.end();
     wgpu::CommandBuffer commandBuffer = encoder.finish();
     getQueue().submit(commandBuffer);
-    
-    view.release();
+    redrawPending = true;
 }
 
 void Life::handleResize()
 {
+    // The surface is configured with the canvas size of the moment it is created, offscreen targets keep their size
+    if (!ready || headless) return;
+#ifdef __EMSCRIPTEN__
     int width, height;
     emscripten_get_canvas_element_size("#canvas", &width, &height);
 
     surfaceConfig.width = static_cast<uint32_t>(width);
     surfaceConfig.height = static_cast<uint32_t>(height);
     surface.configure(surfaceConfig);
+    // The voxel camera's aspect follows the canvas
+    voxelCameraDirty = true;
+    redrawPending = true;
+#endif
+}
+
+bool Life::isIdle() const
+{
+    if (!ready || redrawPending || requestedSteps > 0 || haloRefillPending || streamUploadPending || cellEditor->hasPending()) {
+        return false;
+    }
+    return paused || streaming || isHalted();
 }
 
 bool Life::shouldUpdateCells() {
@@ -1,10 +1,41 @@
 #pragma once
 #include <cstdint>
 #include "webgpu.hpp"
+#include "GpuTimer.h"
+#include "PeriodMonitor.h"
+#include "CellEditor.h"
+#include "HistoryRecorder.h"
+#include "DeltaStream.h"
+#include "PipelineCache.h"
+#include "Topology.h"
+#include "LtlRule.h"
+#include "LeniaRule.h"
+#include "LatticeRule.h"
+#include "VoxelRule.h"
+#include "VoxelVolume.h"
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 class Life
 {
+public:
+    // Milestones of the asynchronous startup, in the order they are reached
+    enum class StartupMilestone : uint32_t {
+        Adapter,
+        Device,
+        Resources,        // Buffers made and the first board uploaded, the object is ready from here on
+        FirstFrame,       // First render pass submitted
+        FirstGeneration,  // First frame that stepped the board submitted
+    };
+    static constexpr uint32_t STARTUP_MILESTONE_COUNT = 5;
+    using ReadyCallback = std::function<void(Life&)>;
+
 private:
     // WGPU Context
     struct PingPongBuffers {
@@ -25,16 +56,75 @@ private:
     wgpu::Queue queue{nullptr};
     wgpu::Surface surface{nullptr};
     wgpu::SurfaceConfiguration surfaceConfig{};
-    wgpu::RenderPipeline renderPipeline{nullptr};
-    wgpu::ComputePipeline simulationPipeline{nullptr};
+    // Render target of a headless Life instead of the surface
+    wgpu::Texture offscreenTexture{nullptr};
+    static constexpr wgpu::TextureFormat OFFSCREEN_FORMAT = wgpu::TextureFormat::RGBA8Unorm;
+    // Pipelines are looked up by variant key, see PipelineCache
+    std::unique_ptr<PipelineCache> pipelineCache;
+    std::string renderPipelineKey;
+    std::string simulationPipelineKey;
+    std::string seedPipelineKey;
+    std::string hashPipelineKey;
+    std::string haloPipelineKey;
+    std::string editPipelineKey;
+    std::string packPipelineKey;
+    std::string unpackPipelineKey;
+    // Larger than Life variants of the current rule, see requestLtlPipelines
+    std::string ltlRowsPipelineKey;
+    std::string ltlColumnsPipelineKey;
+    std::string ltlPipelineKey;
+    // leniaMain of the current Lenia rule, see requestLeniaPipeline
+    std::string leniaPipelineKey;
+    // hexMain or triangleMain of the current lattice rule, see requestLatticePipeline
+    std::string latticePipelineKey;
+    // voxelMain of the current 3D rule, voxelMipMain per mip level above the first and voxelHashMain, see
+    // requestVoxelPipelines
+    std::string voxelPipelineKey;
+    std::vector<std::string> voxelMipPipelineKeys;
+    std::string voxelHashPipelineKey;
     wgpu::Buffer vertexBuffer{nullptr};
     wgpu::Buffer uniformBuffer{nullptr};
+    wgpu::Buffer seedBuffer{nullptr};
     PingPongBuffers cellBuffers;
+    wgpu::Buffer ltlTableBuffer{nullptr};
+    wgpu::Buffer leniaKernelBuffer{nullptr};
+    wgpu::Buffer voxelOccupancyBuffer{nullptr};
+    wgpu::Buffer voxelCameraBuffer{nullptr};
     wgpu::BindGroupLayout bindGroupLayout{nullptr};
     wgpu::BindGroup bindGroup{nullptr};
+    // The whole render pass draw, recorded once per ping-pong parity (index step % 2) when first drawn
+    std::array<wgpu::RenderBundle, 2> renderBundles{};
+    bool useRenderBundles = true;
+    bool timestampQuerySupported = false;
+    // Pending adapter and device requests, their callbacks carry startup forward (see Life::Life)
+    std::unique_ptr<wgpu::RequestAdapterCallback> adapterRequest;
+    std::unique_ptr<wgpu::RequestDeviceCallback> deviceRequest;
+    std::unique_ptr<GpuTimer> gpuTimer;
+    std::unique_ptr<PeriodMonitor> periodMonitor;
+    std::unique_ptr<CellEditor> cellEditor;
+    std::unique_ptr<HistoryRecorder> historyRecorder;
+    // Boards received from a life_serve stream, see receiveStreamMessage
+    std::unique_ptr<DeltaStream::Decoder> streamDecoder;
+
+    // Mirrors SeedParams in shader.wgsl
+    struct SeedParams {
+        uint32_t key[2];
+        uint32_t threshold;
+        uint32_t padding;
+    };
 
-    // Geometry
+    // Mirrors VoxelCamera in shader.wgsl, in cell units of the volume (see writeVoxelCamera)
+    struct VoxelCamera {
+        float eye[4];
+        float right[4];
+        float up[4];
+        float forward[4];
+    };
+
+    // Geometry, in half-cell units around the cell centre: one shape per lattice, one after the other in vertexBuffer
+    // (see getLatticeVertices)
     static constexpr float VERTICES[] = {
+        // Square
         -0.8f, -0.8f,
          0.8f, -0.8f,
          0.8f,  0.8f,
@@ -42,33 +132,202 @@ private:
         -0.8f, -0.8f,
          0.8f,  0.8f,
         -0.8f,  0.8f,
+
+        // Hexagon with a pointy top, 4/3 cells tall so that rows one cell apart interlock
+         0.0f,  1.2f,
+        -0.9f,  0.6f,
+         0.9f,  0.6f,
+
+        -0.9f,  0.6f,
+        -0.9f, -0.6f,
+         0.9f, -0.6f,
+
+        -0.9f,  0.6f,
+         0.9f, -0.6f,
+         0.9f,  0.6f,
+
+        -0.9f, -0.6f,
+         0.0f, -1.2f,
+         0.9f, -0.6f,
+
+        // Triangle pointing up, vertexMain flips it for the cells pointing down
+        -0.85f, -0.85f,
+         0.85f, -0.85f,
+         0.0f,   0.85f,
     };
+    static constexpr uint32_t SQUARE_VERTEX_COUNT = 6;
+    static constexpr uint32_t HEX_VERTEX_COUNT = 12;
+    static constexpr uint32_t TRIANGLE_VERTEX_COUNT = 3;
+    static_assert(sizeof(VERTICES) ==
+                  (SQUARE_VERTEX_COUNT + HEX_VERTEX_COUNT + TRIANGLE_VERTEX_COUNT) * 2 * sizeof(float));
     static constexpr int GRID_SIZE = 256;
     static constexpr int WORKGROUP_SIZE = 8;
+    static_assert(GRID_SIZE % 64 == 0, "packMain and History need whole 64-cell words per row");
     static constexpr float GRID_DIMENSIONS[2] = {
         static_cast<float>(GRID_SIZE), 
         static_cast<float>(GRID_SIZE)
     };
 
-    // Cell State
+    // Cell State (GPU resident, one u32 per cell plus a one-cell halo around the board, see haloMain)
+    static constexpr int PADDED_SIZE = GRID_SIZE + 2;
+    static constexpr uint64_t CELL_STATE_SIZE = static_cast<uint64_t>(PADDED_SIZE) * PADDED_SIZE * sizeof(uint32_t);
+    static constexpr uint32_t HALO_CELL_COUNT = 4 * (GRID_SIZE + 1);
+    // Summed-area table of ltlRowsMain and ltlColumnsMain, (GRID_SIZE + 2R + 1) squared u32 for the largest radius
+    static constexpr uint64_t LTL_TABLE_SIZE =
+        static_cast<uint64_t>(GRID_SIZE + 2 * LtlRule::MAX_RADIUS + 1) * (GRID_SIZE + 2 * LtlRule::MAX_RADIUS + 1) *
+        sizeof(uint32_t);
+    // LeniaRule::kernel of the largest radius, f32 weights
+    static constexpr uint64_t LENIA_KERNEL_SIZE =
+        static_cast<uint64_t>(2 * LeniaRule::MAX_RADIUS + 1) * (2 * LeniaRule::MAX_RADIUS + 1) * sizeof(float);
+    // leniaMain's workgroup side (LENIA_TILE in shader.wgsl)
+    static constexpr int LENIA_TILE = 16;
+    static_assert(GRID_SIZE % LENIA_TILE == 0, "leniaMain has no bounds checks, its tiles must cover the board");
+    // 3D Life: a VOXEL_SIZE^3 torus as VoxelVolume bricks (two u32 per brick) in the cell buffers, which are sized for
+    // whichever is larger, the padded board or the volume
+    static constexpr uint32_t VOXEL_SIZE = GRID_SIZE;
+    static constexpr uint32_t VOXEL_BRICKS = VOXEL_SIZE / VoxelVolume::BRICK_SIDE;
+    static constexpr uint64_t VOXEL_STATE_SIZE =
+        static_cast<uint64_t>(VOXEL_BRICKS) * VOXEL_BRICKS * VOXEL_BRICKS * sizeof(uint64_t);
+    static constexpr uint64_t STATE_BUFFER_SIZE = std::max(CELL_STATE_SIZE, VOXEL_STATE_SIZE);
+    // Workgroup side of voxelMain, voxelMipMain and voxelHashMain (VOXEL_WORKGROUP in shader.wgsl), in bricks or mip
+    // cells
+    static constexpr uint32_t VOXEL_WORKGROUP_SIZE = 4;
+    static_assert(VOXEL_BRICKS % VOXEL_WORKGROUP_SIZE == 0, "voxelMain has no bounds checks, it steps whole workgroups");
+    // Occupancy mip of the volume (VOXEL_MIP_LEVELS in shader.wgsl): level l flags the blocks of 2^(l + 1) cells a
+    // side that hold a live cell, level 1 is one flag per brick. u32 flags, the levels one after the other
+    static constexpr uint32_t VOXEL_MIP_LEVELS = 5;
+    static_assert(VOXEL_BRICKS >> (VOXEL_MIP_LEVELS - 1) >= 1, "the top mip level needs a block per side");
+    static constexpr uint64_t VOXEL_OCCUPANCY_SIZE = [] {
+        uint64_t flags = 0;
+        for (uint32_t side = VOXEL_BRICKS, level = 1; level <= VOXEL_MIP_LEVELS; side /= 2, level++) {
+            flags += static_cast<uint64_t>(side) * side * side;
+        }
+        return flags * sizeof(uint32_t);
+    }();
     static constexpr float UPDATE_INTERVAL_SECONDS = 0.1f;
-    std::vector<uint32_t> cellStateArray;
+    static constexpr double DEFAULT_DENSITY = 0.5;
+    uint64_t boardSeed = 0;
+    double boardDensity = DEFAULT_DENSITY;
     float accumulatedTime = UPDATE_INTERVAL_SECONDS;
     std::chrono::steady_clock::time_point lastFrameTime;
     uint32_t step = 0;
+    Topology::Kind topology = Topology::Kind::Torus;
+    // Conway's Life runs computeMain, any other rule the Larger than Life passes
+    LtlRule rule;
+    // Continuous states stepped by leniaMain instead of either, while set
+    std::optional<LeniaRule> leniaRule;
+    // Hexagonal or triangular cells stepped by hexMain or triangleMain instead of the square rules, while set
+    std::optional<LatticeRule> latticeRule;
+    // A 3D volume stepped by voxelMain and raymarched instead of the board, while set
+    std::optional<VoxelRule> voxelRule;
+    // Orbit of the voxel camera around the middle of the volume: angles in radians, distance in volume sides
+    float voxelYaw = 0.6f;
+    float voxelPitch = 0.45f;
+    float voxelDistance = 1.8f;
+    // Set by setVoxelView and handleResize, the camera is rewritten before the next draw
+    bool voxelCameraDirty = true;
+    // Stop submitting work once the board repeats (see PeriodMonitor)
+    bool haltOnCycle = true;
+    // Step a board that stopped changing without the GPU
+    bool skipStillSteps = true;
+    // Set by handleResize, a halted board still needs one render pass to reappear on the new surface
+    bool redrawPending = false;
+    // Set by setTopology, the board holds still until the new halo variant is built and has refilled the halo
+    bool haloRefillPending = false;
+    bool ready = false;
+    bool startupFailed = false;
+    ReadyCallback onReady;
+    // Stepping stopped by the user, requestedSteps still go through
+    bool paused = false;
+    uint32_t requestedSteps = 0;
+    // Generations per UPDATE_INTERVAL_SECONDS, encoded as one batch in a single compute pass
+    uint32_t stepsPerFrame = 1;
+    // Showing a stream instead of simulating, set by the first streamed board
+    bool streaming = false;
+    // A streamed board newer than the one on the GPU, uploaded by the next frame (several messages per frame collapse)
+    bool streamUploadPending = false;
     
     void requestAdapter();
     void requestDevice();
+    // Everything after the device: buffers, bind groups, pipeline requests and the first board
+    void createResources();
+    void markStartup(StartupMilestone milestone);
+    void failStartup(const std::string& message);
+    void createGpuTimer();
+    void createPeriodMonitor();
+    void createCellEditor();
+    void createHistoryRecorder();
     void createSurface();
     void configureSurface();
+    void createOffscreenTarget();
+    // Requests every pipeline variant in use and waits for the ones the first frame needs
     void createPipelines();
+    // haloMain specialized for the current topology (TOPOLOGY override constant)
+    void requestHaloPipeline();
+    // Refills the halo of the current generation with haloMain of the current topology
+    void refillHalo();
+    // ltlRowsMain, ltlColumnsMain and ltlMain specialized for the current rule and topology
+    void requestLtlPipelines();
+    bool isLtlReady() const;
+    // One Larger than Life step of bindGroup (table rows, table columns, then the cells), inside an open compute pass
+    void dispatchLtl(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup);
+    // Throws Engine::ConfigurationError when the rules cannot run together or with topology kind
+    static void validateRules(const LtlRule& rule, const std::optional<LeniaRule>& leniaRule,
+                              const std::optional<LatticeRule>& latticeRule,
+                              const std::optional<VoxelRule>& voxelRule, Topology::Kind kind);
+    // CONTINUOUS for the variants that draw or write cell states (render and editMain)
+    PipelineCache::Constants getStateConstants() const;
+    // getStateConstants and the LATTICE the render variant draws
+    PipelineCache::Constants getRenderConstants() const;
+    // hexMain or triangleMain specialized for the current lattice rule (and topology)
+    void requestLatticePipeline();
+    // First vertex and vertex count of the current lattice's shape in vertexBuffer
+    std::pair<uint32_t, uint32_t> getLatticeVertices() const;
+    // The render variant of the current mode: the cells of the board, or the raymarched volume
+    void requestRenderPipeline();
+    // voxelMain, voxelMipMain and voxelHashMain specialized for the current 3D rule
+    void requestVoxelPipelines();
+    bool isVoxelReady() const;
+    // One 3D step of bindGroup and the occupancy mip of its output, inside an open compute pass
+    void dispatchVoxel(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup);
+    // Camera of the current view and surface aspect into voxelCameraBuffer
+    void writeVoxelCamera();
+    // leniaMain specialized for the current Lenia rule and topology
+    void requestLeniaPipeline();
+    // One Lenia step of bindGroup, inside an open compute pass
+    void dispatchLenia(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup);
+    void uploadLeniaKernel();
+    // Fills the halo of the buffer bindGroup writes, inside an open compute pass
+    void dispatchHalo(wgpu::ComputePassEncoder& pass, const wgpu::BindGroup& bindGroup);
+    // Packs the input board of bindGroup for HistoryRecorder to record as generation (after the encoder is submitted).
+    // Returns false when no readback is free and the generation is skipped
+    bool encodeRecord(wgpu::CommandEncoder& encoder, const wgpu::BindGroup& bindGroup);
+    // Expands the board HistoryRecorder uploaded into the current generation as generation, for seeking and streaming
+    void unpackUploadedBoard(uint64_t generation);
+    void showStreamedBoard();
+    // The bind group whose output buffer holds the generation about to be stepped (and drawn)
+    const wgpu::BindGroup& getCurrentGenerationBindGroup() const;
+    // The bind group that steps the current generation, it reads the board as its input (the render pass and
+    // packMain read through it too)
+    const wgpu::BindGroup& getSteppingBindGroup() const;
+    // The draw of the render pass with the board bindGroup reads, for a render pass or a RenderBundle
+    template <typename RenderEncoder>
+    void encodeDraw(const RenderEncoder& encoder, const wgpu::BindGroup& bindGroup) const;
+    void createRenderBundles();
     void createVertexBuffer();
     void createUniformBuffer();
+    void createSeedBuffer();
     void createStorageBuffers();
     void createBindGroupLayout();
     void createBindGroup();
     void cleanup();
     bool shouldUpdateCells();
+    // CPU twin of seedMain and haloMain for the current seed and topology, used while those are still compiling
+    void uploadSeededBoard();
+    // LeniaEngine::makeSoup of the current seed and density as f32 states, halo included
+    void uploadLeniaSoup();
+    // VoxelVolume::makeSoup of the current seed and density, with its occupancy mip
+    void uploadVoxelSoup();
 
 public:
     class InitializationError : public std::runtime_error {
@@ -81,24 +340,133 @@ public:
             RuntimeError(const std::string& msg) 
                 : std::runtime_error("Encountered an unexpected runtime error: " + msg) {}
     };
+    // Surface-less Life for native builds: frames go to an offscreen texture (or nowhere), see tools/gpu.cpp
+    struct Headless {
+        uint32_t width = 512;
+        uint32_t height = 512;
+        // No render pass at all, only the compute passes
+        bool computeOnly = false;
+        // Ask for the fallback adapter (a software rasterizer like lavapipe or SwiftShader)
+        bool softwareAdapter = false;
+    };
+
+    // Seeds from std::random_device
     Life();
+    // The same seed gives the same board on every platform (and as Grid::fillRandom on the CPU).
+    // Returns right away: the adapter and device are requested asynchronously and everything else is created from
+    // their callbacks, so startup needs no ASYNCIFY. Only renderFrame, setTopology, setRule, setLeniaRule,
+    // setLatticeRule, setVoxelRule, setVoxelView and setHaltOnCycle may be called before isReady
+    Life(uint64_t seed, double density);
+    Life(uint64_t seed, double density, const Headless& headless);
     ~Life();
 
+    bool isReady() const { return ready; }
+    bool hasStartupFailed() const { return startupFailed; }
+    // Called once the device and resources exist (right away when they already do)
+    void setOnReady(ReadyCallback callback);
+    // Page time (ms since navigation start) a milestone was reached at, -1 until then
+    double getStartupMs(StartupMilestone milestone) const { return startupMs[static_cast<uint32_t>(milestone)]; }
+
     const wgpu::Instance& getInstance() const { return instance; }
     const wgpu::Adapter& getAdapter() const { return adapter; }
     const wgpu::Device& getDevice() const { return device; }
     const wgpu::Queue& getQueue() const { return queue; }
     const wgpu::Surface& getSurface() const { return surface; }
     const wgpu::SurfaceConfiguration& getSurfaceConfig() const { return surfaceConfig; }
-    const wgpu::RenderPipeline& getRenderPipeline() const { return renderPipeline; }
-    const wgpu::ComputePipeline& getSimulationPipeline() const { return simulationPipeline; }
+    // RGBA8Unorm render target of a headless Life, null otherwise
+    const wgpu::Texture& getOffscreenTexture() const { return offscreenTexture; }
+    // Buffer holding the padded board of the current generation (GRID_SIZE + 2 squared u32 cells, halo included), or
+    // the volume's bricks (VoxelVolume's layout) with a 3D rule
+    const wgpu::Buffer& getCurrentGenerationBuffer() const { return step % 2 == 0 ? cellBuffers.read : cellBuffers.write; }
+    wgpu::RenderPipeline getRenderPipeline() const { return pipelineCache->getRender(renderPipelineKey); }
+    wgpu::ComputePipeline getSimulationPipeline() const { return pipelineCache->getCompute(simulationPipelineKey); }
+    const PipelineCache& getPipelineCache() const { return *pipelineCache; }
     const wgpu::Buffer& getVertexBuffer() const { return vertexBuffer; }
     const wgpu::Buffer& getUniformBuffer() const { return uniformBuffer; }
     const wgpu::BindGroupLayout& getBindGroupLayout() const { return bindGroupLayout; }
     const wgpu::BindGroup& getBindGroup() const { return bindGroup; }
+    const GpuTimer& getGpuTimer() const { return *gpuTimer; }
+    const PeriodMonitor& getPeriodMonitor() const { return *periodMonitor; }
+    // Edits are applied at the start of the next frame, even while the board is halted or between steps
+    CellEditor& getCellEditor() { return *cellEditor; }
+    static constexpr int getGridSize() { return GRID_SIZE; }
+    static constexpr int getPaddedSize() { return PADDED_SIZE; }
+    static constexpr uint32_t getVoxelSize() { return VOXEL_SIZE; }
     void renderFrame();
     void handleResize();
+    // Refills the board on the GPU (seedMain in shader.wgsl) and restarts at generation 0
+    void seed(uint64_t seed, double density);
+    uint64_t getSeed() const { return boardSeed; }
+    double getDensity() const { return boardDensity; }
+    void setHaltOnCycle(bool halt) { haltOnCycle = halt; }
+    // True while stepping is stopped because the board repeats
+    bool isHalted() const { return haltOnCycle && periodMonitor->getCycle().has_value(); }
+    // Whether the steps of a board that changed no cell in a generation (PeriodMonitor::getStillGeneration) only
+    // advance the generation, without any GPU work (on by default, tools/gpu.cpp turns it off to time every step)
+    void setSkipStillSteps(bool skip) { skipStillSteps = skip; }
+    // True while steps cost nothing because the board stopped changing (also with setHaltOnCycle(false))
+    bool isStill() const { return skipStillSteps && periodMonitor->getStillGeneration().has_value(); }
+    // True when renderFrame does nothing at all until something from outside changes the board, the view or the
+    // pause state (an edit, seek, resize, stream message, ...). The page stops its main loop then, see main.cpp.
+    // Still boards are not idle, their steps cost no GPU work but still move the generation on
+    bool isIdle() const;
+    // Changes how the board edges are glued and restarts period detection. The current halo is refilled before the
+    // next step, once the topology's haloMain variant is built. Throws Engine::ConfigurationError when the board
+    // cannot have the topology
+    void setTopology(Topology::Kind kind);
+    Topology::Kind getTopology() const { return topology; }
+    // Switches the rule the board is stepped with, keeping the board. Stepping waits until the rule's pipeline
+    // variants are built. Larger than Life rules only run on the torus and the plane, anything else throws
+    // Engine::ConfigurationError (and so does setTopology while such a rule is in use)
+    void setRule(const LtlRule& rule);
+    const LtlRule& getRule() const { return rule; }
+    // Switches to Lenia (continuous states, drawn through a colormap) or back to the binary rules with nullopt, and
+    // reseeds the board either way, with LeniaEngine::makeSoup for Lenia. Continuous boards are not recorded for
+    // rewinding and take no stream messages. Torus and plane only, like setRule
+    void setLeniaRule(const std::optional<LeniaRule>& rule);
+    const std::optional<LeniaRule>& getLeniaRule() const { return leniaRule; }
+    // Switches to a hexagonal or triangular lattice (drawn as hexagons or triangles) or back to the square one with
+    // nullopt, keeping the board: the cells are reread in the new lattice. Not with Lenia or a Larger than Life rule,
+    // and like them torus and plane only. Lattice boards take no stream messages, life_serve streams square boards
+    void setLatticeRule(const std::optional<LatticeRule>& rule);
+    const std::optional<LatticeRule>& getLatticeRule() const { return latticeRule; }
+    // Switches to 3D Life on a VOXEL_SIZE^3 torus (raymarched through the occupancy mip instead of drawing the board)
+    // or back to the board with nullopt, and reseeds either way, with VoxelVolume::makeSoup for a volume. Volumes are
+    // not edited, recorded for rewinding or streamed. Not with the other rule kinds, and the torus only
+    void setVoxelRule(const std::optional<VoxelRule>& rule);
+    const std::optional<VoxelRule>& getVoxelRule() const { return voxelRule; }
+    // Orbits the voxel camera: yaw around the volume's z axis, pitch above its middle plane (clamped short of the
+    // poles) and distance from its middle in volume sides (at least 0.1). Drawn on the next frame
+    void setVoxelView(float yaw, float pitch, float distance);
+    uint64_t getGeneration() const { return step; }
+    // Rewind history of the generations shown so far (recorded a frame or two behind the simulation)
+    const History& getHistory() const { return historyRecorder->getHistory(); }
+    // Replaces the board with a recorded generation, which is drawn on the next frame. Stepping or editing from there
+    // forks the timeline (later generations are forgotten). Returns false when generation is not in the history,
+    // or while unpackMain is still compiling
+    bool seekGeneration(uint64_t generation);
+    void setPaused(bool pause) { paused = pause; }
+    bool isPaused() const { return paused; }
+    // Steps generations more on the next frame (all in one batch), also while paused (not while halted)
+    void requestStep(uint32_t generations = 1) { requestedSteps += generations; }
+    // Generations each update steps, in one compute pass (1 by default, index.html ?steps=)
+    void setStepsPerFrame(uint32_t steps) { stepsPerFrame = std::max(steps, 1u); }
+    uint32_t getStepsPerFrame() const { return stepsPerFrame; }
+    // Replays the render pass draw from a RenderBundle per ping-pong parity (on by default), or encodes it every frame
+    // (compare GpuTimer::Pass::Encode, life_gpu --direct-render)
+    void setUseRenderBundles(bool use) { useRenderBundles = use; }
+    // Applies one DeltaStream message from life_serve (a GRID_SIZE x GRID_SIZE window). The first board that decodes
+    // stops local stepping for good, from then on the board only changes with the stream and is drawn on the next
+    // frame. Returns false when the message does not apply (or the board is continuous or not on the square
+    // lattice), the stream then waits for the next keyframe
+    bool receiveStreamMessage(const uint8_t* data, size_t size);
+    // The connection dropped, only a keyframe is taken from the next one
+    void resetStream();
+    bool isStreaming() const { return streaming; }
 
+private:
+    // Declared after StartupMilestone, indexed by it
+    std::array<double, STARTUP_MILESTONE_COUNT> startupMs {};
+    std::optional<Headless> headless;
 };
 
-
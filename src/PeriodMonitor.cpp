@@ -0,0 +1,100 @@
+#include "PeriodMonitor.h"
+
+PeriodMonitor::PeriodMonitor(wgpu::Device device)
+{
+    wgpu::BufferDescriptor summaryDesc {};
+    summaryDesc.setDefault();
+    summaryDesc.label = "Board summary";
+    summaryDesc.size = SUMMARY_SIZE;
+    summaryDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    summaryBuffer = device.createBuffer(summaryDesc);
+
+    wgpu::BufferDescriptor readbackDesc {};
+    readbackDesc.setDefault();
+    readbackDesc.label = "Board summary readback";
+    readbackDesc.size = SUMMARY_SIZE;
+    readbackDesc.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+    for (auto& readback : readbacks) {
+        readback.buffer = device.createBuffer(readbackDesc);
+    }
+}
+
+PeriodMonitor::~PeriodMonitor()
+{
+    for (auto& readback : readbacks) {
+        if (readback.buffer) readback.buffer.release();
+    }
+    if (summaryBuffer) summaryBuffer.release();
+}
+
+bool PeriodMonitor::beginFrame(const wgpu::CommandEncoder& encoder)
+{
+    activeReadback = -1;
+    for (uint32_t i = 0; i < READBACK_COUNT; i++) {
+        if (!readbacks[i].busy) {
+            activeReadback = static_cast<int>(i);
+            encoder.clearBuffer(summaryBuffer, 0, SUMMARY_SIZE);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PeriodMonitor::resolve(const wgpu::CommandEncoder& encoder)
+{
+    if (activeReadback < 0) return;
+    encoder.copyBufferToBuffer(summaryBuffer, 0, readbacks[activeReadback].buffer, 0, SUMMARY_SIZE);
+}
+
+void PeriodMonitor::afterSubmit(uint64_t generation)
+{
+    if (activeReadback < 0) return;
+    const uint32_t readbackIndex = static_cast<uint32_t>(activeReadback);
+    Readback& readback = readbacks[readbackIndex];
+    readback.busy = true;
+    readback.generation = generation;
+    readback.epoch = epoch;
+    readback.mapCallback = readback.buffer.mapAsync(wgpu::MapMode::Read, 0, SUMMARY_SIZE,
+        [this, readbackIndex](wgpu::BufferMapAsyncStatus status) {
+            if (status == wgpu::BufferMapAsyncStatus::Success) {
+                readSummary(readbackIndex);
+            } else {
+                readbacks[readbackIndex].busy = false;
+            }
+        });
+    activeReadback = -1;
+}
+
+void PeriodMonitor::readSummary(uint32_t readbackIndex)
+{
+    Readback& readback = readbacks[readbackIndex];
+    const auto* summary = static_cast<const uint32_t*>(readback.buffer.getConstMappedRange(0, SUMMARY_SIZE));
+    // The count covers every generation since the previous readback, so zero is still exact after a skipped one
+    if (summary && readback.epoch == epoch && !stillGeneration && summary[2] == 0) {
+        stillGeneration = readback.generation;
+    }
+    if (summary && readback.epoch == epoch && !detector.getCycle()) {
+        const uint64_t hash = static_cast<uint64_t>(summary[1]) << 32 | summary[0];
+        // Hashes are compared at a fixed stride (the generations stepped per frame). A frame stepping another count,
+        // or one without a free readback, breaks it, so start over then
+        if (lastGeneration) {
+            const uint64_t stride = readback.generation - *lastGeneration;
+            if (lastStride && stride != *lastStride) detector.reset();
+            lastStride = stride;
+        }
+        lastGeneration = readback.generation;
+        // A cycle found here is kept in the detector for getCycle, the page's HUD and life_gpu report it
+        detector.observe(readback.generation, hash);
+    }
+    readback.buffer.unmap();
+    readback.busy = false;
+}
+
+void PeriodMonitor::reset()
+{
+    epoch++;
+    lastGeneration.reset();
+    lastStride.reset();
+    detector.reset();
+    stillGeneration.reset();
+}
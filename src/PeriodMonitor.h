@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include "webgpu.hpp"
+#include "PeriodDetector.h"
+
+// Watches the GPU board for a repeated state so Life can stop stepping dead or periodic boards.
+// hashMain (shader.wgsl) XORs a 64-bit Zobrist key per live cell into a small storage buffer after each step, and
+// computeMain counts the cells it changed into the same buffer. The buffer is copied to one of a few readback buffers
+// and fed to a PeriodDetector once the map completes, a zero count marks the board still (exactly, unlike a hash).
+// Readbacks trail the simulation by a frame or two, which is harmless since a repeating board keeps repeating
+class PeriodMonitor
+{
+private:
+    struct Readback {
+        wgpu::Buffer buffer{nullptr};
+        bool busy = false;
+        uint64_t generation = 0;
+        uint64_t epoch = 0;
+        std::unique_ptr<wgpu::BufferMapCallback> mapCallback;
+    };
+
+    // Mirrors BoardSummary in shader.wgsl (two u32 hash halves, then the changed cell count)
+    static constexpr uint64_t SUMMARY_SIZE = 3 * sizeof(uint32_t);
+    static constexpr uint32_t READBACK_COUNT = 4;
+
+    wgpu::Buffer summaryBuffer{nullptr};
+    std::array<Readback, READBACK_COUNT> readbacks;
+    int activeReadback = -1;
+    // Bumped by reset, readbacks still in flight for the previous board are dropped
+    uint64_t epoch = 0;
+    std::optional<uint64_t> lastGeneration;
+    // Generations between the last two readbacks
+    std::optional<uint64_t> lastStride;
+    PeriodDetector detector;
+    std::optional<uint64_t> stillGeneration;
+
+    void readSummary(uint32_t readbackIndex);
+
+public:
+    // Pending map callbacks point back at the monitor, so it is neither copyable nor movable
+    explicit PeriodMonitor(wgpu::Device device);
+    ~PeriodMonitor();
+    PeriodMonitor(const PeriodMonitor&) = delete;
+    PeriodMonitor& operator=(const PeriodMonitor&) = delete;
+
+    // Bound as binding 4 of the cell bind groups
+    const wgpu::Buffer& getSummaryBuffer() const { return summaryBuffer; }
+    static constexpr uint64_t getSummarySize() { return SUMMARY_SIZE; }
+
+    // Picks a free readback and clears the hash and the changed cell count, call before the compute pass.
+    // Returns false when every readback is busy, the frame's generation is then not hashed and its changes count
+    // towards the next generation that is
+    bool beginFrame(const wgpu::CommandEncoder& encoder);
+    // Copies the summary to the readback picked by beginFrame, call after the hash pass
+    void resolve(const wgpu::CommandEncoder& encoder);
+    // Starts the asynchronous readback of generation's summary, call right after queue.submit
+    void afterSubmit(uint64_t generation);
+
+    // Forget every hash, call whenever the board is replaced
+    void reset();
+    // The period is a multiple of the board's when several generations are stepped per frame (only every stride-th
+    // generation is hashed), which still halts the board at the right place
+    const std::optional<PeriodDetector::Cycle>& getCycle() const { return detector.getCycle(); }
+    // First generation seen to change no cell, every later one is the same board. Unset while the board changes
+    const std::optional<uint64_t>& getStillGeneration() const { return stillGeneration; }
+};
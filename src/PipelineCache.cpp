@@ -0,0 +1,225 @@
+#include "PipelineCache.h"
+#include "Shader.h"
+#include "Trace.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+double nowMs()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a, the source hash only has to tell shader revisions apart
+uint64_t hashSource(std::string_view source)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char c : source) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::vector<wgpu::ConstantEntry> makeConstantEntries(const PipelineCache::Constants& constants)
+{
+    std::vector<wgpu::ConstantEntry> entries;
+    for (const auto& [name, value] : constants) {
+        wgpu::ConstantEntry entry {};
+        entry.setDefault();
+        entry.key = name.c_str();
+        entry.value = value;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+}
+
+PipelineCache::PipelineCache(wgpu::Device device, const wgpu::BindGroupLayout& bindGroupLayout,
+                             std::string_view source)
+    : device(device)
+    , sourceHash(hashSource(source))
+{
+    module = Shader::createFromCode(device, source);
+    if (!module) throw PipelineError("cannot create the shader module");
+
+    wgpu::PipelineLayoutDescriptor layoutDesc {};
+    layoutDesc.setDefault();
+    layoutDesc.bindGroupLayoutCount = 1;
+    layoutDesc.bindGroupLayouts = reinterpret_cast<const WGPUBindGroupLayout*>(&bindGroupLayout);
+    pipelineLayout = device.createPipelineLayout(layoutDesc);
+    if (!pipelineLayout) throw PipelineError("cannot create the pipeline layout");
+}
+
+PipelineCache::~PipelineCache()
+{
+    for (auto& [key, variant] : variants) {
+        if (variant.computePipeline) variant.computePipeline.release();
+        if (variant.renderPipeline) variant.renderPipeline.release();
+    }
+    if (pipelineLayout) pipelineLayout.release();
+    if (module) module.release();
+}
+
+std::string PipelineCache::makeKey(const std::string& kind, const std::string& entryPoints,
+                                   const Constants& constants) const
+{
+    std::ostringstream key;
+    key << kind << ':' << entryPoints;
+    // Every digit of the constants: variants that differ past the default 6 significant digits (rule masks up to
+    // 2^27, Lenia's growth parameters) must not share a key
+    key << std::setprecision(std::numeric_limits<double>::max_digits10);
+    char separator = '|';
+    for (const auto& [name, value] : constants) {
+        key << separator << name << '=' << value;
+        separator = ',';
+    }
+    key << '@' << std::hex << std::setw(16) << std::setfill('0') << sourceHash;
+    return key.str();
+}
+
+std::string PipelineCache::requestCompute(const std::string& entryPoint, const Constants& constants)
+{
+    const std::string key = makeKey("compute", entryPoint, constants);
+    auto [it, inserted] = variants.try_emplace(key);
+    if (!inserted) {
+        hits++;
+        return key;
+    }
+    TRACE_SCOPE("PipelineCache::requestCompute");
+    Variant& variant = it->second;
+    variant.requestedMs = nowMs();
+
+    // Descriptors are copied when the call is made, only the callback has to outlive it
+    const std::vector<wgpu::ConstantEntry> constantEntries = makeConstantEntries(constants);
+    wgpu::ComputePipelineDescriptor pipelineDesc {};
+    pipelineDesc.setDefault();
+    pipelineDesc.label = entryPoint.c_str();
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.compute.module = module;
+    pipelineDesc.compute.entryPoint = entryPoint.c_str();
+    pipelineDesc.compute.constantCount = constantEntries.size();
+    pipelineDesc.compute.constants = constantEntries.data();
+#ifdef __EMSCRIPTEN__
+    variant.computeCallback = device.createComputePipelineAsync(pipelineDesc,
+        [this, &variant, key](wgpu::CreatePipelineAsyncStatus status, wgpu::ComputePipeline pipeline, const char* message) {
+            const bool success = status == wgpu::CreatePipelineAsyncStatus::Success && pipeline;
+            if (success) variant.computePipeline = pipeline;
+            finish(variant, key, message, success);
+        });
+#else
+    // wgpu-native has no createComputePipelineAsync, native variants are built in place (errors go to the device)
+    variant.computePipeline = device.createComputePipeline(pipelineDesc);
+    finish(variant, key, nullptr, variant.computePipeline);
+#endif
+    return key;
+}
+
+std::string PipelineCache::requestRender(const std::string& vertexEntryPoint, const std::string& fragmentEntryPoint,
+                                         wgpu::TextureFormat format, const Constants& constants)
+{
+    const std::string key = makeKey("render", vertexEntryPoint + "+" + fragmentEntryPoint + "/" +
+                                    std::to_string(static_cast<uint32_t>(static_cast<WGPUTextureFormat>(format))),
+                                    constants);
+    auto [it, inserted] = variants.try_emplace(key);
+    if (!inserted) {
+        hits++;
+        return key;
+    }
+    TRACE_SCOPE("PipelineCache::requestRender");
+    Variant& variant = it->second;
+    variant.requestedMs = nowMs();
+
+    const std::vector<wgpu::ConstantEntry> constantEntries = makeConstantEntries(constants);
+
+    wgpu::VertexAttribute vertexAttribute {};
+    vertexAttribute.setDefault();
+    vertexAttribute.format = wgpu::VertexFormat::Float32x2;
+    vertexAttribute.offset = 0;
+    vertexAttribute.shaderLocation = 0;
+
+    wgpu::VertexBufferLayout vertexBufferLayout {};
+    vertexBufferLayout.setDefault();
+    vertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
+    vertexBufferLayout.arrayStride = 8;
+    vertexBufferLayout.attributeCount = 1;
+    vertexBufferLayout.attributes = &vertexAttribute;
+
+    wgpu::RenderPipelineDescriptor pipelineDesc {};
+    pipelineDesc.setDefault();
+    pipelineDesc.label = "Cell pipeline";
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.vertex.module = module;
+    pipelineDesc.vertex.entryPoint = vertexEntryPoint.c_str();
+    pipelineDesc.vertex.constantCount = constantEntries.size();
+    pipelineDesc.vertex.constants = constantEntries.data();
+    pipelineDesc.vertex.bufferCount = 1;
+    pipelineDesc.vertex.buffers = &vertexBufferLayout;
+
+    wgpu::ColorTargetState colorTarget {};
+    colorTarget.setDefault();
+    colorTarget.format = format;
+    colorTarget.writeMask = wgpu::ColorWriteMask::All;
+
+    wgpu::FragmentState fragmentState {};
+    fragmentState.setDefault();
+    fragmentState.module = module;
+    fragmentState.entryPoint = fragmentEntryPoint.c_str();
+    fragmentState.constantCount = constantEntries.size();
+    fragmentState.constants = constantEntries.data();
+    fragmentState.targetCount = 1;
+    fragmentState.targets = &colorTarget;
+    pipelineDesc.fragment = &fragmentState;
+
+#ifdef __EMSCRIPTEN__
+    variant.renderCallback = device.createRenderPipelineAsync(pipelineDesc,
+        [this, &variant, key](wgpu::CreatePipelineAsyncStatus status, wgpu::RenderPipeline pipeline, const char* message) {
+            const bool success = status == wgpu::CreatePipelineAsyncStatus::Success && pipeline;
+            if (success) variant.renderPipeline = pipeline;
+            finish(variant, key, message, success);
+        });
+#else
+    variant.renderPipeline = device.createRenderPipeline(pipelineDesc);
+    finish(variant, key, nullptr, variant.renderPipeline);
+#endif
+    return key;
+}
+
+void PipelineCache::finish(Variant& variant, const std::string& key, const char* message, bool success)
+{
+    variant.buildMs = nowMs() - variant.requestedMs;
+    if (success) {
+        variant.ready = true;
+    } else {
+        variant.error = key + ": " + (message ? message : "unknown error");
+        std::cerr << "Failed to create pipeline " << variant.error << std::endl;
+    }
+}
+
+bool PipelineCache::isReady(const std::string& key) const
+{
+    const auto it = variants.find(key);
+    return it != variants.end() && it->second.ready;
+}
+
+wgpu::ComputePipeline PipelineCache::getCompute(const std::string& key) const
+{
+    const auto it = variants.find(key);
+    return it != variants.end() && it->second.ready ? it->second.computePipeline : wgpu::ComputePipeline{nullptr};
+}
+
+wgpu::RenderPipeline PipelineCache::getRender(const std::string& key) const
+{
+    const auto it = variants.find(key);
+    return it != variants.end() && it->second.ready ? it->second.renderPipeline : wgpu::RenderPipeline{nullptr};
+}
+
+double PipelineCache::getBuildMs(const std::string& key) const
+{
+    const auto it = variants.find(key);
+    return it != variants.end() && it->second.ready ? it->second.buildMs : 0.0;
+}
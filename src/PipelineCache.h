@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "webgpu.hpp"
+
+// Registry of the pipeline variants built from one WGSL source: an entry point (two for render pipelines) plus its
+// override constants. Variants are created with createComputePipelineAsync/createRenderPipelineAsync, so all the ones
+// requested together compile in parallel, and are cached under a key of the entry points, constants and a hash of the
+// source. Only variants somebody asked for are built, so adding rules or topologies costs nothing until they are used.
+// Render variants use Life's vertex layout, one float32x2 position buffer at location 0
+class PipelineCache
+{
+public:
+    class PipelineError : public std::runtime_error {
+        public:
+            PipelineError(const std::string& msg)
+                : std::runtime_error("Failed to create pipeline: " + msg) {}
+    };
+
+    // Override constants by name, ordered so that equal sets make equal keys
+    using Constants = std::map<std::string, double>;
+
+private:
+    struct Variant {
+        wgpu::ComputePipeline computePipeline{nullptr};
+        wgpu::RenderPipeline renderPipeline{nullptr};
+        bool ready = false;
+        std::string error;
+        double requestedMs = 0.0;
+        double buildMs = 0.0;
+        std::unique_ptr<wgpu::CreateComputePipelineAsyncCallback> computeCallback;
+        std::unique_ptr<wgpu::CreateRenderPipelineAsyncCallback> renderCallback;
+    };
+
+    wgpu::Device device{nullptr};
+    wgpu::ShaderModule module{nullptr};
+    wgpu::PipelineLayout pipelineLayout{nullptr};
+    uint64_t sourceHash = 0;
+    // Node based, callbacks keep pointers to their variant
+    std::unordered_map<std::string, Variant> variants;
+    uint64_t hits = 0;
+
+    std::string makeKey(const std::string& kind, const std::string& entryPoints, const Constants& constants) const;
+    void finish(Variant& variant, const std::string& key, const char* message, bool success);
+
+public:
+    // source must stay NUL-terminated (see Shader::createFromCode)
+    PipelineCache(wgpu::Device device, const wgpu::BindGroupLayout& bindGroupLayout, std::string_view source);
+    ~PipelineCache();
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    uint64_t getSourceHash() const { return sourceHash; }
+    size_t getVariantCount() const { return variants.size(); }
+    // Requests answered from the cache instead of starting a build
+    uint64_t getHitCount() const { return hits; }
+
+    // Start building a variant unless it is cached or already building, and return its key
+    std::string requestCompute(const std::string& entryPoint, const Constants& constants = {});
+    std::string requestRender(const std::string& vertexEntryPoint, const std::string& fragmentEntryPoint,
+                              wgpu::TextureFormat format, const Constants& constants = {});
+
+    // Callbacks run from the browser's event loop, so a variant becomes ready between frames
+    bool isReady(const std::string& key) const;
+    // Null until the variant is built (or when it failed)
+    wgpu::ComputePipeline getCompute(const std::string& key) const;
+    wgpu::RenderPipeline getRender(const std::string& key) const;
+    // Milliseconds from request to pipeline, 0 while building
+    double getBuildMs(const std::string& key) const;
+};
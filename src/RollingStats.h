@@ -0,0 +1,36 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Fixed-size window of the most recent samples with percentile queries.
+// Pushing is O(1); percentiles sort a copy, so query them at UI rates rather than per frame
+template <size_t WINDOW>
+class RollingStats
+{
+private:
+    std::array<double, WINDOW> values {};
+    size_t count = 0;
+    size_t next = 0;
+
+public:
+    void push(double value)
+    {
+        values[next] = value;
+        next = (next + 1) % WINDOW;
+        count = std::min(count + 1, WINDOW);
+    }
+
+    size_t getCount() const { return count; }
+
+    // percentile in [0, 100], returns -1 while the window is empty
+    double percentile(double percentile) const
+    {
+        if (count == 0) return -1.0;
+        std::vector<double> sorted(values.begin(), values.begin() + count);
+        const size_t rank = std::min(count - 1, static_cast<size_t>(percentile / 100.0 * count));
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        return sorted[rank];
+    }
+};
@@ -1,13 +1,11 @@
 #pragma once
 
 #include "webgpu.hpp"
-#include <string>
+#include <string_view>
 
 class Shader {
 public:
-    static wgpu::ShaderModule loadModuleFromFile(wgpu::Device device, const std::string& filepath);
-    static wgpu::ShaderModule createFromCode(wgpu::Device device, const std::string& wgslCode);
-    
-private:
-    static std::string loadShaderCode(const std::string& filepath);
-};
\ No newline at end of file
+    // wgslCode must be NUL-terminated right after its end, as the EmbeddedShaders constants are
+    // (they view string literals), so the code is handed to WebGPU without a copy
+    static wgpu::ShaderModule createFromCode(wgpu::Device device, std::string_view wgslCode);
+};
@@ -0,0 +1,148 @@
+#include "Bitboard.h"
+#include "Engine.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+uint64_t reverseBits(uint64_t value)
+{
+    value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+    value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+    value = ((value >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+    value = ((value >> 8) & 0x00FF00FF00FF00FFull) | ((value & 0x00FF00FF00FF00FFull) << 8);
+    value = ((value >> 16) & 0x0000FFFF0000FFFFull) | ((value & 0x0000FFFF0000FFFFull) << 16);
+    return (value >> 32) | (value << 32);
+}
+
+// Interior of target becomes source mirrored left to right (cell x takes cell wordsPerRow * 64 - 1 - x)
+void mirrorRow(const uint64_t* source, uint64_t* target, uint32_t wordsPerRow)
+{
+    for (uint32_t w = 0; w < wordsPerRow; w++) {
+        target[w] = reverseBits(source[wordsPerRow - 1 - w]);
+    }
+}
+
+}
+
+Bitboard::Bitboard(uint32_t width, uint32_t height)
+    : width(width)
+    , height(height)
+    , wordsPerRow(width / BITS_PER_WORD)
+    , stride(width / BITS_PER_WORD + 2)
+{
+    if (width == 0 || width % BITS_PER_WORD != 0) {
+        throw Engine::ConfigurationError("packed boards need a width that is a multiple of 64");
+    }
+    if (height == 0) throw Engine::ConfigurationError("packed boards need a non-zero height");
+    words.assign(static_cast<size_t>(stride) * (height + 2), 0);
+    changedRows.assign(height, 1);
+}
+
+void Bitboard::fillHalo(Topology::Kind kind)
+{
+    // Same cells as Topology::haloSource, a word or a row at a time
+    uint64_t* top = row(-1);
+    uint64_t* bottom = row(height);
+    const uint64_t* first = row(0);
+    const uint64_t* last = row(height - 1);
+    switch (kind) {
+        case Topology::Kind::Torus:
+            // Ghost words first, so copying whole padded rows below also fills the corners
+            for (uint32_t y = 0; y < height; y++) {
+                uint64_t* r = row(y);
+                r[-1] = r[wordsPerRow - 1];
+                r[wordsPerRow] = r[0];
+            }
+            std::copy_n(last - 1, stride, top - 1);
+            std::copy_n(first - 1, stride, bottom - 1);
+            break;
+        case Topology::Kind::Plane:
+            for (uint32_t y = 0; y < height; y++) {
+                uint64_t* r = row(y);
+                r[-1] = 0;
+                r[wordsPerRow] = 0;
+            }
+            std::fill_n(top - 1, stride, 0);
+            std::fill_n(bottom - 1, stride, 0);
+            break;
+        case Topology::Kind::KleinBottle:
+            for (uint32_t y = 0; y < height; y++) {
+                uint64_t* r = row(y);
+                r[-1] = r[wordsPerRow - 1];
+                r[wordsPerRow] = r[0];
+            }
+            // The mirrored rows wrap around at the corners like any torus row
+            mirrorRow(last, top, wordsPerRow);
+            mirrorRow(first, bottom, wordsPerRow);
+            top[-1] = top[wordsPerRow - 1];
+            top[wordsPerRow] = top[0];
+            bottom[-1] = bottom[wordsPerRow - 1];
+            bottom[wordsPerRow] = bottom[0];
+            break;
+        case Topology::Kind::CrossSurface:
+            for (uint32_t y = 0; y < height; y++) {
+                uint64_t* r = row(y);
+                const uint64_t* opposite = row(height - 1 - y);
+                r[-1] = opposite[wordsPerRow - 1];
+                r[wordsPerRow] = opposite[0];
+            }
+            // Corners take the diagonally opposite corner cell, unmirrored
+            mirrorRow(last, top, wordsPerRow);
+            mirrorRow(first, bottom, wordsPerRow);
+            top[-1] = last[wordsPerRow - 1];
+            top[wordsPerRow] = last[0];
+            bottom[-1] = first[wordsPerRow - 1];
+            bottom[wordsPerRow] = first[0];
+            break;
+        case Topology::Kind::Sphere:
+            // Rows and columns swap, so the cells are gathered one at a time (width == height)
+            std::fill_n(top - 1, stride, 0);
+            std::fill_n(bottom - 1, stride, 0);
+            for (uint32_t i = 0; i < width; i++) {
+                const uint64_t bit = 1ull << (i % BITS_PER_WORD);
+                if (row(i)[0] & 1) top[i / BITS_PER_WORD] |= bit;
+                if (row(i)[wordsPerRow - 1] >> 63) bottom[i / BITS_PER_WORD] |= bit;
+            }
+            for (uint32_t y = 0; y < height; y++) {
+                uint64_t* r = row(y);
+                r[-1] = ((first[y / BITS_PER_WORD] >> (y % BITS_PER_WORD)) & 1) << 63;
+                r[wordsPerRow] = (last[y / BITS_PER_WORD] >> (y % BITS_PER_WORD)) & 1;
+            }
+            break;
+    }
+}
+
+void Bitboard::fromGrid(const Grid& grid)
+{
+    *this = Bitboard(grid.getWidth(), grid.getHeight());
+    for (uint32_t y = 0; y < height; y++) {
+        uint64_t* r = row(y);
+        for (uint32_t x = 0; x < width; x++) {
+            r[x / BITS_PER_WORD] |= static_cast<uint64_t>(grid.getCell(x, y) & 1) << (x % BITS_PER_WORD);
+        }
+    }
+}
+
+void Bitboard::toGrid(Grid& grid) const
+{
+    grid = Grid(width, height);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint64_t* r = row(y);
+        for (uint32_t x = 0; x < width; x++) {
+            grid.setCell(x, y, static_cast<uint8_t>((r[x / BITS_PER_WORD] >> (x % BITS_PER_WORD)) & 1));
+        }
+    }
+}
+
+uint64_t Bitboard::population() const
+{
+    uint64_t count = 0;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint64_t* r = row(y);
+        for (uint32_t w = 0; w < wordsPerRow; w++) {
+            count += std::popcount(r[w]);
+        }
+    }
+    return count;
+}
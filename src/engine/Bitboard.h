@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Grid.h"
+#include "Topology.h"
+
+// Bit-packed board, 64 cells per word (bit i of word w is cell x = w * 64 + i).
+// Every row carries one ghost word on each side and the board carries one ghost row above and below,
+// so the step kernels read neighbours without any wrap arithmetic. fillHalo refreshes the ghosts.
+class Bitboard
+{
+private:
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t wordsPerRow = 0;
+    uint32_t stride = 0;
+    std::vector<uint64_t> words;
+    std::vector<uint8_t> changedRows;
+
+public:
+    static constexpr uint32_t BITS_PER_WORD = 64;
+
+    Bitboard() = default;
+    // Throws Engine::ConfigurationError unless width is a multiple of BITS_PER_WORD
+    Bitboard(uint32_t width, uint32_t height);
+
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+    uint32_t getWordsPerRow() const { return wordsPerRow; }
+    uint32_t getStride() const { return stride; }
+
+    // Pointer to the first interior word of row y, valid for y in [-1, height]
+    uint64_t* row(int64_t y) { return words.data() + (y + 1) * stride + 1; }
+    const uint64_t* row(int64_t y) const { return words.data() + (y + 1) * stride + 1; }
+
+    // Whether row y differs from the board it was stepped from. The step kernels set it for free while
+    // writing the row, a fresh board reports every row as changed
+    bool isRowChanged(uint32_t y) const { return changedRows[y] != 0; }
+    void setRowChanged(uint32_t y, bool changed) { changedRows[y] = changed; }
+
+    // Fills the ghost words and rows from the interior as the topology glues the edges. Only the edge bit
+    // of a ghost word is ever read by the kernels
+    void fillHalo(Topology::Kind kind);
+    void fromGrid(const Grid& grid);
+    void toGrid(Grid& grid) const;
+    uint64_t population() const;
+
+    // Cell on the left/right of every bit, pulling the edge bit from the neighbouring word.
+    // Templated so the SIMD engine can run the same expressions on vector registers
+    template <typename T>
+    static T shiftWest(T center, T previous) { return (center << 1) | (previous >> 63); }
+    template <typename T>
+    static T shiftEast(T center, T next) { return (center >> 1) | (next << 63); }
+
+    // Bit-sliced Conway rule over 64 (or 64 * lanes) cells at once.
+    // Sums each row's three cells into 2-bit counts, adds them with a full adder,
+    // and keeps cells whose 3x3 total (including the cell itself) is 3, or 4 when alive
+    template <typename T>
+    static T evolve(T aboveWest, T above, T aboveEast,
+                    T west, T center, T east,
+                    T belowWest, T below, T belowEast)
+    {
+        const T above0 = aboveWest ^ above ^ aboveEast;
+        const T above1 = (aboveWest & above) | (aboveEast & (aboveWest ^ above));
+        const T middle0 = west ^ center ^ east;
+        const T middle1 = (west & center) | (east & (west ^ center));
+        const T below0 = belowWest ^ below ^ belowEast;
+        const T below1 = (belowWest & below) | (belowEast & (belowWest ^ below));
+
+        const T ones = above0 ^ middle0 ^ below0;
+        const T carry = (above0 & middle0) | (below0 & (above0 ^ middle0));
+
+        // Count of the four weight-2 bits (above1, below1, middle1, carry)
+        const T p = above1 ^ below1;
+        const T q = above1 & below1;
+        const T r = middle1 ^ carry;
+        const T s = middle1 & carry;
+        const T twosIsOne = (p ^ r) & ~(q | s);
+        const T twosIsTwo = (p & r) | ((q ^ s) & ~(p | r));
+
+        return (ones & twosIsOne) | (~ones & center & twosIsTwo);
+    }
+};
@@ -0,0 +1,51 @@
+#include "BitboardEngine.h"
+#include "StateHash.h"
+#include "Trace.h"
+#include <utility>
+
+uint64_t BitboardEngine::hashDelta()
+{
+    return StateHash::delta(current, next, 0, current.getHeight());
+}
+
+void BitboardEngine::load(const Grid& grid)
+{
+    Topology::validate(topology, grid.getWidth(), grid.getHeight());
+    current.fromGrid(grid);
+    next = Bitboard(grid.getWidth(), grid.getHeight());
+    if (hashTracking) hash = StateHash::ofBitboard(current);
+}
+
+void BitboardEngine::store(Grid& grid) const
+{
+    current.toGrid(grid);
+}
+
+void BitboardEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("BitboardEngine::step");
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        // The halo is a handful of words per row, serial even for the threaded engine
+        current.fillHalo(topology);
+        stepBoard();
+        if (hashTracking) hash ^= hashDelta();
+        std::swap(current, next);
+    }
+}
+
+uint64_t BitboardEngine::stateHash() const
+{
+    return hashTracking ? hash : StateHash::ofBitboard(current);
+}
+
+void BitboardEngine::setTopology(Topology::Kind kind)
+{
+    if (current.getWidth() > 0) Topology::validate(kind, current.getWidth(), current.getHeight());
+    topology = kind;
+}
+
+void BitboardEngine::setHashTracking(bool enabled)
+{
+    if (enabled && !hashTracking) hash = StateHash::ofBitboard(current);
+    hashTracking = enabled;
+}
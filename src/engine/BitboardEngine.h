@@ -0,0 +1,30 @@
+#pragma once
+#include "Engine.h"
+#include "Bitboard.h"
+
+// Shared state of the bit-packed engines: two boards that swap every generation, and an optional
+// incremental StateHash that only rehashes the rows the step kernels flagged as changed
+class BitboardEngine : public Engine
+{
+protected:
+    Bitboard current;
+    Bitboard next;
+    bool hashTracking = false;
+    uint64_t hash = 0;
+    Topology::Kind topology = Topology::Kind::Torus;
+
+    // Steps current into next, current already has its halo filled
+    virtual void stepBoard() = 0;
+    // StateHash::delta from current to next, ThreadedEngine splits it across its pool
+    virtual uint64_t hashDelta();
+
+public:
+    void load(const Grid& grid) override;
+    void store(Grid& grid) const override;
+    void step(uint32_t generations = 1) override;
+    uint64_t population() const override { return current.population(); }
+    uint64_t stateHash() const override;
+    void setHashTracking(bool enabled) override;
+    void setTopology(Topology::Kind kind) override;
+    Topology::Kind getTopology() const override { return topology; }
+};
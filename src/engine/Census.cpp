@@ -0,0 +1,63 @@
+#include "Census.h"
+#include <algorithm>
+#include <functional>
+
+Census::Shard& Census::shardFor(const std::string& apgcode)
+{
+    return shards[std::hash<std::string>{}(apgcode) % SHARD_COUNT];
+}
+
+void Census::add(const std::string& apgcode, uint64_t count)
+{
+    Shard& shard = shardFor(apgcode);
+    std::lock_guard<std::mutex> lock {shard.mutex};
+    shard.counts[apgcode] += count;
+}
+
+void Census::merge(const Counts& counts)
+{
+    // Group by shard first so each lock is taken once
+    std::array<std::vector<const Counts::value_type*>, SHARD_COUNT> grouped;
+    for (const auto& entry : counts) {
+        grouped[std::hash<std::string>{}(entry.first) % SHARD_COUNT].push_back(&entry);
+    }
+    for (size_t i = 0; i < SHARD_COUNT; i++) {
+        if (grouped[i].empty()) continue;
+        std::lock_guard<std::mutex> lock {shards[i].mutex};
+        for (const auto* entry : grouped[i]) {
+            shards[i].counts[entry->first] += entry->second;
+        }
+    }
+}
+
+std::vector<std::pair<std::string, uint64_t>> Census::sorted() const
+{
+    std::vector<std::pair<std::string, uint64_t>> entries;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock {shard.mutex};
+        entries.insert(entries.end(), shard.counts.begin(), shard.counts.end());
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return entries;
+}
+
+uint64_t Census::total() const
+{
+    uint64_t count = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock {shard.mutex};
+        for (const auto& entry : shard.counts) {
+            count += entry.second;
+        }
+    }
+    return count;
+}
+
+void Census::write(std::ostream& out) const
+{
+    for (const auto& [apgcode, count] : sorted()) {
+        out << apgcode << ' ' << count << '\n';
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Object counts by apgcode, shared by every soup search thread.
+// Codes are spread over independently locked shards, so threads merging at the same time rarely meet
+class Census
+{
+public:
+    using Counts = std::unordered_map<std::string, uint64_t>;
+
+private:
+    static constexpr size_t SHARD_COUNT = 32;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        Counts counts;
+    };
+    std::array<Shard, SHARD_COUNT> shards;
+
+    Shard& shardFor(const std::string& apgcode);
+
+public:
+    void add(const std::string& apgcode, uint64_t count = 1);
+    // Adds a thread's local counts (one lock per shard touched)
+    void merge(const Counts& counts);
+
+    // Every code with its count, most common first (ties alphabetical)
+    std::vector<std::pair<std::string, uint64_t>> sorted() const;
+    uint64_t total() const;
+    // One "apgcode count" line per object, in sorted() order
+    void write(std::ostream& out) const;
+};
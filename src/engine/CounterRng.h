@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+
+// Counter-based random cells: the state of cell i depends only on (seed, i), so boards can be filled
+// in any order, on any number of threads, or on the GPU, and always come out identical.
+// Only 32-bit integer ops are used per cell so that seedMain in shader.wgsl computes the same bits
+class CounterRng
+{
+public:
+    struct Key {
+        uint32_t lo;
+        uint32_t hi;
+    };
+
+    // SplitMix64 finalizer, spreads nearby seeds into unrelated keys (done once per board, on the CPU)
+    static constexpr Key makeKey(uint64_t seed)
+    {
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        return {static_cast<uint32_t>(z), static_cast<uint32_t>(z >> 32)};
+    }
+
+    // 32-bit avalanche mix (lowbias32), mirrors mix32 in shader.wgsl
+    static constexpr uint32_t mix(uint32_t value)
+    {
+        value ^= value >> 16;
+        value *= 0x7FEB352Du;
+        value ^= value >> 15;
+        value *= 0x846CA68Bu;
+        value ^= value >> 16;
+        return value;
+    }
+
+    // Mirrors cellRandom in shader.wgsl for index < 2^32, larger (CPU-only) boards fold in the high word
+    static constexpr uint32_t at(Key key, uint64_t index)
+    {
+        const uint32_t lo = static_cast<uint32_t>(index);
+        const uint32_t hi = static_cast<uint32_t>(index >> 32);
+        const uint32_t h = mix(lo ^ key.lo);
+        return mix((h + hi * 0x9E3779B9u) ^ key.hi);
+    }
+
+    // Cells are alive when at(key, index) < threshold. Density 1 saturates at 2^32 - 1
+    static constexpr uint32_t threshold(double density)
+    {
+        if (!(density > 0.0)) return 0;
+        if (density >= 1.0) return UINT32_MAX;
+        return static_cast<uint32_t>(density * 4294967296.0);
+    }
+};
@@ -0,0 +1,212 @@
+#include "Decomposition.h"
+#include "Bitboard.h"
+#include "CounterRng.h"
+#include "Engine.h"
+#include "SimdEngine.h"
+#include "StateHash.h"
+#include "Trace.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Local row r of a strip is board row firstRow - haloDepth + r (wrapping around the torus)
+void fillSoup(const Decomposition::Config& config, uint32_t firstRow, Bitboard& board)
+{
+    const CounterRng::Key key = CounterRng::makeKey(config.seed);
+    const uint32_t threshold = CounterRng::threshold(config.density);
+    for (uint32_t r = 0; r < board.getHeight(); r++) {
+        const uint64_t y = (static_cast<uint64_t>(firstRow) + config.height - config.haloDepth + r) % config.height;
+        uint64_t* row = board.row(r);
+        for (uint32_t w = 0; w < board.getWordsPerRow(); w++) {
+            uint64_t word = 0;
+            for (uint32_t bit = 0; bit < Bitboard::BITS_PER_WORD; bit++) {
+                const uint64_t index = y * config.width + w * Bitboard::BITS_PER_WORD + bit;
+                if (CounterRng::at(key, index) < threshold) word |= 1ull << bit;
+            }
+            row[w] = word;
+        }
+    }
+}
+
+void copyRowsOut(const Bitboard& board, uint32_t firstRow, uint32_t rowCount, uint64_t* slot)
+{
+    const uint32_t words = board.getWordsPerRow();
+    for (uint32_t r = 0; r < rowCount; r++) {
+        std::copy_n(board.row(firstRow + r), words, slot + static_cast<size_t>(r) * words);
+    }
+}
+
+void copyRowsIn(const uint64_t* slot, uint32_t firstRow, uint32_t rowCount, Bitboard& board)
+{
+    const uint32_t words = board.getWordsPerRow();
+    for (uint32_t r = 0; r < rowCount; r++) {
+        std::copy_n(slot + static_cast<size_t>(r) * words, words, board.row(firstRow + r));
+    }
+}
+
+}
+
+void Decomposition::validate(const Config& config)
+{
+    if (config.width == 0 || config.width % Bitboard::BITS_PER_WORD != 0) {
+        throw Engine::ConfigurationError("decomposed boards need a width that is a multiple of 64");
+    }
+    if (config.processes == 0) throw Engine::ConfigurationError("decomposition needs at least one process");
+    if (config.haloDepth == 0) throw Engine::ConfigurationError("the halo must be at least one row deep");
+    if (config.height / config.processes < 2 * config.haloDepth) {
+        throw Engine::ConfigurationError("strips of " + std::to_string(config.height / config.processes) +
+                                         " rows are too short for a halo of " + std::to_string(config.haloDepth) +
+                                         " (at least twice its depth)");
+    }
+}
+
+uint32_t Decomposition::getFirstRow(const Config& config, uint32_t strip)
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(config.height) * strip / config.processes);
+}
+
+void Decomposition::runStrip(const Config& config, HaloExchange& exchange, uint32_t strip)
+{
+    TRACE_SCOPE("Decomposition::runStrip");
+    const uint32_t firstRow = getFirstRow(config, strip);
+    const uint32_t rows = getFirstRow(config, strip + 1) - firstRow;
+    const uint32_t halo = config.haloDepth;
+    const uint32_t above = (strip + config.processes - 1) % config.processes;
+    const uint32_t below = (strip + 1) % config.processes;
+
+    Bitboard current(config.width, rows + 2 * halo);
+    Bitboard next(config.width, rows + 2 * halo);
+    fillSoup(config, firstRow, current);
+    exchange.markReady();
+    exchange.waitForStart();
+
+    HaloExchange::StripStats& stats = exchange.getStats(strip);
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t epoch = 0;
+    uint32_t remaining = config.generations;
+    while (remaining > 0) {
+        const uint32_t steps = std::min(halo, remaining);
+        remaining -= steps;
+        const auto computeStart = std::chrono::steady_clock::now();
+        for (uint32_t g = 0; g < steps; g++) {
+            // Only the ghost words (the horizontal wrap) matter, the strip's own ghost rows are never trusted
+            current.fillHalo(Topology::Kind::Torus);
+            if (g + 1 == steps && remaining > 0) {
+                // Only the own rows [halo, halo + rows) are left to compute. The edge rows go out first
+                SimdEngine::stepRows(current, next, halo, 2 * halo);
+                SimdEngine::stepRows(current, next, rows, rows + halo);
+                copyRowsOut(next, halo, halo, exchange.getSlot(strip, HaloExchange::Edge::Top, epoch + 1));
+                copyRowsOut(next, rows, halo, exchange.getSlot(strip, HaloExchange::Edge::Bottom, epoch + 1));
+                exchange.publish(strip, epoch + 1);
+                SimdEngine::stepRows(current, next, 2 * halo, rows);
+            } else {
+                SimdEngine::stepRows(current, next, g + 1, rows + 2 * halo - 1 - g);
+            }
+            std::swap(current, next);
+        }
+        stats.computeSeconds += secondsSince(computeStart);
+
+        if (remaining > 0) {
+            epoch++;
+            const auto waitStart = std::chrono::steady_clock::now();
+            exchange.waitFor(above, epoch);
+            exchange.waitFor(below, epoch);
+            stats.waitSeconds += secondsSince(waitStart);
+            copyRowsIn(exchange.getSlot(above, HaloExchange::Edge::Bottom, epoch), 0, halo, current);
+            copyRowsIn(exchange.getSlot(below, HaloExchange::Edge::Top, epoch), rows + halo, halo, current);
+            stats.exchanges++;
+        }
+    }
+    stats.elapsedSeconds = secondsSince(start);
+
+    const uint32_t words = current.getWordsPerRow();
+    for (uint32_t r = 0; r < rows; r++) {
+        const uint64_t* row = current.row(halo + r);
+        for (uint32_t w = 0; w < words; w++) {
+            stats.population += static_cast<uint64_t>(std::popcount(row[w]));
+            stats.stateHash ^= StateHash::wordKey(static_cast<uint64_t>(firstRow + r) * words + w, row[w]);
+        }
+    }
+}
+
+Decomposition::Result Decomposition::run(const Config& config)
+{
+    TRACE_SCOPE("Decomposition::run");
+    validate(config);
+    HaloExchange exchange(config.processes, config.width / Bitboard::BITS_PER_WORD, config.haloDepth);
+
+    std::vector<pid_t> workers;
+    bool failed = false;
+    std::string failure;
+    for (uint32_t strip = 0; strip < config.processes; strip++) {
+        const pid_t pid = fork();
+        if (pid < 0) {
+            failed = true;
+            failure = "fork: " + std::string(std::strerror(errno));
+            exchange.abort();
+            break;
+        }
+        if (pid == 0) {
+            int status = 0;
+            try {
+                runStrip(config, exchange, strip);
+            } catch (const std::exception& e) {
+                std::cerr << "Strip " << strip << ": " << e.what() << std::endl;
+                exchange.abort();
+                status = 1;
+            }
+            // Skip the parent's atexit handlers and static destructors
+            _exit(status);
+        }
+        workers.push_back(pid);
+    }
+
+    // Boards are filled in parallel and untimed, everyone starts together once they are
+    size_t finished = 0;
+    auto reap = [&](int options) {
+        int status = 0;
+        const pid_t pid = waitpid(-1, &status, options);
+        if (pid <= 0) return false;
+        finished++;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = true;
+            if (failure.empty()) failure = "a worker exited abnormally";
+            exchange.abort();
+        }
+        return true;
+    };
+    while (!failed && exchange.getReadyCount() < workers.size()) {
+        if (!reap(WNOHANG)) std::this_thread::yield();
+    }
+    exchange.start();
+    while (finished < workers.size() && reap(0)) {}
+    if (failed) throw HaloExchange::ExchangeError(failure);
+
+    Result result;
+    for (uint32_t strip = 0; strip < config.processes; strip++) {
+        const HaloExchange::StripStats& stats = exchange.getStats(strip);
+        result.seconds = std::max(result.seconds, stats.elapsedSeconds);
+        result.maxComputeSeconds = std::max(result.maxComputeSeconds, stats.computeSeconds);
+        result.maxWaitSeconds = std::max(result.maxWaitSeconds, stats.waitSeconds);
+        result.population += stats.population;
+        result.stateHash ^= stats.stateHash;
+        result.exchanges = stats.exchanges;
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include "HaloExchange.h"
+
+// A torus split into horizontal strips, each stepped by its own process (fork) with the SIMD kernel.
+// Every strip carries haloDepth rows of each neighbour above and below its own rows, so it can step haloDepth
+// generations on its own: each generation the rows it can trust shrink by one on both sides, and after haloDepth of
+// them only its own rows are left. Then the edge rows go to the neighbours through HaloExchange. Deeper halos trade
+// redundant rows (haloDepth per side and generation, on average) for fewer, larger exchanges.
+// The last generation of an epoch computes the edge rows first and publishes them before the interior, so
+// neighbours copy while the strip is still computing and waiting only covers real imbalance
+class Decomposition
+{
+public:
+    struct Config {
+        uint32_t width = 0;          // Multiple of 64
+        uint32_t height = 0;
+        uint32_t processes = 1;
+        uint32_t haloDepth = 1;      // Generations between exchanges, each strip needs at least 2 * haloDepth rows
+        uint32_t generations = 0;
+        uint64_t seed = 1;           // Soup as Grid::fillRandom, every strip fills its own rows and halos
+        double density = 0.5;
+    };
+
+    struct Result {
+        double seconds = 0.0;
+        // Slowest strip's time in the kernel and waiting on neighbours
+        double maxComputeSeconds = 0.0;
+        double maxWaitSeconds = 0.0;
+        uint32_t exchanges = 0;
+        uint64_t population = 0;
+        // StateHash of the final board, equal to Engine::stateHash of any engine that ran the same board
+        uint64_t stateHash = 0;
+    };
+
+    // Forks one worker per strip and waits for all of them. Throws Engine::ConfigurationError for boards that cannot
+    // be split this way and HaloExchange::ExchangeError when a worker fails
+    static Result run(const Config& config);
+    static void validate(const Config& config);
+    // Strip s owns the rows [getFirstRow(s), getFirstRow(s + 1))
+    static uint32_t getFirstRow(const Config& config, uint32_t strip);
+
+private:
+    // The work of one process
+    static void runStrip(const Config& config, HaloExchange& exchange, uint32_t strip);
+};
@@ -0,0 +1,65 @@
+#include "DeltaStream.h"
+#include "Trace.h"
+#include <algorithm>
+
+namespace {
+
+void writeHeader(DeltaStream::Kind kind, uint64_t generation, uint32_t width, uint32_t height, std::vector<uint8_t>& out)
+{
+    out.push_back(static_cast<uint8_t>(kind));
+    History::writeVarint(generation, out);
+    History::writeVarint(width, out);
+    History::writeVarint(height, out);
+}
+
+size_t getWordCount(uint32_t width, uint32_t height)
+{
+    return static_cast<size_t>((width + 63) / 64) * height;
+}
+
+}
+
+void DeltaStream::encodeKeyframe(uint64_t generation, uint32_t width, uint32_t height, const History::Words& board,
+                                 std::vector<uint8_t>& out)
+{
+    TRACE_SCOPE("DeltaStream::encodeKeyframe");
+    writeHeader(Kind::Keyframe, generation, width, height, out);
+    const History::Words empty(board.size(), 0);
+    History::encodeXor(empty, board, out);
+}
+
+void DeltaStream::encodeDelta(uint64_t generation, uint32_t width, uint32_t height, const History::Words& before,
+                              const History::Words& after, std::vector<uint8_t>& out)
+{
+    TRACE_SCOPE("DeltaStream::encodeDelta");
+    writeHeader(Kind::Delta, generation, width, height, out);
+    History::encodeXor(before, after, out);
+}
+
+DeltaStream::Decoder::Decoder(uint32_t width, uint32_t height)
+    : width(width)
+    , height(height)
+    , board(getWordCount(width, height), 0)
+{
+}
+
+bool DeltaStream::Decoder::apply(const uint8_t* data, size_t size)
+{
+    TRACE_SCOPE("DeltaStream::Decoder::apply");
+    if (size == 0) return synced = false;
+    const Kind kind = static_cast<Kind>(data[0]);
+    size_t position = 1;
+    const uint64_t messageGeneration = History::readVarint(data, size, position);
+    const uint64_t messageWidth = History::readVarint(data, size, position);
+    const uint64_t messageHeight = History::readVarint(data, size, position);
+    if (messageWidth != width || messageHeight != height) return synced = false;
+
+    if (kind == Kind::Keyframe) {
+        std::fill(board.begin(), board.end(), 0);
+    } else if (kind != Kind::Delta || !synced || messageGeneration != generation + 1) {
+        return synced = false;
+    }
+    if (!History::applyXor(data + position, size - position, board)) return synced = false;
+    generation = messageGeneration;
+    return synced = true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "History.h"
+
+// Wire format of a live board stream (life_serve to the page), one message per generation:
+//   kind byte ('K' keyframe or 'D' delta), then varints generation, width, height, then a History::encodeXor run list.
+// A keyframe is the board XOR an empty board, a delta the board XOR the previous generation's, so a message costs
+// bytes in proportion to the cells that changed and a still board sends a few header bytes per generation.
+// Boards are History::Words (the StateHash layout)
+class DeltaStream
+{
+public:
+    enum class Kind : uint8_t {
+        Keyframe = 'K',
+        Delta = 'D',
+    };
+
+    static void encodeKeyframe(uint64_t generation, uint32_t width, uint32_t height, const History::Words& board,
+                               std::vector<uint8_t>& out);
+    // before is the board of generation - 1
+    static void encodeDelta(uint64_t generation, uint32_t width, uint32_t height, const History::Words& before,
+                            const History::Words& after, std::vector<uint8_t>& out);
+
+    // Rebuilds the boards of one stream. A delta is only applied on top of the generation right before it
+    class Decoder
+    {
+    private:
+        uint32_t width = 0;
+        uint32_t height = 0;
+        History::Words board;
+        uint64_t generation = 0;
+        bool synced = false;
+
+    public:
+        Decoder(uint32_t width, uint32_t height);
+
+        // Applies one message. Returns false and waits for the next keyframe when the message is malformed, has another
+        // board size or does not follow the current generation
+        bool apply(const uint8_t* data, size_t size);
+        // Forgets the board, only a keyframe is accepted next (e.g. after reconnecting)
+        void reset() { synced = false; }
+
+        // True once a keyframe has been applied (and nothing has broken the chain since)
+        bool isSynced() const { return synced; }
+        uint64_t getGeneration() const { return generation; }
+        const History::Words& getBoard() const { return board; }
+        uint32_t getWidth() const { return width; }
+        uint32_t getHeight() const { return height; }
+    };
+};
@@ -0,0 +1,42 @@
+#include "Engine.h"
+#include "ScalarEngine.h"
+#include "PackedEngine.h"
+#include "SimdEngine.h"
+#include "ThreadedEngine.h"
+#include "TreeEngine.h"
+#include "SparseEngine.h"
+#include "LtlEngine.h"
+#include "StateHash.h"
+
+std::unique_ptr<Engine> Engine::create(std::string_view name, unsigned threads)
+{
+    if (name == "scalar") return std::make_unique<ScalarEngine>();
+    if (name == "packed") return std::make_unique<PackedEngine>();
+    if (name == "simd") return std::make_unique<SimdEngine>();
+    if (name == "threaded") return std::make_unique<ThreadedEngine>(threads);
+    if (name == "tree") return std::make_unique<TreeEngine>();
+    if (name == "sparse") return std::make_unique<SparseEngine>();
+    if (name == "ltl") return std::make_unique<LtlEngine>();
+    throw Engine::ConfigurationError("unknown engine '" + std::string(name) + "'");
+}
+
+const std::vector<std::string_view>& Engine::getEngineNames()
+{
+    static const std::vector<std::string_view> names = {"scalar", "packed", "simd", "threaded", "tree", "sparse", "ltl"};
+    return names;
+}
+
+void Engine::setTopology(Topology::Kind kind)
+{
+    if (kind != Topology::Kind::Torus) {
+        throw Engine::ConfigurationError(std::string(getName()) + " engine only supports the torus, not " +
+                                         std::string(Topology::getName(kind)));
+    }
+}
+
+uint64_t Engine::stateHash() const
+{
+    Grid grid;
+    store(grid);
+    return StateHash::ofGrid(grid);
+}
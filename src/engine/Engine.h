@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Grid.h"
+#include "Topology.h"
+
+// Headless (CPU) Game of Life engine.
+// Every engine simulates the same board as Life's computeMain (a torus unless setTopology says otherwise),
+// so results are comparable cell for cell
+class Engine
+{
+public:
+    class ConfigurationError : public std::runtime_error {
+        public:
+            ConfigurationError(const std::string& msg)
+                : std::runtime_error("Invalid engine configuration: " + msg) {}
+    };
+
+    virtual ~Engine() = default;
+
+    virtual std::string_view getName() const = 0;
+    // Number of worker threads used by step (1 for single-threaded engines)
+    virtual unsigned getThreadCount() const { return 1; }
+
+    // Replace the engine state with grid (also defines the board size)
+    virtual void load(const Grid& grid) = 0;
+    // Copy the current state out, grid is resized to the board size
+    virtual void store(Grid& grid) const = 0;
+    virtual void step(uint32_t generations = 1) = 0;
+    virtual uint64_t population() const = 0;
+
+    // StateHash of the current board, equal across engines for equal boards.
+    // The default stores the board and hashes every cell
+    virtual uint64_t stateHash() const;
+    // Ask the engine to keep stateHash() current while stepping (for per-generation cycle checks),
+    // engines without an incremental hash ignore it
+    virtual void setHashTracking(bool enabled) { (void)enabled; }
+
+    // How the board edges are glued, kept across load. The default only supports the torus and throws
+    // Engine::ConfigurationError for anything else
+    virtual void setTopology(Topology::Kind kind);
+    virtual Topology::Kind getTopology() const { return Topology::Kind::Torus; }
+    // False for an engine on an unbounded plane, its board only matches the others until cells reach an edge
+    virtual bool isBounded() const { return true; }
+
+    // Creates an engine by name (see getEngineNames), threads = 0 uses all hardware threads
+    static std::unique_ptr<Engine> create(std::string_view name, unsigned threads = 0);
+    static const std::vector<std::string_view>& getEngineNames();
+};
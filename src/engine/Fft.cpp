@@ -0,0 +1,170 @@
+#include "Fft.h"
+#include "Engine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace {
+
+std::vector<Fft::Complex> makeTwiddles(uint32_t n)
+{
+    std::vector<Fft::Complex> twiddles(n / 2);
+    for (uint32_t k = 0; k < n / 2; k++) {
+        const double angle = -2.0 * std::numbers::pi * k / n;
+        twiddles[k] = {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+    }
+    return twiddles;
+}
+
+std::vector<uint32_t> makeReversal(uint32_t n)
+{
+    uint32_t bits = 0;
+    while ((1u << bits) < n) bits++;
+    std::vector<uint32_t> reversal(n);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t reversed = 0;
+        for (uint32_t bit = 0; bit < bits; bit++) reversed |= ((i >> bit) & 1u) << (bits - 1 - bit);
+        reversal[i] = reversed;
+    }
+    return reversal;
+}
+
+// Complex product without the NaN and infinity recovery of operator* (a libgcc call per product unless -ffast-math)
+inline Fft::Complex multiply(Fft::Complex a, Fft::Complex b)
+{
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// Iterative Cooley-Tukey on n consecutive values. The inverse conjugates the twiddles and leaves the scaling to the caller
+void transformLine(Fft::Complex* line, uint32_t n, const std::vector<Fft::Complex>& twiddles,
+                   const std::vector<uint32_t>& reversal, bool inverse)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        if (i < reversal[i]) std::swap(line[i], line[reversal[i]]);
+    }
+    for (uint32_t length = 2; length <= n; length *= 2) {
+        const uint32_t half = length / 2;
+        const uint32_t stride = n / length;
+        for (uint32_t start = 0; start < n; start += length) {
+            for (uint32_t k = 0; k < half; k++) {
+                const Fft::Complex twiddle = inverse ? std::conj(twiddles[k * stride]) : twiddles[k * stride];
+                const Fft::Complex even = line[start + k];
+                const Fft::Complex odd = multiply(line[start + k + half], twiddle);
+                line[start + k] = even + odd;
+                line[start + k + half] = even - odd;
+            }
+        }
+    }
+}
+
+// The same butterflies down columns [begin, end) of a width-wide image, applied to whole row spans at once: every
+// butterfly shares its twiddle across the span, and the loads stay contiguous instead of striding a row per value
+void transformColumns(Fft::Complex* data, uint32_t width, uint32_t height, uint32_t begin, uint32_t end,
+                      const std::vector<Fft::Complex>& twiddles, const std::vector<uint32_t>& reversal, bool inverse)
+{
+    auto row = [&](uint32_t y) { return data + static_cast<size_t>(y) * width; };
+    for (uint32_t y = 0; y < height; y++) {
+        if (y < reversal[y]) std::swap_ranges(row(y) + begin, row(y) + end, row(reversal[y]) + begin);
+    }
+    for (uint32_t length = 2; length <= height; length *= 2) {
+        const uint32_t half = length / 2;
+        const uint32_t stride = height / length;
+        for (uint32_t start = 0; start < height; start += length) {
+            for (uint32_t k = 0; k < half; k++) {
+                const Fft::Complex twiddle = inverse ? std::conj(twiddles[k * stride]) : twiddles[k * stride];
+                Fft::Complex* evenRow = row(start + k);
+                Fft::Complex* oddRow = row(start + k + half);
+                for (uint32_t x = begin; x < end; x++) {
+                    const Fft::Complex even = evenRow[x];
+                    const Fft::Complex odd = multiply(oddRow[x], twiddle);
+                    evenRow[x] = even + odd;
+                    oddRow[x] = even - odd;
+                }
+            }
+        }
+    }
+}
+
+}
+
+Fft::Fft(uint32_t width, uint32_t height)
+    : width(width)
+    , height(height)
+{
+    if (!isPowerOfTwo(width) || !isPowerOfTwo(height) || width < 2) {
+        throw Engine::ConfigurationError("FFT sides must be powers of two (the width at least 2), not " +
+                                         std::to_string(width) + "x" + std::to_string(height));
+    }
+    rowTwiddles = makeTwiddles(width / 2);
+    columnTwiddles = makeTwiddles(height);
+    rowReversal = makeReversal(width / 2);
+    columnReversal = makeReversal(height);
+    realTwiddles.resize(width / 2 + 1);
+    for (uint32_t k = 0; k <= width / 2; k++) {
+        const double angle = -2.0 * std::numbers::pi * k / width;
+        realTwiddles[k] = {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+    }
+}
+
+void Fft::forward(const std::vector<float>& image, std::vector<Complex>& spectrum, ThreadPool& pool) const
+{
+    TRACE_SCOPE("Fft::forward");
+    const uint32_t half = width / 2;
+    const uint32_t spectrumWidth = getSpectrumWidth();
+    spectrum.resize(static_cast<size_t>(height) * spectrumWidth);
+    pool.parallelFor(height, [&](uint32_t begin, uint32_t end) {
+        std::vector<Complex> line(half);
+        for (uint32_t y = begin; y < end; y++) {
+            const float* row = &image[static_cast<size_t>(y) * width];
+            for (uint32_t n = 0; n < half; n++) line[n] = {row[2 * n], row[2 * n + 1]};
+            transformLine(line.data(), half, rowTwiddles, rowReversal, false);
+            // line = E + iO with E and O the spectra of the even and odd cells, row spectrum = E + W^k O
+            Complex* out = &spectrum[static_cast<size_t>(y) * spectrumWidth];
+            for (uint32_t k = 0; k <= half; k++) {
+                const Complex z = line[k % half];
+                const Complex mirror = std::conj(line[(half - k) % half]);
+                const Complex even = (z + mirror) * 0.5f;
+                const Complex odd = multiply(z - mirror, {0.0f, -0.5f});
+                out[k] = even + multiply(realTwiddles[k], odd);
+            }
+        }
+    });
+    pool.parallelFor(spectrumWidth, [&](uint32_t begin, uint32_t end) {
+        transformColumns(spectrum.data(), spectrumWidth, height, begin, end, columnTwiddles, columnReversal, false);
+    });
+}
+
+void Fft::inverse(std::vector<Complex>& spectrum, std::vector<float>& image, ThreadPool& pool) const
+{
+    TRACE_SCOPE("Fft::inverse");
+    const uint32_t half = width / 2;
+    const uint32_t spectrumWidth = getSpectrumWidth();
+    pool.parallelFor(spectrumWidth, [&](uint32_t begin, uint32_t end) {
+        transformColumns(spectrum.data(), spectrumWidth, height, begin, end, columnTwiddles, columnReversal, true);
+    });
+    image.resize(static_cast<size_t>(width) * height);
+    // 1 / height for the columns, 1 / half for the row lines
+    const float scale = 1.0f / (static_cast<float>(height) * static_cast<float>(half));
+    pool.parallelFor(height, [&](uint32_t begin, uint32_t end) {
+        std::vector<Complex> line(half);
+        for (uint32_t y = begin; y < end; y++) {
+            // Tangle the row spectrum back into the half-width line: E = (X[k] + X[k + half]) / 2,
+            // O = (X[k] - X[k + half]) / (2 W^k), and X[k + half] = conj(X[half - k]) for a real row
+            const Complex* in = &spectrum[static_cast<size_t>(y) * spectrumWidth];
+            for (uint32_t k = 0; k < half; k++) {
+                const Complex mirror = std::conj(in[half - k]);
+                const Complex even = (in[k] + mirror) * 0.5f;
+                const Complex odd = multiply(in[k] - mirror, std::conj(realTwiddles[k])) * 0.5f;
+                line[k] = even + multiply({0.0f, 1.0f}, odd);
+            }
+            transformLine(line.data(), half, rowTwiddles, rowReversal, true);
+            float* row = &image[static_cast<size_t>(y) * width];
+            for (uint32_t n = 0; n < half; n++) {
+                row[2 * n] = line[n].real() * scale;
+                row[2 * n + 1] = line[n].imag() * scale;
+            }
+        }
+    });
+}
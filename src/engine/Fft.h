@@ -0,0 +1,43 @@
+#pragma once
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include "ThreadPool.h"
+
+// 2D FFT of real row-major images with power-of-two sides, radix 2. A real image has a Hermitian spectrum, so only
+// its width / 2 + 1 left columns are kept (getSpectrumWidth), and each row is transformed as a complex line of half
+// the width (even cells real, odd cells imaginary) and then untangled: about half the work of a complex transform.
+// Rows are transformed first, then the columns, each split into one range per ThreadPool thread; the column passes
+// apply every butterfly to whole row spans, so their loads stay contiguous. inverse(forward(x)) == x
+class Fft
+{
+public:
+    using Complex = std::complex<float>;
+
+private:
+    uint32_t width;
+    uint32_t height;
+    // exp(-2 pi i k / n) for k < n / 2, for the half-width row lines and the columns
+    std::vector<Complex> rowTwiddles;
+    std::vector<Complex> columnTwiddles;
+    // exp(-2 pi i k / width) for k <= width / 2, untangles the half-width lines
+    std::vector<Complex> realTwiddles;
+    // Bit-reversed index of every position of a row line and of a column
+    std::vector<uint32_t> rowReversal;
+    std::vector<uint32_t> columnReversal;
+
+public:
+    // Throws Engine::ConfigurationError unless both sides are powers of two and the width is at least 2
+    Fft(uint32_t width, uint32_t height);
+
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+    // Columns of a spectrum, which is height rows of them
+    uint32_t getSpectrumWidth() const { return width / 2 + 1; }
+
+    void forward(const std::vector<float>& image, std::vector<Complex>& spectrum, ThreadPool& pool) const;
+    // Overwrites spectrum, image is scaled by 1 / (width * height)
+    void inverse(std::vector<Complex>& spectrum, std::vector<float>& image, ThreadPool& pool) const;
+
+    static bool isPowerOfTwo(uint32_t n) { return n != 0 && (n & (n - 1)) == 0; }
+};
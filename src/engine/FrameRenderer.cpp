@@ -0,0 +1,82 @@
+#include "FrameRenderer.h"
+#include "Engine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// unorm8 conversion of a colour channel, as the GPU writes it to the surface
+uint8_t toUnorm8(double value)
+{
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0, 1.0) * 255.0));
+}
+
+}
+
+FrameRenderer::FrameRenderer(uint32_t cellPixels)
+    : cellPixels(cellPixels)
+{
+    if (cellPixels == 0) throw Engine::ConfigurationError("frames need at least one pixel per cell");
+    // VERTICES spans [-0.8, 0.8] of a [-1, 1] cell, so a pixel is covered when its centre lies in [0.1, 0.9]
+    covered.resize(cellPixels);
+    for (uint32_t i = 0; i < cellPixels; i++) {
+        const double centre = (i + 0.5) / cellPixels;
+        covered[i] = centre >= 0.1 && centre <= 0.9;
+    }
+}
+
+uint64_t FrameRenderer::getImageBytes(const Grid& grid) const
+{
+    return static_cast<uint64_t>(grid.getWidth()) * cellPixels * grid.getHeight() * cellPixels * 3;
+}
+
+void FrameRenderer::render(const Grid& grid, Image& image) const
+{
+    TRACE_SCOPE("FrameRenderer::render");
+    const uint32_t width = grid.getWidth();
+    const uint32_t height = grid.getHeight();
+    image.width = width * cellPixels;
+    image.height = height * cellPixels;
+    const size_t rowBytes = static_cast<size_t>(image.width) * 3;
+    image.rgb.resize(rowBytes * image.height);
+
+    // Rows outside the live squares are all background, the others are built once per cell row and copied
+    std::vector<uint8_t> background(rowBytes);
+    for (size_t i = 0; i < rowBytes; i += 3) {
+        std::memcpy(&background[i], BACKGROUND.data(), 3);
+    }
+    std::vector<uint8_t> cellRow(rowBytes);
+    for (uint32_t y = 0; y < height; y++) {
+        cellRow = background;
+        const uint8_t green = toUnorm8(static_cast<double>(y) / height);
+        for (uint32_t x = 0; x < width; x++) {
+            if (!grid.getCell(x, y)) continue;
+            const uint8_t red = toUnorm8(static_cast<double>(x) / width);
+            const uint8_t blue = toUnorm8(1.0 - static_cast<double>(x) / width);
+            for (uint32_t i = 0; i < cellPixels; i++) {
+                if (!covered[i]) continue;
+                uint8_t* pixel = &cellRow[(static_cast<size_t>(x) * cellPixels + i) * 3];
+                pixel[0] = red;
+                pixel[1] = green;
+                pixel[2] = blue;
+            }
+        }
+
+        // Grid row y = 0 is the bottom pixel rows
+        const size_t firstRow = static_cast<size_t>(height - 1 - y) * cellPixels;
+        for (uint32_t j = 0; j < cellPixels; j++) {
+            // Pixel rows run top-down while the cell's square is measured bottom-up, the coverage is symmetric
+            const std::vector<uint8_t>& source = covered[j] ? cellRow : background;
+            std::memcpy(&image.rgb[(firstRow + j) * rowBytes], source.data(), rowBytes);
+        }
+    }
+}
+
+FrameRenderer::Image FrameRenderer::render(const Grid& grid) const
+{
+    Image image;
+    render(grid, image);
+    return image;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Grid.h"
+
+// CPU twin of vertexMain/fragmentMain for headless captures: a live cell (x, y) is a square over the middle 80% of its
+// cell, coloured (x / width, y / height, 1 - x / width), on the render pass clear colour. Row y = 0 is at the bottom
+// of the image, as on screen. Pixel coverage follows the rasterizer (pixel centres inside the square), so the output
+// matches a browser screenshot at the same cell size
+class FrameRenderer
+{
+public:
+    // Tightly packed 8-bit RGB rows, top row first
+    struct Image {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> rgb;
+    };
+
+    static constexpr uint32_t DEFAULT_CELL_PIXELS = 4;
+    // Life::renderFrame's clear colour (0, 0, 0.4)
+    static constexpr std::array<uint8_t, 3> BACKGROUND = {0, 0, 102};
+
+private:
+    uint32_t cellPixels = DEFAULT_CELL_PIXELS;
+    // Which of a cell's pixel columns (and rows) the live square covers
+    std::vector<bool> covered;
+
+public:
+    explicit FrameRenderer(uint32_t cellPixels = DEFAULT_CELL_PIXELS);
+
+    uint32_t getCellPixels() const { return cellPixels; }
+    uint64_t getImageBytes(const Grid& grid) const;
+
+    // Renders grid into image, reusing its storage
+    void render(const Grid& grid, Image& image) const;
+    Image render(const Grid& grid) const;
+};
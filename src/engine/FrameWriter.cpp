@@ -0,0 +1,174 @@
+#include "FrameWriter.h"
+#include "PngEncoder.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+FrameWriter::FrameWriter(Options options)
+    : options(std::move(options))
+    , renderer(this->options.cellPixels)
+{
+    if (this->options.queueCapacity == 0) throw WriteError("the queue needs room for at least one frame");
+    if (this->options.format == Format::Png) {
+        if (this->options.path.empty()) throw WriteError("PNG frames need an output directory");
+        std::error_code ec;
+        std::filesystem::create_directories(this->options.path, ec);
+        if (ec) throw WriteError("cannot create " + this->options.path + ": " + ec.message());
+    } else if (!this->options.command.empty()) {
+        raw = popen(this->options.command.c_str(), "w");
+        if (!raw) throw WriteError("cannot start " + this->options.command);
+        rawIsPipe = true;
+    } else if (this->options.path == "-") {
+        raw = stdout;
+    } else {
+        raw = std::fopen(this->options.path.c_str(), "wb");
+        if (!raw) throw WriteError("cannot write " + this->options.path);
+    }
+
+    const unsigned threads = ThreadPool::resolveThreadCount(this->options.threads);
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(&FrameWriter::workerLoop, this, i);
+    }
+}
+
+FrameWriter::~FrameWriter()
+{
+    try {
+        finish();
+    } catch (const WriteError&) {
+    }
+}
+
+void FrameWriter::submit(Grid board)
+{
+    TRACE_SCOPE("FrameWriter::submit");
+    std::unique_lock lock(mutex);
+    if (inFlight >= options.queueCapacity) {
+        const auto start = std::chrono::steady_clock::now();
+        slotFree.wait(lock, [this] { return inFlight < options.queueCapacity || !error.empty(); });
+        stats.waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (!error.empty()) throw WriteError(error);
+    if (closing) throw WriteError("submit after finish");
+    jobs.push_back({nextIndex++, std::move(board)});
+    inFlight++;
+    lock.unlock();
+    jobReady.notify_one();
+}
+
+FrameWriter::Stats FrameWriter::finish()
+{
+    {
+        std::lock_guard lock(mutex);
+        closing = true;
+    }
+    jobReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    if (raw) {
+        const bool flushed = std::fflush(raw) == 0;
+        const int status = rawIsPipe ? pclose(raw) : (raw == stdout ? 0 : std::fclose(raw));
+        raw = nullptr;
+        if (!flushed) fail("cannot flush the raw output");
+        if (status != 0) fail(rawIsPipe ? "'" + options.command + "' exited with status " + std::to_string(status)
+                                        : "cannot close " + options.path);
+    }
+    throwIfFailed();
+    return stats;
+}
+
+void FrameWriter::workerLoop([[maybe_unused]] unsigned index)
+{
+    TRACE_THREAD_NAME("frame writer " + std::to_string(index));
+    FrameRenderer::Image image;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex);
+            jobReady.wait(lock, [this] { return !jobs.empty() || closing; });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        size_t completed = 1;
+        try {
+            renderer.render(job.board, image);
+            if (options.format == Format::Png) {
+                writePng(job.index, image);
+            } else {
+                completed = writeRaw(job.index, std::move(image));
+                image = {};
+            }
+        } catch (const std::exception& e) {
+            fail(e.what());
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            inFlight -= completed;
+        }
+        slotFree.notify_all();
+    }
+}
+
+void FrameWriter::writePng(uint64_t index, const FrameRenderer::Image& image)
+{
+    const std::vector<uint8_t> png = PngEncoder::encode(image.width, image.height, image.rgb.data());
+
+    TRACE_SCOPE("FrameWriter::writePng");
+    std::ostringstream name;
+    name << "frame_" << std::setw(6) << std::setfill('0') << index << ".png";
+    const std::filesystem::path path = std::filesystem::path(options.path) / name.str();
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+    if (!file) throw std::runtime_error("cannot write " + path.string());
+
+    std::lock_guard lock(mutex);
+    stats.frames++;
+    stats.bytes += png.size();
+}
+
+size_t FrameWriter::writeRaw(uint64_t index, FrameRenderer::Image&& image)
+{
+    TRACE_SCOPE("FrameWriter::writeRaw");
+    std::lock_guard rawLock(rawMutex);
+    size_t written = 0;
+    finished.emplace(index, std::move(image));
+    for (auto it = finished.begin(); it != finished.end() && it->first == nextRawIndex; it = finished.erase(it)) {
+        const std::vector<uint8_t>& rgb = it->second.rgb;
+        if (std::fwrite(rgb.data(), 1, rgb.size(), raw) != rgb.size()) {
+            throw std::runtime_error(rawIsPipe ? "'" + options.command + "' stopped reading"
+                                               : "cannot write " + options.path);
+        }
+        nextRawIndex++;
+        written++;
+
+        std::lock_guard lock(mutex);
+        stats.frames++;
+        stats.bytes += rgb.size();
+    }
+    return written;
+}
+
+void FrameWriter::fail(const std::string& message)
+{
+    {
+        std::lock_guard lock(mutex);
+        if (error.empty()) error = message;
+    }
+    slotFree.notify_all();
+}
+
+void FrameWriter::throwIfFailed()
+{
+    std::lock_guard lock(mutex);
+    if (!error.empty()) throw WriteError(error);
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameRenderer.h"
+#include "Grid.h"
+
+// Streams boards out as rendered frames without making the stepping thread wait on encoding or disk.
+// submit moves the board into a bounded queue and returns at once unless the queue is full, and a pool of workers
+// renders (FrameRenderer) and encodes them: one PNG file per frame, or raw RGB24 frames in order to a file or to the
+// stdin of an encoder process (e.g. ffmpeg -f rawvideo). Frames in flight, queued or being encoded, never exceed
+// the queue capacity, which bounds memory however far behind the disk falls
+class FrameWriter
+{
+public:
+    class WriteError : public std::runtime_error {
+        public:
+            WriteError(const std::string& msg)
+                : std::runtime_error("Failed to write frames: " + msg) {}
+    };
+
+    enum class Format { Png, Raw };
+
+    struct Options {
+        Format format = Format::Png;
+        // Png: output directory (created if missing), frames are frame_000000.png, frame_000001.png, ...
+        // Raw: output file, '-' for stdout
+        std::string path;
+        // Raw only: shell command reading the frames on stdin, used instead of path
+        std::string command;
+        uint32_t cellPixels = FrameRenderer::DEFAULT_CELL_PIXELS;
+        // 0 uses std::thread::hardware_concurrency
+        unsigned threads = 0;
+        size_t queueCapacity = 16;
+    };
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        // Time submit spent blocked on a full queue, anything above zero means encoding or disk is the bottleneck
+        double waitSeconds = 0.0;
+    };
+
+private:
+    struct Job {
+        uint64_t index = 0;
+        Grid board;
+    };
+
+    Options options;
+    FrameRenderer renderer;
+    std::vector<std::thread> workers;
+    std::FILE* raw = nullptr;
+    bool rawIsPipe = false;
+
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable slotFree;
+    std::deque<Job> jobs;
+    size_t inFlight = 0;
+    uint64_t nextIndex = 0;
+    bool closing = false;
+    std::string error;
+    Stats stats;
+
+    // Raw frames finish out of order, they wait here until every earlier frame has been written
+    std::mutex rawMutex;
+    std::map<uint64_t, FrameRenderer::Image> finished;
+    uint64_t nextRawIndex = 0;
+
+    void workerLoop(unsigned index);
+    void writePng(uint64_t index, const FrameRenderer::Image& image);
+    // Writes every frame that is now next in order, returns how many. Frames held back stay in flight until then,
+    // so a slow frame stalls submit instead of letting the backlog grow
+    size_t writeRaw(uint64_t index, FrameRenderer::Image&& image);
+    void fail(const std::string& message);
+    void throwIfFailed();
+
+public:
+    explicit FrameWriter(Options options);
+    // Joins the workers, dropping errors (call finish to see them)
+    ~FrameWriter();
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+    const FrameRenderer& getRenderer() const { return renderer; }
+
+    // Queues board as the next frame. Blocks only while the queue is full, throws WriteError once a frame failed
+    void submit(Grid board);
+    // Waits for every queued frame to be written and closes the output, throws WriteError if any frame failed
+    Stats finish();
+};
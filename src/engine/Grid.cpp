@@ -0,0 +1,64 @@
+#include "Grid.h"
+#include "CounterRng.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+Grid::Grid(uint32_t width, uint32_t height)
+    : width(width)
+    , height(height)
+    , cells(static_cast<size_t>(width) * height)
+{
+}
+
+void Grid::clear()
+{
+    std::fill(cells.begin(), cells.end(), 0);
+}
+
+void Grid::fillRandom(double density, uint64_t seed)
+{
+    const CounterRng::Key key = CounterRng::makeKey(seed);
+    const uint32_t threshold = CounterRng::threshold(density);
+    for (size_t i = 0; i < cells.size(); i++) {
+        cells[i] = CounterRng::at(key, i) < threshold ? 1 : 0;
+    }
+}
+
+void Grid::fillRandom(double density, uint64_t seed, ThreadPool& pool)
+{
+    const CounterRng::Key key = CounterRng::makeKey(seed);
+    const uint32_t threshold = CounterRng::threshold(density);
+    pool.parallelFor(height, [&](uint32_t firstRow, uint32_t lastRow) {
+        const size_t end = static_cast<size_t>(lastRow) * width;
+        for (size_t i = static_cast<size_t>(firstRow) * width; i < end; i++) {
+            cells[i] = CounterRng::at(key, i) < threshold ? 1 : 0;
+        }
+    });
+}
+
+uint64_t Grid::population() const
+{
+    uint64_t count = 0;
+    for (uint8_t cell : cells) {
+        count += cell;
+    }
+    return count;
+}
+
+uint64_t Grid::checksum() const
+{
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+    uint64_t hash = FNV_OFFSET;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 4; i++) {
+            hash = (hash ^ ((value >> (i * 8)) & 0xff)) * FNV_PRIME;
+        }
+    };
+    mix(width);
+    mix(height);
+    for (uint8_t cell : cells) {
+        hash = (hash ^ cell) * FNV_PRIME;
+    }
+    return hash;
+}
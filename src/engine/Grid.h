@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Host-side cell state for the headless engines.
+// One byte per cell (0 or 1), row-major, same indexing as Life::cellStateArray
+class Grid
+{
+private:
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> cells;
+
+public:
+    Grid() = default;
+    Grid(uint32_t width, uint32_t height);
+
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+    uint64_t getCellCount() const { return static_cast<uint64_t>(width) * height; }
+    const std::vector<uint8_t>& getCells() const { return cells; }
+    std::vector<uint8_t>& getCells() { return cells; }
+
+    uint8_t getCell(uint32_t x, uint32_t y) const { return cells[static_cast<size_t>(y) * width + x]; }
+    void setCell(uint32_t x, uint32_t y, uint8_t state) { cells[static_cast<size_t>(y) * width + x] = state; }
+
+    void clear();
+    // Sets each cell alive with probability density using CounterRng, so the same seed always gives
+    // the same board (also the same board as Life's GPU seed pass). The pool overload fills rows in parallel
+    void fillRandom(double density, uint64_t seed);
+    void fillRandom(double density, uint64_t seed, ThreadPool& pool);
+    uint64_t population() const;
+    // FNV-1a over the cell bytes, used to compare results across engines
+    uint64_t checksum() const;
+
+    bool operator==(const Grid& other) const = default;
+};
@@ -0,0 +1,96 @@
+#include "HaloExchange.h"
+#include "Trace.h"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory atomics must be lock free across processes");
+
+constexpr size_t align64(size_t bytes)
+{
+    return (bytes + 63) / 64 * 64;
+}
+
+}
+
+HaloExchange::HaloExchange(uint32_t stripCount, size_t rowWords, uint32_t haloRows)
+    : stripCount(stripCount)
+    , slotWords(rowWords * haloRows)
+{
+    if (stripCount == 0) throw ExchangeError("no strips");
+    const size_t headerBytes = align64(sizeof(Header));
+    const size_t stripBytes = align64(sizeof(Strip) * stripCount);
+    // Two edges, two epoch parities per strip
+    const size_t slotBytes = slotWords * sizeof(uint64_t) * 4 * stripCount;
+    mappingSize = headerBytes + stripBytes + slotBytes;
+
+    // Named only until it is mapped, forked workers inherit the mapping
+    const std::string name = "/life-halo-" + std::to_string(getpid());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw ExchangeError("shm_open " + name + ": " + std::strerror(errno));
+    shm_unlink(name.c_str());
+    if (ftruncate(fd, static_cast<off_t>(mappingSize)) != 0) {
+        const int error = errno;
+        close(fd);
+        throw ExchangeError("cannot size the shared memory: " + std::string(std::strerror(error)));
+    }
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw ExchangeError("mmap: " + std::string(std::strerror(errno)));
+    }
+
+    auto* bytes = static_cast<uint8_t*>(mapping);
+    header = new (bytes) Header{};
+    strips = reinterpret_cast<Strip*>(bytes + headerBytes);
+    for (uint32_t strip = 0; strip < stripCount; strip++) {
+        new (&strips[strip]) Strip{};
+    }
+    slots = reinterpret_cast<uint64_t*>(bytes + headerBytes + stripBytes);
+}
+
+HaloExchange::~HaloExchange()
+{
+    if (mapping) munmap(mapping, mappingSize);
+}
+
+uint64_t* HaloExchange::getSlot(uint32_t strip, Edge edge, uint64_t epoch)
+{
+    const size_t index = (static_cast<size_t>(strip) * 2 + static_cast<uint32_t>(edge)) * 2 + epoch % 2;
+    return slots + index * slotWords;
+}
+
+const uint64_t* HaloExchange::getSlot(uint32_t strip, Edge edge, uint64_t epoch) const
+{
+    return const_cast<HaloExchange*>(this)->getSlot(strip, edge, epoch);
+}
+
+void HaloExchange::publish(uint32_t strip, uint64_t epoch)
+{
+    strips[strip].epoch.store(epoch, std::memory_order_release);
+}
+
+void HaloExchange::waitFor(uint32_t strip, uint64_t epoch) const
+{
+    TRACE_SCOPE("HaloExchange::waitFor");
+    // Neighbours are normally a few microseconds apart, yielding keeps an oversubscribed machine moving
+    while (strips[strip].epoch.load(std::memory_order_acquire) < epoch) {
+        if (isAborted()) throw ExchangeError("another worker failed");
+        std::this_thread::yield();
+    }
+}
+
+void HaloExchange::waitForStart() const
+{
+    while (header->started.load(std::memory_order_acquire) == 0) {
+        if (isAborted()) throw ExchangeError("another worker failed");
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Edge rows of the strips of a decomposed board, in one POSIX shared memory mapping created before the workers fork.
+// After every exchange epoch, strip s writes its top and bottom haloRows rows into its slots for that epoch and then
+// publishes the epoch; its neighbours wait for the epoch before copying the rows into their halos. Slots alternate by
+// epoch parity, and a strip only publishes epoch e + 1 after it has read its neighbours' epoch e, so a slot is never
+// overwritten while a neighbour may still be reading it. A transport between machines would offer the same three calls
+class HaloExchange
+{
+public:
+    class ExchangeError : public std::runtime_error {
+        public:
+            ExchangeError(const std::string& msg)
+                : std::runtime_error("Halo exchange failed: " + msg) {}
+    };
+
+    enum class Edge : uint32_t {
+        Top = 0,
+        Bottom = 1,
+    };
+
+    // What each worker reports back once it is done
+    struct StripStats {
+        // From the start line to the last generation
+        double elapsedSeconds = 0.0;
+        double computeSeconds = 0.0;
+        double waitSeconds = 0.0;
+        uint64_t population = 0;
+        // The strip's share of StateHash, the XOR over all strips is the hash of the whole board
+        uint64_t stateHash = 0;
+        uint32_t exchanges = 0;
+    };
+
+private:
+    struct alignas(64) Header {
+        std::atomic<uint32_t> ready;
+        std::atomic<uint32_t> started;
+        std::atomic<uint32_t> aborted;
+    };
+    struct alignas(64) Strip {
+        std::atomic<uint64_t> epoch;
+        StripStats stats;
+    };
+
+    uint32_t stripCount = 0;
+    size_t slotWords = 0;
+    size_t mappingSize = 0;
+    void* mapping = nullptr;
+    Header* header = nullptr;
+    Strip* strips = nullptr;
+    uint64_t* slots = nullptr;
+
+public:
+    // rowWords packed words per row, haloRows rows per slot
+    HaloExchange(uint32_t stripCount, size_t rowWords, uint32_t haloRows);
+    ~HaloExchange();
+    HaloExchange(const HaloExchange&) = delete;
+    HaloExchange& operator=(const HaloExchange&) = delete;
+
+    uint32_t getStripCount() const { return stripCount; }
+
+    // haloRows * rowWords words, rows in board order
+    uint64_t* getSlot(uint32_t strip, Edge edge, uint64_t epoch);
+    const uint64_t* getSlot(uint32_t strip, Edge edge, uint64_t epoch) const;
+    // Makes the strip's slots of epoch visible to its neighbours
+    void publish(uint32_t strip, uint64_t epoch);
+    // Blocks until strip has published epoch. Throws ExchangeError once another worker aborted
+    void waitFor(uint32_t strip, uint64_t epoch) const;
+
+    // Start line: every worker marks itself ready (its board is filled), the coordinator starts them all at once
+    void markReady() { header->ready.fetch_add(1, std::memory_order_acq_rel); }
+    uint32_t getReadyCount() const { return header->ready.load(std::memory_order_acquire); }
+    void start() { header->started.store(1, std::memory_order_release); }
+    void waitForStart() const;
+    // Wakes every waiting worker with an ExchangeError, so one failure cannot leave the others stuck
+    void abort() { header->aborted.store(1, std::memory_order_release); }
+    bool isAborted() const { return header->aborted.load(std::memory_order_acquire) != 0; }
+
+    StripStats& getStats(uint32_t strip) { return strips[strip].stats; }
+    const StripStats& getStats(uint32_t strip) const { return strips[strip].stats; }
+};
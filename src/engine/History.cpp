@@ -0,0 +1,220 @@
+#include "History.h"
+#include "Engine.h"
+#include "Trace.h"
+
+namespace {
+
+// Literals end at this many zero bytes in a row, fewer are cheaper to carry than a new run header
+constexpr size_t ZERO_RUN_BREAK = 3;
+
+uint8_t byteAt(const History::Words& before, const History::Words& after, size_t index)
+{
+    return static_cast<uint8_t>((before[index / 8] ^ after[index / 8]) >> (index % 8 * 8));
+}
+
+}
+
+History::History(uint32_t width, uint32_t height, size_t memoryBudget, uint32_t keyframeInterval)
+    : width(width)
+    , height(height)
+    , wordCount(static_cast<size_t>((width + 63) / 64) * height)
+    , memoryBudget(memoryBudget)
+    , keyframeInterval(keyframeInterval)
+{
+    if (width == 0 || height == 0) throw Engine::ConfigurationError("history boards need a non-zero size");
+    if (keyframeInterval == 0) throw Engine::ConfigurationError("history keyframe interval must be at least 1");
+}
+
+void History::record(uint64_t generation, const Words& board)
+{
+    TRACE_SCOPE("History::record");
+    if (board.size() != wordCount) throw Engine::ConfigurationError("history board has the wrong size");
+    truncate(generation);
+
+    const std::optional<uint64_t> last = getLastGeneration();
+    const bool follows = last && *last + 1 == generation && segments.back().offsets.size() < keyframeInterval;
+    if (!follows) {
+        segments.emplace_back();
+        segments.back().firstGeneration = generation;
+        lastBoard.assign(wordCount, 0);
+    }
+    Segment& segment = segments.back();
+    segment.offsets.push_back(static_cast<uint32_t>(segment.bytes.size()));
+    encodeXor(lastBoard, board, segment.bytes);
+    lastBoard = board;
+
+    updateMemoryBytes();
+    // The newest segment stays even over budget, there would be nothing to rewind to otherwise
+    while (memoryBytes > memoryBudget && segments.size() > 1) {
+        segments.pop_front();
+        updateMemoryBytes();
+    }
+}
+
+std::optional<History::Words> History::at(uint64_t generation) const
+{
+    TRACE_SCOPE("History::at");
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        if (generation < it->firstGeneration || generation >= it->getEndGeneration()) continue;
+        Words board(wordCount, 0);
+        const size_t count = generation - it->firstGeneration + 1;
+        for (size_t i = 0; i < count; i++) {
+            const size_t end = i + 1 < it->offsets.size() ? it->offsets[i + 1] : it->bytes.size();
+            applyXor(it->bytes.data() + it->offsets[i], end - it->offsets[i], board);
+        }
+        return board;
+    }
+    return std::nullopt;
+}
+
+void History::truncate(uint64_t generation)
+{
+    const std::optional<uint64_t> last = getLastGeneration();
+    if (!last || generation > *last) return;
+
+    while (!segments.empty() && segments.back().firstGeneration >= generation) {
+        segments.pop_back();
+    }
+    if (!segments.empty() && segments.back().getEndGeneration() > generation) {
+        Segment& segment = segments.back();
+        const size_t kept = generation - segment.firstGeneration;
+        segment.bytes.resize(segment.offsets[kept]);
+        segment.offsets.resize(kept);
+    }
+    if (!segments.empty()) lastBoard = *at(segments.back().getEndGeneration() - 1);
+    updateMemoryBytes();
+}
+
+void History::clear()
+{
+    segments.clear();
+    lastBoard.clear();
+    memoryBytes = 0;
+}
+
+bool History::contains(uint64_t generation) const
+{
+    for (const Segment& segment : segments) {
+        if (generation >= segment.firstGeneration && generation < segment.getEndGeneration()) return true;
+    }
+    return false;
+}
+
+std::optional<uint64_t> History::getFirstGeneration() const
+{
+    if (segments.empty()) return std::nullopt;
+    return segments.front().firstGeneration;
+}
+
+std::optional<uint64_t> History::getLastGeneration() const
+{
+    if (segments.empty()) return std::nullopt;
+    return segments.back().getEndGeneration() - 1;
+}
+
+uint64_t History::getGenerationCount() const
+{
+    uint64_t count = 0;
+    for (const Segment& segment : segments) {
+        count += segment.offsets.size();
+    }
+    return count;
+}
+
+void History::updateMemoryBytes()
+{
+    memoryBytes = 0;
+    for (const Segment& segment : segments) {
+        memoryBytes += segment.getMemoryBytes();
+    }
+}
+
+History::Words History::pack(const Grid& grid)
+{
+    const uint32_t wordsPerRow = (grid.getWidth() + 63) / 64;
+    Words board(static_cast<size_t>(wordsPerRow) * grid.getHeight(), 0);
+    for (uint32_t y = 0; y < grid.getHeight(); y++) {
+        for (uint32_t x = 0; x < grid.getWidth(); x++) {
+            if (grid.getCell(x, y)) board[static_cast<size_t>(y) * wordsPerRow + x / 64] |= 1ull << (x % 64);
+        }
+    }
+    return board;
+}
+
+void History::unpack(const Words& board, uint32_t width, uint32_t height, Grid& grid)
+{
+    const uint32_t wordsPerRow = (width + 63) / 64;
+    grid = Grid(width, height);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint64_t word = board[static_cast<size_t>(y) * wordsPerRow + x / 64];
+            grid.setCell(x, y, static_cast<uint8_t>((word >> (x % 64)) & 1));
+        }
+    }
+}
+
+void History::encodeXor(const Words& before, const Words& after, std::vector<uint8_t>& out)
+{
+    const size_t size = after.size() * 8;
+    size_t position = 0;
+    while (position < size) {
+        const size_t zerosStart = position;
+        while (position < size && byteAt(before, after, position) == 0) {
+            position++;
+        }
+        if (position == size) break;
+
+        const size_t literalStart = position;
+        size_t zeros = 0;
+        while (position < size && zeros < ZERO_RUN_BREAK) {
+            zeros = byteAt(before, after, position) == 0 ? zeros + 1 : 0;
+            position++;
+        }
+        // Give back the zeros that ended the literal, the next run counts them
+        const size_t literalEnd = zeros == ZERO_RUN_BREAK ? position - zeros : position;
+        position = literalEnd;
+
+        writeVarint(literalStart - zerosStart, out);
+        writeVarint(literalEnd - literalStart, out);
+        for (size_t i = literalStart; i < literalEnd; i++) {
+            out.push_back(byteAt(before, after, i));
+        }
+    }
+}
+
+bool History::applyXor(const uint8_t* data, size_t size, Words& board)
+{
+    const uint64_t boardBytes = static_cast<uint64_t>(board.size()) * 8;
+    size_t read = 0;
+    uint64_t position = 0;
+    while (read < size) {
+        const uint64_t zeros = readVarint(data, size, read);
+        const uint64_t literals = readVarint(data, size, read);
+        if (zeros > boardBytes - position || literals > boardBytes - position - zeros) return false;
+        position += zeros;
+        for (uint64_t i = 0; i < literals && read < size; i++, position++) {
+            board[position / 8] ^= static_cast<uint64_t>(data[read++]) << (position % 8 * 8);
+        }
+    }
+    return true;
+}
+
+void History::writeVarint(uint64_t value, std::vector<uint8_t>& out)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t History::readVarint(const uint8_t* data, size_t size, size_t& position)
+{
+    uint64_t value = 0;
+    for (uint32_t shift = 0; position < size && shift < 64; shift += 7) {
+        const uint8_t byte = data[position++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "Grid.h"
+
+// Rewind history of a board: segments of one keyframe followed by the XOR deltas of the next generations,
+// each run-length coded as bytes, kept within a memory budget by dropping the oldest segments.
+// A board that does not change costs one offset per generation, a glider a few dozen bytes.
+// Seeking decodes the segment's keyframe and applies its deltas up to the wanted generation
+class History
+{
+public:
+    // Row-major bit-packed board, ceil(width / 64) words per row, bit i of a word is cell x % 64 = i
+    // (the StateHash layout)
+    using Words = std::vector<uint64_t>;
+
+    // Generations per segment, the most deltas a seek has to apply
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 64;
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 16u << 20;
+
+private:
+    struct Segment {
+        uint64_t firstGeneration = 0;
+        // Encoded keyframe, then one encoded delta per later generation
+        std::vector<uint8_t> bytes;
+        // Where generation firstGeneration + i starts in bytes
+        std::vector<uint32_t> offsets;
+
+        uint64_t getEndGeneration() const { return firstGeneration + offsets.size(); }
+        size_t getMemoryBytes() const { return bytes.capacity() + offsets.capacity() * sizeof(uint32_t); }
+    };
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t wordCount = 0;
+    size_t memoryBudget = DEFAULT_MEMORY_BUDGET;
+    uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    std::deque<Segment> segments;
+    // Board of the newest generation, deltas are taken against it
+    Words lastBoard;
+    size_t memoryBytes = 0;
+
+    void updateMemoryBytes();
+
+public:
+    History(uint32_t width, uint32_t height, size_t memoryBudget = DEFAULT_MEMORY_BUDGET,
+            uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+
+    // Adds board as generation. Generations from there on are forgotten first (the timeline forks when a
+    // rewound board is stepped or edited), and a generation that does not follow the newest one starts a new keyframe
+    void record(uint64_t generation, const Words& board);
+    // Board of generation, or nothing when it was never recorded or has been dropped
+    std::optional<Words> at(uint64_t generation) const;
+    // Forgets generation and everything after it
+    void truncate(uint64_t generation);
+    void clear();
+
+    bool contains(uint64_t generation) const;
+    std::optional<uint64_t> getFirstGeneration() const;
+    std::optional<uint64_t> getLastGeneration() const;
+    uint64_t getGenerationCount() const;
+    // Bytes held by the encoded segments (allocated, not just used)
+    size_t getMemoryBytes() const { return memoryBytes; }
+
+    static Words pack(const Grid& grid);
+    static void unpack(const Words& board, uint32_t width, uint32_t height, Grid& grid);
+
+    // Appends before XOR after as runs over its bytes: (zero count, literal count) varints followed by the literal
+    // bytes. Trailing zeros are not written, so equal boards encode to nothing
+    static void encodeXor(const Words& before, const Words& after, std::vector<uint8_t>& out);
+    // XORs an encoding from encodeXor into board. Returns false (leaving board partly changed) when the encoding
+    // reaches past the end of board, which only happens to encodings of another board size or corrupt ones
+    static bool applyXor(const uint8_t* data, size_t size, Words& board);
+
+    // LEB128 varints as used by encodeXor. readVarint advances position and stops at the end of data
+    static void writeVarint(uint64_t value, std::vector<uint8_t>& out);
+    static uint64_t readVarint(const uint8_t* data, size_t size, size_t& position);
+};
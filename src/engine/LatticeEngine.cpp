@@ -0,0 +1,138 @@
+#include "LatticeEngine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Halo columns on each side of the padded board, the triangle reads two cells across
+constexpr int64_t HALO_COLUMNS = 2;
+
+}
+
+LatticeEngine::LatticeEngine(const LatticeRule& rule)
+    : rule(rule)
+{
+}
+
+void LatticeEngine::setRule(const LatticeRule& newRule)
+{
+    validate(newRule, topology, current.getWidth(), current.getHeight());
+    rule = newRule;
+}
+
+void LatticeEngine::validate(const LatticeRule& rule, Topology::Kind kind, uint32_t width, uint32_t height)
+{
+    if (kind != Topology::Kind::Torus && kind != Topology::Kind::Plane) {
+        throw Engine::ConfigurationError("lattice engine only supports the torus and the plane, not " +
+                                         std::string(Topology::getName(kind)));
+    }
+    const bool triangle = rule.kind == LatticeRule::Kind::Triangle;
+    if (kind == Topology::Kind::Torus && (height % 2 != 0 || (triangle && width % 2 != 0))) {
+        throw Engine::ConfigurationError("a " + std::to_string(width) + "x" + std::to_string(height) +
+                                         (triangle ? " triangle" : " hex") +
+                                         " torus would break the lattice where it wraps, its sides must be even");
+    }
+}
+
+void LatticeEngine::load(const Grid& grid)
+{
+    validate(rule, topology, grid.getWidth(), grid.getHeight());
+    current = grid;
+    next = Grid(grid.getWidth(), grid.getHeight());
+    padded.assign(static_cast<size_t>(grid.getWidth() + 2 * HALO_COLUMNS) * (grid.getHeight() + 2), 0);
+}
+
+void LatticeEngine::store(Grid& grid) const
+{
+    grid = current;
+}
+
+void LatticeEngine::setTopology(Topology::Kind kind)
+{
+    validate(rule, kind, current.getWidth(), current.getHeight());
+    topology = kind;
+}
+
+void LatticeEngine::fillPadded()
+{
+    const int64_t width = current.getWidth();
+    const int64_t height = current.getHeight();
+    const int64_t stride = width + 2 * HALO_COLUMNS;
+    const bool torus = topology == Topology::Kind::Torus;
+    // Board rows with their halo columns, then the halo rows as whole padded rows (corners included)
+    for (int64_t y = 0; y < height; y++) {
+        const uint8_t* source = current.getCells().data() + y * width;
+        uint8_t* row = padded.data() + (y + 1) * stride + HALO_COLUMNS;
+        std::copy_n(source, width, row);
+        for (int64_t x = 1; x <= HALO_COLUMNS; x++) {
+            row[-x] = torus ? source[((width - x) % width + width) % width] : 0;
+            row[width - 1 + x] = torus ? source[(x - 1) % width] : 0;
+        }
+    }
+    uint8_t* top = padded.data();
+    uint8_t* bottom = padded.data() + (height + 1) * stride;
+    if (torus) {
+        std::copy_n(padded.data() + height * stride, stride, top);
+        std::copy_n(padded.data() + stride, stride, bottom);
+    } else {
+        std::fill_n(top, stride, 0);
+        std::fill_n(bottom, stride, 0);
+    }
+}
+
+void LatticeEngine::stepHex()
+{
+    const int64_t width = current.getWidth();
+    const int64_t height = current.getHeight();
+    const int64_t stride = width + 2 * HALO_COLUMNS;
+    uint8_t* nextCells = next.getCells().data();
+    for (int64_t y = 0; y < height; y++) {
+        const uint8_t* row = padded.data() + (y + 1) * stride + HALO_COLUMNS;
+        // Odd rows sit half a cell right: their neighbours in the rows around are x and x + 1, even rows' x - 1 and x
+        const int64_t shift = y & 1;
+        const uint8_t* below = row - stride + shift;
+        const uint8_t* above = row + stride + shift;
+        uint8_t* out = nextCells + y * width;
+        for (int64_t x = 0; x < width; x++) {
+            const uint32_t count = row[x - 1] + row[x + 1] + below[x - 1] + below[x] + above[x - 1] + above[x];
+            out[x] = rule.nextState(row[x] != 0, count) ? 1 : 0;
+        }
+    }
+}
+
+void LatticeEngine::stepTriangle()
+{
+    const int64_t width = current.getWidth();
+    const int64_t height = current.getHeight();
+    const int64_t stride = width + 2 * HALO_COLUMNS;
+    uint8_t* nextCells = next.getCells().data();
+    for (int64_t y = 0; y < height; y++) {
+        // Row y - 1 is drawn below row y (y = 0 is the bottom row)
+        const uint8_t* row = padded.data() + (y + 1) * stride + HALO_COLUMNS;
+        const uint8_t* below = row - stride;
+        const uint8_t* above = row + stride;
+        uint8_t* out = nextCells + y * width;
+        for (int64_t x = 0; x < width; x++) {
+            // Up cells ((x + y) even) have their flat side on the row below, which adds its x - 2 and x + 2
+            const uint8_t* flat = ((x + y) & 1) == 0 ? below : above;
+            const uint32_t count = row[x - 2] + row[x - 1] + row[x + 1] + row[x + 2] +
+                                   below[x - 1] + below[x] + below[x + 1] +
+                                   above[x - 1] + above[x] + above[x + 1] +
+                                   flat[x - 2] + flat[x + 2];
+            out[x] = rule.nextState(row[x] != 0, count) ? 1 : 0;
+        }
+    }
+}
+
+void LatticeEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("LatticeEngine::step");
+    if (current.getWidth() == 0 || current.getHeight() == 0) return;
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        fillPadded();
+        if (rule.kind == LatticeRule::Kind::Hex) stepHex();
+        else stepTriangle();
+        std::swap(current, next);
+    }
+}
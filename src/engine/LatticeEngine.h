@@ -0,0 +1,44 @@
+#pragma once
+#include "Engine.h"
+#include "LatticeRule.h"
+
+// Hexagonal and triangular Life (LatticeRule) on the same one-byte row-major boards as ScalarEngine. Each lattice has
+// its own step loop rather than a list of neighbour offsets, so every read is a fixed offset from the cell, like the
+// square kernel's: the hex loop picks the rows above and below by row parity once per row, and the triangle loop
+// adds the six cells around it in the rows above and below to the four in its own row, plus the two outer cells of the
+// row across its flat side. The padded copy has two halo columns per side for the triangle's x +- 2 reads.
+// Not in Engine::create, its boards are not comparable with the square engines. Life's hexMain and triangleMain are
+// the GPU counterparts. Torus and plane only, and a torus needs an even height (and an even width for triangles) so
+// the row and cell parities carry across the wrap
+class LatticeEngine : public Engine
+{
+private:
+    LatticeRule rule;
+    Grid current;
+    Grid next;
+    // (width + 4) x (height + 2), board at (2, 1)
+    std::vector<uint8_t> padded;
+    Topology::Kind topology = Topology::Kind::Torus;
+
+    // Throws Engine::ConfigurationError unless kind can glue a width x height board of rule's lattice
+    static void validate(const LatticeRule& rule, Topology::Kind kind, uint32_t width, uint32_t height);
+    void fillPadded();
+    void stepHex();
+    void stepTriangle();
+
+public:
+    explicit LatticeEngine(const LatticeRule& rule = LatticeRule{});
+
+    // Takes effect with the next step, the board is kept. Throws like setTopology when the board cannot have the
+    // rule's lattice
+    void setRule(const LatticeRule& rule);
+    const LatticeRule& getRule() const { return rule; }
+
+    std::string_view getName() const override { return "lattice"; }
+    void load(const Grid& grid) override;
+    void store(Grid& grid) const override;
+    void step(uint32_t generations = 1) override;
+    uint64_t population() const override { return current.population(); }
+    void setTopology(Topology::Kind kind) override;
+    Topology::Kind getTopology() const override { return topology; }
+};
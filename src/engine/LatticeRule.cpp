@@ -0,0 +1,69 @@
+#include "LatticeRule.h"
+#include "Engine.h"
+
+namespace {
+
+char upper(char c)
+{
+    return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// Neighbour counts written as digits, "" for none
+uint32_t parseCounts(std::string_view digits, std::string_view rule)
+{
+    uint32_t mask = 0;
+    for (const char c : digits) {
+        if (c < '0' || c > '9') throw Engine::ConfigurationError("bad count in rule '" + std::string(rule) + "'");
+        mask |= 1u << (c - '0');
+    }
+    return mask;
+}
+
+}
+
+LatticeRule LatticeRule::parse(std::string_view text)
+{
+    for (const auto& [name, rule] : NAMES) {
+        if (name == text) return parse(rule);
+    }
+
+    LatticeRule rule;
+    const char suffix = text.empty() ? '\0' : upper(text.back());
+    if (suffix == 'H') rule.kind = Kind::Hex;
+    else if (suffix == 'T') rule.kind = Kind::Triangle;
+    else {
+        throw Engine::ConfigurationError("lattice rule '" + std::string(text) +
+                                         "' needs an H (hex) or T (triangle) suffix");
+    }
+    const std::string_view body = text.substr(0, text.size() - 1);
+    const size_t slash = body.find('/');
+    if (slash == std::string_view::npos || slash == 0 || slash + 1 >= body.size() || upper(body[0]) != 'B' ||
+        upper(body[slash + 1]) != 'S') {
+        throw Engine::ConfigurationError("lattice rule '" + std::string(text) + "' is not of the form B.../S...H");
+    }
+    rule.birth = parseCounts(body.substr(1, slash - 1), text);
+    rule.survive = parseCounts(body.substr(slash + 2), text);
+
+    const uint32_t counts = (1u << (rule.getNeighbourCount() + 1)) - 1;
+    if ((rule.birth | rule.survive) & ~counts) {
+        throw Engine::ConfigurationError("rule '" + std::string(text) + "' counts more than " +
+                                         std::to_string(rule.getNeighbourCount()) + " neighbours");
+    }
+    // A birth with no live cell around would fill the whole board from nothing
+    if (rule.birth & 1u) throw Engine::ConfigurationError("births need a live cell around (B0 is not supported)");
+    return rule;
+}
+
+std::string LatticeRule::toString() const
+{
+    std::string text = "B";
+    for (uint32_t count = 0; count <= 9; count++) {
+        if ((birth >> count) & 1u) text += static_cast<char>('0' + count);
+    }
+    text += "/S";
+    for (uint32_t count = 0; count <= 9; count++) {
+        if ((survive >> count) & 1u) text += static_cast<char>('0' + count);
+    }
+    text += kind == Kind::Hex ? "H" : "T";
+    return text;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Life-like rule on a hexagonal or triangular lattice, in B/S notation with the lattice as suffix: "B2/S34H" counts
+// six neighbours (hexagons, as in Golly), "B4/S345T" twelve (triangles, the three sharing an edge and the nine only
+// sharing a corner). Either lattice is stored as an ordinary row-major board, so the halo, seeding, hashing, edits
+// and history work unchanged, and only the neighbour reads differ:
+// - Hex: offset rows, odd rows sit half a cell to the right. The neighbours of (x, y) are (x - 1, y), (x + 1, y)
+//   and, in the rows above and below, the cells at x - 1 + (y & 1) and x + (y & 1)
+// - Triangle: cells in a row sit half a cell apart, (x, y) points up when x + y is even and down otherwise. The
+//   neighbours are x - 2 .. x + 2 in its own row and in the row across its flat side (y - 1 for an up cell), and
+//   x - 1 .. x + 1 in the row across its tip
+// LatticeEngine steps them on the CPU, Life's hexMain and triangleMain on the GPU
+class LatticeRule
+{
+public:
+    // LATTICE in shader.wgsl, where 0 is the square lattice
+    enum class Kind : uint32_t {
+        Hex = 1,
+        Triangle = 2,
+    };
+
+    Kind kind = Kind::Hex;
+    // Bit n set: a dead cell with n live neighbours is born (birth), a live one survives (survive)
+    uint32_t birth = 1u << 2;
+    uint32_t survive = 1u << 3 | 1u << 4;
+
+    // B/S notation with an H or T suffix (case-insensitive), or one of NAMES. Throws Engine::ConfigurationError for
+    // anything else, counts above the lattice's neighbour count, or B0. Counts are single digits, so a triangle's
+    // 10 to 12 cannot be written
+    static LatticeRule parse(std::string_view text);
+    std::string toString() const;
+
+    uint32_t getNeighbourCount() const { return kind == Kind::Hex ? 6 : 12; }
+    // Next state of a cell with count live neighbours
+    bool nextState(bool alive, uint32_t count) const { return (((alive ? survive : birth) >> count) & 1u) != 0; }
+
+    bool operator==(const LatticeRule& other) const
+    {
+        return kind == other.kind && birth == other.birth && survive == other.survive;
+    }
+    bool operator!=(const LatticeRule& other) const { return !(*this == other); }
+
+    // One rule per lattice, named after it
+    static constexpr std::array<std::pair<std::string_view, std::string_view>, 2> NAMES = {{
+        {"hex", "B2/S34H"},
+        {"triangle", "B4/S345T"},
+    }};
+};
@@ -0,0 +1,141 @@
+#include "LeniaEngine.h"
+#include "CounterRng.h"
+#include "Engine.h"
+#include "Trace.h"
+
+LeniaEngine::LeniaEngine(const LeniaRule& rule, unsigned threads)
+    : rule(rule)
+    , pool(threads)
+{
+}
+
+void LeniaEngine::setRule(const LeniaRule& newRule)
+{
+    rule = newRule;
+    if (width > 0) prepareKernel();
+}
+
+void LeniaEngine::load(const std::vector<float>& states, uint32_t newWidth, uint32_t newHeight)
+{
+    if (states.size() != static_cast<size_t>(newWidth) * newHeight) {
+        throw Engine::ConfigurationError("Lenia board needs " + std::to_string(newWidth) + "x" +
+                                         std::to_string(newHeight) + " states, got " + std::to_string(states.size()));
+    }
+    if (!fft || fft->getWidth() != newWidth || fft->getHeight() != newHeight) {
+        fft = std::make_unique<Fft>(newWidth, newHeight);
+    }
+    const bool resized = newWidth != width || newHeight != height;
+    width = newWidth;
+    height = newHeight;
+    field = states;
+    potential.assign(field.size(), 0.0f);
+    if (resized || kernelSpectrum.empty()) prepareKernel();
+}
+
+void LeniaEngine::prepareKernel()
+{
+    TRACE_SCOPE("LeniaEngine::prepareKernel");
+    const std::vector<float> weights = rule.kernel();
+    const int radius = static_cast<int>(rule.radius);
+    const int side = 2 * radius + 1;
+    if (static_cast<uint32_t>(side) > width || static_cast<uint32_t>(side) > height) {
+        throw Engine::ConfigurationError("a Lenia kernel of radius " + std::to_string(radius) +
+                                         " does not fit on a " + std::to_string(width) + "x" + std::to_string(height) +
+                                         " board");
+    }
+    taps.clear();
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            const float weight = weights[static_cast<size_t>(y) * side + x];
+            if (weight != 0.0f) taps.push_back({x - radius, y - radius, weight});
+        }
+    }
+
+    // Potential(c) = sum of weight(d) * field(c + d), a correlation: the kernel goes in at -d, wrapped around (0, 0).
+    // The ring is symmetric, so this only matters for kernels that are not
+    std::vector<float> kernelImage(static_cast<size_t>(width) * height, 0.0f);
+    for (const Tap& tap : taps) {
+        const uint32_t x = static_cast<uint32_t>((-tap.dx % static_cast<int>(width) + static_cast<int>(width)) %
+                                                 static_cast<int>(width));
+        const uint32_t y = static_cast<uint32_t>((-tap.dy % static_cast<int>(height) + static_cast<int>(height)) %
+                                                 static_cast<int>(height));
+        kernelImage[static_cast<size_t>(y) * width + x] += tap.weight;
+    }
+    fft->forward(kernelImage, kernelSpectrum, pool);
+}
+
+void LeniaEngine::convolveFft()
+{
+    TRACE_SCOPE("LeniaEngine::convolveFft");
+    fft->forward(field, spectrum, pool);
+    // Written out, operator* would check every product for NaN and infinity (a libgcc call without -ffast-math)
+    const uint32_t spectrumWidth = fft->getSpectrumWidth();
+    pool.parallelFor(height, [&](uint32_t begin, uint32_t end) {
+        for (size_t i = static_cast<size_t>(begin) * spectrumWidth; i < static_cast<size_t>(end) * spectrumWidth; i++) {
+            const Fft::Complex a = spectrum[i];
+            const Fft::Complex b = kernelSpectrum[i];
+            spectrum[i] = {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+        }
+    });
+    fft->inverse(spectrum, potential, pool);
+}
+
+void LeniaEngine::convolveDirect()
+{
+    TRACE_SCOPE("LeniaEngine::convolveDirect");
+    pool.parallelFor(height, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t y = begin; y < end; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                float sum = 0.0f;
+                for (const Tap& tap : taps) {
+                    // Offsets stay within one board size, so adding one size keeps the modulo positive
+                    const uint32_t sx = (x + width + static_cast<uint32_t>(tap.dx)) % width;
+                    const uint32_t sy = (y + height + static_cast<uint32_t>(tap.dy)) % height;
+                    sum += tap.weight * field[static_cast<size_t>(sy) * width + sx];
+                }
+                potential[static_cast<size_t>(y) * width + x] = sum;
+            }
+        }
+    });
+}
+
+void LeniaEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("LeniaEngine::step");
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        if (convolution == Convolution::Fft) {
+            convolveFft();
+        } else {
+            convolveDirect();
+        }
+        pool.parallelFor(height, [&](uint32_t begin, uint32_t end) {
+            for (size_t i = static_cast<size_t>(begin) * width; i < static_cast<size_t>(end) * width; i++) {
+                field[i] = rule.nextState(field[i], potential[i]);
+            }
+        });
+    }
+}
+
+double LeniaEngine::mass() const
+{
+    double total = 0.0;
+    for (const float state : field) total += state;
+    return total;
+}
+
+std::vector<float> LeniaEngine::makeSoup(uint32_t width, uint32_t height, uint64_t seed, double density)
+{
+    const CounterRng::Key key = CounterRng::makeKey(seed);
+    const uint32_t threshold = CounterRng::threshold(density);
+    std::vector<float> states(static_cast<size_t>(width) * height, 0.0f);
+    for (uint32_t y = height / 4; y < height - height / 4; y++) {
+        for (uint32_t x = width / 4; x < width - width / 4; x++) {
+            const uint64_t index = static_cast<uint64_t>(y) * width + x;
+            const uint32_t random = CounterRng::at(key, index);
+            if (random >= threshold) continue;
+            // Fresh bits for the state, random itself is biased below the threshold
+            states[index] = static_cast<float>(CounterRng::mix(random) >> 8) / static_cast<float>(1u << 24);
+        }
+    }
+    return states;
+}
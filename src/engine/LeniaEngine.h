@@ -0,0 +1,69 @@
+#pragma once
+#include "Fft.h"
+#include "LeniaRule.h"
+#include "ThreadPool.h"
+#include <memory>
+
+// Lenia on a torus of float states (LeniaRule). The potential of every cell is the kernel convolved with the board:
+// done directly that is (2R + 1)^2 multiply-adds per cell, 10^4 at radius 50, so by default the board is transformed
+// with Fft instead, multiplied by the kernel's spectrum (computed once per rule) and transformed back, which costs the
+// same for any radius. The direct convolution stays available as the reference (life_lenia --verify). Sides must be
+// powers of two. Life's leniaMain is the GPU counterpart
+class LeniaEngine
+{
+public:
+    enum class Convolution {
+        Fft,
+        Direct,
+    };
+
+private:
+    LeniaRule rule;
+    Convolution convolution = Convolution::Fft;
+    ThreadPool pool;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<float> field;
+    std::vector<float> potential;
+    std::unique_ptr<Fft> fft;
+    // Spectrum of the kernel wrapped around cell (0, 0), and the board's spectrum while stepping (Fft's half-width
+    // layout)
+    std::vector<Fft::Complex> kernelSpectrum;
+    std::vector<Fft::Complex> spectrum;
+    // Non-zero kernel weights as (dx, dy, weight), for the direct convolution
+    struct Tap {
+        int dx;
+        int dy;
+        float weight;
+    };
+    std::vector<Tap> taps;
+
+    void prepareKernel();
+    void convolveFft();
+    void convolveDirect();
+
+public:
+    // threads = 0 uses all hardware threads
+    explicit LeniaEngine(const LeniaRule& rule = LeniaRule{}, unsigned threads = 0);
+
+    // Takes effect with the next step, the board is kept
+    void setRule(const LeniaRule& rule);
+    const LeniaRule& getRule() const { return rule; }
+    void setConvolution(Convolution method) { convolution = method; }
+    Convolution getConvolution() const { return convolution; }
+    unsigned getThreadCount() const { return pool.getThreadCount(); }
+
+    // Replaces the board, states row-major with y = 0 the top row. Throws Engine::ConfigurationError unless both sides
+    // are powers of two
+    void load(const std::vector<float>& states, uint32_t width, uint32_t height);
+    const std::vector<float>& getField() const { return field; }
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+    void step(uint32_t generations = 1);
+    // Sum of all states
+    double mass() const;
+
+    // Random states in [0, 1) in the middle quarter of the board (density of them non-zero), zero elsewhere. Only
+    // depends on (seed, cell index), like Grid::fillRandom
+    static std::vector<float> makeSoup(uint32_t width, uint32_t height, uint64_t seed, double density);
+};
@@ -0,0 +1,113 @@
+#include "LeniaRule.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+// The whole of text as a finite number
+double parseNumber(std::string_view text, std::string_view rule)
+{
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(std::string(text), &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (text.empty() || used != text.size() || !std::isfinite(value)) {
+        throw Engine::ConfigurationError("bad number in rule '" + std::string(rule) + "'");
+    }
+    return value;
+}
+
+}
+
+LeniaRule LeniaRule::parse(std::string_view text)
+{
+    for (const auto& [name, rule] : NAMES) {
+        if (name == text) return parse(rule);
+    }
+
+    LeniaRule rule;
+    bool hasRadius = false;
+    for (size_t start = 0; start <= text.size();) {
+        const size_t comma = std::min(text.find(',', start), text.size());
+        const std::string_view field = text.substr(start, comma - start);
+        start = comma + 1;
+        if (field.empty()) throw Engine::ConfigurationError("empty field in rule '" + std::string(text) + "'");
+        if (std::string_view("RTMS").find(field[0]) == std::string_view::npos) {
+            throw Engine::ConfigurationError("unknown rule '" + std::string(text) + "'");
+        }
+        const double value = parseNumber(field.substr(1), text);
+        switch (field[0]) {
+            case 'R':
+                if (value < 1.0 || value > MAX_RADIUS || value != std::floor(value)) {
+                    throw Engine::ConfigurationError("the radius must be a whole number in [1, " +
+                                                     std::to_string(MAX_RADIUS) + "], not '" + std::string(field) + "'");
+                }
+                rule.radius = static_cast<uint32_t>(value);
+                hasRadius = true;
+                break;
+            case 'T':
+                if (value < 1.0 || value > 1000.0 || value != std::floor(value)) {
+                    throw Engine::ConfigurationError("ticks must be a whole number in [1, 1000], not '" +
+                                                     std::string(field) + "'");
+                }
+                rule.ticks = static_cast<uint32_t>(value);
+                break;
+            case 'M':
+                rule.mu = static_cast<float>(value);
+                break;
+            case 'S':
+                if (value <= 0.0) throw Engine::ConfigurationError("sigma must be positive in '" + std::string(text) + "'");
+                rule.sigma = static_cast<float>(value);
+                break;
+            default:
+                throw Engine::ConfigurationError("unknown rule '" + std::string(text) + "'");
+        }
+    }
+    if (!hasRadius) throw Engine::ConfigurationError("rule '" + std::string(text) + "' needs R");
+    return rule;
+}
+
+std::string LeniaRule::toString() const
+{
+    std::ostringstream text;
+    text << "R" << radius << ",T" << ticks << ",M" << mu << ",S" << sigma;
+    return text.str();
+}
+
+std::vector<float> LeniaRule::kernel() const
+{
+    // Exponential bump of the distance in radii, exp(4 - 1 / (r (1 - r))): 1 at r = 1/2 and smoothly 0 at the
+    // centre and from r = 1 on
+    const int side = 2 * static_cast<int>(radius) + 1;
+    std::vector<float> weights(static_cast<size_t>(side) * side, 0.0f);
+    double total = 0.0;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            const double dx = x - static_cast<int>(radius);
+            const double dy = y - static_cast<int>(radius);
+            const double r = std::sqrt(dx * dx + dy * dy) / radius;
+            if (r <= 0.0 || r >= 1.0) continue;
+            const double weight = std::exp(4.0 - 1.0 / (r * (1.0 - r)));
+            weights[static_cast<size_t>(y) * side + x] = static_cast<float>(weight);
+            total += weight;
+        }
+    }
+    for (float& weight : weights) weight = static_cast<float>(weight / total);
+    return weights;
+}
+
+float LeniaRule::growth(float potential) const
+{
+    const float distance = (potential - mu) / sigma;
+    return 2.0f * std::exp(-0.5f * distance * distance) - 1.0f;
+}
+
+float LeniaRule::nextState(float state, float potential) const
+{
+    return std::clamp(state + growth(potential) / static_cast<float>(ticks), 0.0f, 1.0f);
+}
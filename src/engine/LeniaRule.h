@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Lenia rule, a continuous cellular automaton: cells hold a state in [0, 1], and every step each cell's potential U is
+// the kernel-weighted average of the states within radius cells, and its state moves by growth(U) / ticks, clamped
+// to [0, 1]. The kernel is one smooth ring peaking halfway out, the growth function a Gaussian bump around mu of
+// width sigma (SmoothLife is the special case of hard-edged rings). Written "R13,T10,M0.15,S0.015".
+// LeniaEngine convolves with FFTs on the CPU, Life's leniaMain with shared-memory tiles on the GPU
+class LeniaRule
+{
+public:
+    // Largest radius Life's kernel buffer is sized for
+    static constexpr uint32_t MAX_RADIUS = 64;
+
+    uint32_t radius = 13;
+    // Steps per unit of time, the state moves by growth / ticks each step
+    uint32_t ticks = 10;
+    float mu = 0.15f;
+    float sigma = 0.015f;
+
+    // "R13,T10,M0.15,S0.015" or one of NAMES. Throws Engine::ConfigurationError for anything else or a radius above
+    // MAX_RADIUS
+    static LeniaRule parse(std::string_view text);
+    std::string toString() const;
+
+    // (2 * radius + 1)^2 weights in row-major order, centred on the cell and summing to 1
+    std::vector<float> kernel() const;
+    // In [-1, 1], positive where U is close to mu
+    float growth(float potential) const;
+    float nextState(float state, float potential) const;
+
+    bool operator==(const LeniaRule& other) const
+    {
+        return radius == other.radius && ticks == other.ticks && mu == other.mu && sigma == other.sigma;
+    }
+    bool operator!=(const LeniaRule& other) const { return !(*this == other); }
+
+    // Orbium, the gliding creature of the Lenia paper, at its own radius and scaled up (it keeps its shape)
+    static constexpr std::array<std::pair<std::string_view, std::string_view>, 3> NAMES = {{
+        {"orbium", "R13,T10,M0.15,S0.015"},
+        {"orbium25", "R25,T10,M0.15,S0.015"},
+        {"orbium50", "R50,T10,M0.15,S0.015"},
+    }};
+};
@@ -0,0 +1,94 @@
+#include "LtlEngine.h"
+#include "Trace.h"
+#include <utility>
+
+LtlEngine::LtlEngine(const LtlRule& rule)
+    : rule(rule)
+{
+}
+
+void LtlEngine::setRule(const LtlRule& newRule)
+{
+    rule = newRule;
+}
+
+void LtlEngine::load(const Grid& grid)
+{
+    current = grid;
+    next = Grid(grid.getWidth(), grid.getHeight());
+}
+
+void LtlEngine::store(Grid& grid) const
+{
+    grid = current;
+}
+
+void LtlEngine::setTopology(Topology::Kind kind)
+{
+    if (kind != Topology::Kind::Torus && kind != Topology::Kind::Plane) {
+        throw Engine::ConfigurationError("ltl engine only supports the torus and the plane, not " +
+                                         std::string(Topology::getName(kind)));
+    }
+    topology = kind;
+}
+
+void LtlEngine::buildTable()
+{
+    TRACE_SCOPE("LtlEngine::buildTable");
+    const int64_t width = current.getWidth();
+    const int64_t height = current.getHeight();
+    const int64_t radius = rule.radius;
+    const size_t tableWidth = static_cast<size_t>(width + 2 * radius + 1);
+    const size_t tableHeight = static_cast<size_t>(height + 2 * radius + 1);
+    table.assign(tableWidth * tableHeight, 0);
+
+    // Board column (or row) an extended one reads, -1 for a dead one off the plane
+    auto source = [&](int64_t extended, int64_t size) -> int64_t {
+        const int64_t cell = extended - radius;
+        if (cell >= 0 && cell < size) return cell;
+        if (topology == Topology::Kind::Plane) return -1;
+        return (cell % size + size) % size;
+    };
+    std::vector<int64_t> columns(tableWidth - 1);
+    for (size_t x = 0; x < columns.size(); x++) columns[x] = source(static_cast<int64_t>(x), width);
+
+    const uint8_t* cells = current.getCells().data();
+    for (size_t y = 0; y + 1 < tableHeight; y++) {
+        const int64_t row = source(static_cast<int64_t>(y), height);
+        const uint32_t* above = table.data() + y * tableWidth;
+        uint32_t* entry = table.data() + (y + 1) * tableWidth;
+        uint32_t rowSum = 0;
+        for (size_t x = 0; x < columns.size(); x++) {
+            if (row >= 0 && columns[x] >= 0) rowSum += cells[row * width + columns[x]];
+            entry[x + 1] = above[x + 1] + rowSum;
+        }
+    }
+}
+
+void LtlEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("LtlEngine::step");
+    const uint32_t width = current.getWidth();
+    const uint32_t height = current.getHeight();
+    if (width == 0 || height == 0) return;
+    const size_t tableWidth = width + 2 * rule.radius + 1;
+    const size_t side = 2 * rule.radius + 1;
+
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        buildTable();
+        const uint8_t* cells = current.getCells().data();
+        uint8_t* nextCells = next.getCells().data();
+        for (uint32_t y = 0; y < height; y++) {
+            // The square of cell (x, y) is extended [x, x + 2R] x [y, y + 2R]
+            const uint32_t* top = table.data() + y * tableWidth;
+            const uint32_t* bottom = table.data() + (y + side) * tableWidth;
+            for (uint32_t x = 0; x < width; x++) {
+                const size_t i = static_cast<size_t>(y) * width + x;
+                uint32_t count = bottom[x + side] + top[x] - top[x + side] - bottom[x];
+                if (!rule.includeCenter) count -= cells[i];
+                nextCells[i] = rule.nextState(cells[i] != 0, count) ? 1 : 0;
+            }
+        }
+        std::swap(current, next);
+    }
+}
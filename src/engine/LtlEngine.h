@@ -0,0 +1,38 @@
+#pragma once
+#include "Engine.h"
+#include "LtlRule.h"
+
+// Larger than Life engine (LtlRule, Conway's Life by default so it matches the other engines). Every generation
+// first builds a summed-area table of the board extended by the radius on each side, then reads each cell's count
+// from the four corners of its square: the cost per cell does not grow with the radius, unlike (2R + 1)^2 reads.
+// Life's ltlRowsMain, ltlColumnsMain and ltlMain do the same on the GPU. Torus and plane only, other gluings
+// would need a halo as deep as the radius
+class LtlEngine : public Engine
+{
+private:
+    LtlRule rule;
+    Grid current;
+    Grid next;
+    // (width + 2 * radius + 1) x (height + 2 * radius + 1). Row and column 0 are zero, entry (x + 1, y + 1) sums the
+    // extended board up to and including (x, y), where extended (x, y) is board cell (x - radius, y - radius)
+    std::vector<uint32_t> table;
+    Topology::Kind topology = Topology::Kind::Torus;
+
+    void buildTable();
+
+public:
+    explicit LtlEngine(const LtlRule& rule = LtlRule::conway());
+
+    // Takes effect with the next step, the board is kept
+    void setRule(const LtlRule& rule);
+    const LtlRule& getRule() const { return rule; }
+
+    std::string_view getName() const override { return "ltl"; }
+    void load(const Grid& grid) override;
+    void store(Grid& grid) const override;
+    void step(uint32_t generations = 1) override;
+    uint64_t population() const override { return current.population(); }
+    // Throws Engine::ConfigurationError for anything but the torus and the plane
+    void setTopology(Topology::Kind kind) override;
+    Topology::Kind getTopology() const override { return topology; }
+};
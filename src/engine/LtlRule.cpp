@@ -0,0 +1,114 @@
+#include "LtlRule.h"
+#include "Engine.h"
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// Non-empty decimal number, the whole of text
+uint32_t parseNumber(std::string_view text, std::string_view rule)
+{
+    const bool digits = std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
+    if (text.empty() || text.size() > 9 || !digits) {
+        throw Engine::ConfigurationError("bad number in rule '" + std::string(rule) + "'");
+    }
+    uint32_t value = 0;
+    for (const char c : text) value = value * 10 + static_cast<uint32_t>(c - '0');
+    return value;
+}
+
+// "min..max", or a single count
+std::pair<uint32_t, uint32_t> parseRange(std::string_view text, std::string_view rule)
+{
+    const size_t dots = text.find("..");
+    if (dots == std::string_view::npos) {
+        const uint32_t value = parseNumber(text, rule);
+        return {value, value};
+    }
+    return {parseNumber(text.substr(0, dots), rule), parseNumber(text.substr(dots + 2), rule)};
+}
+
+}
+
+LtlRule LtlRule::parse(std::string_view text)
+{
+    for (const auto& [name, rule] : NAMES) {
+        if (name == text) return parse(rule);
+    }
+
+    std::vector<std::string_view> fields;
+    for (size_t start = 0; start <= text.size();) {
+        const size_t comma = std::min(text.find(',', start), text.size());
+        fields.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+
+    LtlRule rule;
+    bool hasRadius = false;
+    bool hasBirth = false;
+    bool hasSurvival = false;
+    for (const std::string_view field : fields) {
+        if (field.empty()) throw Engine::ConfigurationError("empty field in rule '" + std::string(text) + "'");
+        const std::string_view value = field.substr(1);
+        switch (field[0]) {
+            case 'R':
+                rule.radius = parseNumber(value, text);
+                hasRadius = true;
+                break;
+            case 'C':
+                // C0 and C2 both mean two states, more would be a Generations rule
+                if (parseNumber(value, text) > 2) {
+                    throw Engine::ConfigurationError("only two states are supported, not '" + std::string(text) + "'");
+                }
+                break;
+            case 'M':
+                rule.includeCenter = parseNumber(value, text) != 0;
+                break;
+            case 'S':
+                std::tie(rule.surviveMin, rule.surviveMax) = parseRange(value, text);
+                hasSurvival = true;
+                break;
+            case 'B':
+                std::tie(rule.birthMin, rule.birthMax) = parseRange(value, text);
+                hasBirth = true;
+                break;
+            case 'N':
+                // The summed-area table counts squares, von Neumann and circular neighbourhoods are not squares
+                if (value != "M") {
+                    throw Engine::ConfigurationError("only the Moore neighbourhood (NM) is supported, not '" +
+                                                     std::string(text) + "'");
+                }
+                break;
+            default:
+                throw Engine::ConfigurationError("unknown rule '" + std::string(text) + "'");
+        }
+    }
+    if (!hasRadius || !hasBirth || !hasSurvival) {
+        throw Engine::ConfigurationError("rule '" + std::string(text) + "' needs R, S and B");
+    }
+    if (rule.radius < 1 || rule.radius > MAX_RADIUS) {
+        throw Engine::ConfigurationError("the radius must be in [1, " + std::to_string(MAX_RADIUS) + "], not " +
+                                         std::to_string(rule.radius));
+    }
+    const uint32_t cells = (2 * rule.radius + 1) * (2 * rule.radius + 1);
+    if (rule.birthMin > rule.birthMax || rule.surviveMin > rule.surviveMax || rule.birthMax > cells ||
+        rule.surviveMax > cells) {
+        throw Engine::ConfigurationError("bad count range in rule '" + std::string(text) + "'");
+    }
+    // A birth with no live cell around would fill the whole board from nothing
+    if (rule.birthMin == 0) throw Engine::ConfigurationError("births need a live cell around (B0 is not supported)");
+    return rule;
+}
+
+std::string LtlRule::toString() const
+{
+    std::string text = "R";
+    text += std::to_string(radius);
+    text += includeCenter ? ",C0,M1,S" : ",C0,M0,S";
+    text += std::to_string(surviveMin) + ".." + std::to_string(surviveMax);
+    text += ",B";
+    text += std::to_string(birthMin) + ".." + std::to_string(birthMax);
+    text += ",NM";
+    return text;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Larger than Life rule: a cell counts the live cells in the (2 * radius + 1)^2 square around it (itself included
+// when includeCenter), is born with a count in [birthMin, birthMax] and survives with one in [surviveMin, surviveMax].
+// Written in Golly's notation "R5,C0,M1,S34..58,B34..45,NM" (two states, Moore neighbourhood only). Conway's Life is
+// R1,C0,M0,S2..3,B3..3,NM. LtlEngine and Life's ltlMain count the square from a summed-area table, so a step costs
+// about the same for any radius
+class LtlRule
+{
+public:
+    // Largest radius Life's table buffer is sized for
+    static constexpr uint32_t MAX_RADIUS = 32;
+
+    uint32_t radius = 1;
+    bool includeCenter = false;
+    uint32_t birthMin = 3;
+    uint32_t birthMax = 3;
+    uint32_t surviveMin = 2;
+    uint32_t surviveMax = 3;
+
+    // Golly notation or one of NAMES. Throws Engine::ConfigurationError for anything else, more than two states,
+    // another neighbourhood than NM, or a radius above MAX_RADIUS
+    static LtlRule parse(std::string_view text);
+    static LtlRule conway() { return LtlRule{}; }
+    std::string toString() const;
+
+    // Live cells in the square, neighbours only unless includeCenter
+    uint32_t getNeighbourhoodSize() const { return (2 * radius + 1) * (2 * radius + 1) - (includeCenter ? 0 : 1); }
+    bool isConway() const { return *this == conway(); }
+    // Next state of a cell with count live cells in its square (itself included when includeCenter)
+    bool nextState(bool alive, uint32_t count) const
+    {
+        return alive ? count >= surviveMin && count <= surviveMax : count >= birthMin && count <= birthMax;
+    }
+
+    bool operator==(const LtlRule& other) const
+    {
+        return radius == other.radius && includeCenter == other.includeCenter && birthMin == other.birthMin &&
+               birthMax == other.birthMax && surviveMin == other.surviveMin && surviveMax == other.surviveMax;
+    }
+    bool operator!=(const LtlRule& other) const { return !(*this == other); }
+
+    // Named rules from the Larger than Life literature, in Golly notation
+    static constexpr std::array<std::pair<std::string_view, std::string_view>, 5> NAMES = {{
+        {"life", "R1,C0,M0,S2..3,B3..3,NM"},
+        {"bosco", "R5,C0,M1,S34..58,B34..45,NM"},
+        {"majority", "R4,C0,M1,S41..81,B41..81,NM"},
+        {"waffle", "R7,C0,M1,S100..200,B75..170,NM"},
+        {"globe", "R8,C0,M0,S163..223,B74..252,NM"},
+    }};
+};
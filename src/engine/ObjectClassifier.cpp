@@ -0,0 +1,234 @@
+#include "ObjectClassifier.h"
+#include "Engine.h"
+#include "Bitboard.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+void appendEmptyColumns(std::string& code, uint32_t count)
+{
+    while (count > 0) {
+        if (count == 1) {
+            code += '0';
+            count = 0;
+        } else if (count == 2) {
+            code += 'w';
+            count = 0;
+        } else if (count == 3) {
+            code += 'x';
+            count = 0;
+        } else {
+            const uint32_t run = std::min<uint32_t>(count, 39);
+            code += 'y';
+            code += DIGITS[run - 4];
+            count -= run;
+        }
+    }
+}
+
+}
+
+ObjectClassifier::ObjectClassifier()
+    : engine(Engine::create("packed"))
+{
+}
+
+ObjectClassifier::~ObjectClassifier() = default;
+
+template <typename Visit>
+bool ObjectClassifier::simulate(const Cells& cells, uint32_t generations, Visit&& visit)
+{
+    if (cells.empty()) return false;
+    int32_t minX = std::numeric_limits<int32_t>::max(), minY = minX;
+    int32_t maxX = std::numeric_limits<int32_t>::min(), maxY = maxX;
+    for (const Cell& cell : cells) {
+        minX = std::min(minX, cell.x);
+        minY = std::min(minY, cell.y);
+        maxX = std::max(maxX, cell.x);
+        maxY = std::max(maxY, cell.y);
+    }
+
+    // Nothing in Life moves faster than c/2, so this margin fits any spaceship up to the period limit.
+    // The board is a torus, so reaching its last two rows or columns ends the run before anything wraps
+    const int32_t margin = static_cast<int32_t>(std::min(generations, MAX_PERIOD)) / 2 + 3;
+    const int32_t word = static_cast<int32_t>(Bitboard::BITS_PER_WORD);
+    const int32_t width = (maxX - minX + 1 + 2 * margin + word - 1) / word * word;
+    const int32_t height = maxY - minY + 1 + 2 * margin;
+    const int32_t originX = minX - margin;
+    const int32_t originY = minY - margin;
+
+    Grid grid {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+    for (const Cell& cell : cells) {
+        grid.setCell(static_cast<uint32_t>(cell.x - originX), static_cast<uint32_t>(cell.y - originY), 1);
+    }
+    engine->load(grid);
+
+    Cells phase;
+    for (uint32_t generation = 1; generation <= generations; generation++) {
+        engine->step();
+        engine->store(grid);
+        phase.clear();
+        const std::vector<uint8_t>& states = grid.getCells();
+        for (int32_t y = 0; y < height; y++) {
+            const uint8_t* row = states.data() + static_cast<size_t>(y) * width;
+            for (int32_t x = 0; x < width; x++) {
+                if (!row[x]) continue;
+                if (x < 2 || y < 2 || x >= width - 2 || y >= height - 2) return false;
+                phase.push_back({x + originX, y + originY});
+            }
+        }
+        if (!visit(generation, phase)) return true;
+    }
+    return true;
+}
+
+ObjectClassifier::Classification ObjectClassifier::identify(const Cells& cells)
+{
+    const Cells first = normalize(cells);
+    int32_t originX = std::numeric_limits<int32_t>::max(), originY = originX;
+    for (const Cell& cell : cells) {
+        originX = std::min(originX, cell.x);
+        originY = std::min(originY, cell.y);
+    }
+
+    Classification result;
+    std::vector<Cells> phases {first};
+    simulate(cells, MAX_PERIOD, [&](uint32_t generation, const Cells& phase) {
+        if (phase.empty()) return false;
+        Cells shape = normalize(phase);
+        if (shape == first) {
+            int32_t x = std::numeric_limits<int32_t>::max(), y = x;
+            for (const Cell& cell : phase) {
+                x = std::min(x, cell.x);
+                y = std::min(y, cell.y);
+            }
+            result.period = generation;
+            result.dx = x - originX;
+            result.dy = y - originY;
+            return false;
+        }
+        phases.push_back(std::move(shape));
+        return true;
+    });
+
+    if (result.period == 0) {
+        result.apgcode = "zz_UNKNOWN";
+        return result;
+    }
+
+    char letter = 'p';
+    uint64_t number = result.period;
+    if (result.dx != 0 || result.dy != 0) {
+        result.kind = Kind::Spaceship;
+        letter = 'q';
+    } else if (result.period == 1) {
+        result.kind = Kind::StillLife;
+        letter = 's';
+        number = first.size();
+    } else {
+        result.kind = Kind::Oscillator;
+    }
+
+    bool oversized = false;
+    for (const Cells& phase : phases) {
+        for (const Cell& cell : phase) {
+            oversized |= cell.x >= MAX_CODED_SIZE || cell.y >= MAX_CODED_SIZE;
+        }
+    }
+    result.apgcode = oversized
+        ? std::string("ov_") + letter + std::to_string(number)
+        : std::string("x") + letter + std::to_string(number) + "_" + canonicalWechsler(phases);
+    return result;
+}
+
+const ObjectClassifier::Classification& ObjectClassifier::classify(const Cells& cells)
+{
+    // Keyed by shape, every phase and orientation of an object ends up as its own entry
+    const std::string key = wechsler(normalize(cells));
+    const auto cached = cache.find(key);
+    if (cached != cache.end()) return cached->second;
+    return cache.emplace(key, identify(cells)).first->second;
+}
+
+std::vector<ObjectClassifier::Cells> ObjectClassifier::evolve(const Cells& cells, uint32_t generations)
+{
+    std::vector<Cells> phases {cells};
+    simulate(cells, generations, [&phases](uint32_t, const Cells& phase) {
+        phases.push_back(phase);
+        return true;
+    });
+    return phases;
+}
+
+ObjectClassifier::Cells ObjectClassifier::normalize(Cells cells)
+{
+    if (cells.empty()) return cells;
+    int32_t minX = std::numeric_limits<int32_t>::max(), minY = minX;
+    for (const Cell& cell : cells) {
+        minX = std::min(minX, cell.x);
+        minY = std::min(minY, cell.y);
+    }
+    for (Cell& cell : cells) {
+        cell.x -= minX;
+        cell.y -= minY;
+    }
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+std::string ObjectClassifier::wechsler(const Cells& cells)
+{
+    int32_t width = 0, height = 0;
+    for (const Cell& cell : cells) {
+        width = std::max(width, cell.x + 1);
+        height = std::max(height, cell.y + 1);
+    }
+
+    // Column digits of every strip, bit 0 is the strip's top row
+    const int32_t strips = (height + 4) / 5;
+    std::vector<uint8_t> columns(static_cast<size_t>(strips) * width, 0);
+    for (const Cell& cell : cells) {
+        columns[static_cast<size_t>(cell.y / 5) * width + cell.x] |= static_cast<uint8_t>(1u << (cell.y % 5));
+    }
+
+    std::string code;
+    for (int32_t strip = 0; strip < strips; strip++) {
+        if (strip > 0) code += 'z';
+        // Empty columns are only written once a later column needs them, trailing ones are dropped
+        uint32_t emptyColumns = 0;
+        for (int32_t x = 0; x < width; x++) {
+            const uint8_t digit = columns[static_cast<size_t>(strip) * width + x];
+            if (digit == 0) {
+                emptyColumns++;
+                continue;
+            }
+            appendEmptyColumns(code, emptyColumns);
+            emptyColumns = 0;
+            code += DIGITS[digit];
+        }
+    }
+    return code;
+}
+
+std::string ObjectClassifier::canonicalWechsler(const std::vector<Cells>& phases)
+{
+    std::string best;
+    for (const Cells& phase : phases) {
+        for (uint32_t orientation = 0; orientation < 8; orientation++) {
+            Cells oriented = phase;
+            for (Cell& cell : oriented) {
+                if (orientation & 1) cell.x = -cell.x;
+                if (orientation & 2) cell.y = -cell.y;
+                if (orientation & 4) std::swap(cell.x, cell.y);
+            }
+            std::string code = wechsler(normalize(std::move(oriented)));
+            if (best.empty() || code.size() < best.size() || (code.size() == best.size() && code < best)) {
+                best = std::move(code);
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Engine;
+
+// Identifies a single object by running it on its own: still life, oscillator, spaceship or unknown,
+// and names it by its apgcode, the canonical name used by apgsearch and Catagolue
+// (xs4_33 is the block, xp2_7 the blinker, xq4_153 the glider). Results are cached per shape
+class ObjectClassifier
+{
+public:
+    struct Cell {
+        int32_t x;
+        int32_t y;
+        auto operator<=>(const Cell& other) const { return y != other.y ? y <=> other.y : x <=> other.x; }
+        bool operator==(const Cell& other) const = default;
+    };
+    using Cells = std::vector<Cell>;
+
+    enum class Kind {
+        StillLife,
+        Oscillator,
+        Spaceship,
+        Unknown,
+    };
+    struct Classification {
+        Kind kind = Kind::Unknown;
+        std::string apgcode;
+        uint32_t period = 0;
+        // Displacement per period, zero unless kind is Spaceship
+        int32_t dx = 0;
+        int32_t dy = 0;
+    };
+
+    // Longest period (or spaceship period) that is searched for
+    static constexpr uint32_t MAX_PERIOD = 64;
+    // Objects whose bounding box exceeds this in any phase get an ov_ (oversized) code instead of a full apgcode
+    static constexpr int32_t MAX_CODED_SIZE = 40;
+
+private:
+    std::unique_ptr<Engine> engine;
+    std::unordered_map<std::string, Classification> cache;
+
+    // Runs cells alone, calling visit(generation, cells) in the input coordinates after every generation
+    // until visit returns false, generations have passed, or the pattern reaches the edge of its board (returns false)
+    template <typename Visit>
+    bool simulate(const Cells& cells, uint32_t generations, Visit&& visit);
+    Classification identify(const Cells& cells);
+
+public:
+    ObjectClassifier();
+    ~ObjectClassifier();
+    ObjectClassifier(const ObjectClassifier&) = delete;
+    ObjectClassifier& operator=(const ObjectClassifier&) = delete;
+
+    const Classification& classify(const Cells& cells);
+    // Phases 0..generations of cells evolving alone (same coordinates as cells), fewer if it outgrows its board
+    std::vector<Cells> evolve(const Cells& cells, uint32_t generations);
+
+    // Moves cells so the bounding box starts at (0, 0), and sorts them
+    static Cells normalize(Cells cells);
+    // Extended Wechsler format of normalized cells: 5-row strips of base-32 column digits separated by z,
+    // with w, x and y<n> for runs of 2, 3 and 4 + n empty columns
+    static std::string wechsler(const Cells& cells);
+    // Shortest (then alphabetically first) Wechsler string over every phase and all 8 orientations
+    static std::string canonicalWechsler(const std::vector<Cells>& phases);
+};
@@ -0,0 +1,32 @@
+#include "PackedEngine.h"
+#include "Trace.h"
+
+void PackedEngine::stepBoard()
+{
+    TRACE_SCOPE("PackedEngine::stepBoard");
+    stepRows(current, next, 0, current.getHeight());
+}
+
+void PackedEngine::stepRows(const Bitboard& in, Bitboard& out, uint32_t firstRow, uint32_t lastRow)
+{
+    const uint32_t words = in.getWordsPerRow();
+    for (uint32_t y = firstRow; y < lastRow; y++) {
+        const uint64_t* above = in.row(static_cast<int64_t>(y) - 1);
+        const uint64_t* middle = in.row(y);
+        const uint64_t* below = in.row(y + 1);
+        uint64_t* result = out.row(y);
+        uint64_t changed = 0;
+        for (uint32_t w = 0; w < words; w++) {
+            const uint64_t* a = above + w;
+            const uint64_t* m = middle + w;
+            const uint64_t* b = below + w;
+            result[w] = Bitboard::evolve(
+                Bitboard::shiftWest(a[0], a[-1]), a[0], Bitboard::shiftEast(a[0], a[1]),
+                Bitboard::shiftWest(m[0], m[-1]), m[0], Bitboard::shiftEast(m[0], m[1]),
+                Bitboard::shiftWest(b[0], b[-1]), b[0], Bitboard::shiftEast(b[0], b[1])
+            );
+            changed |= result[w] ^ m[0];
+        }
+        out.setRowChanged(y, changed != 0);
+    }
+}
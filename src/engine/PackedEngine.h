@@ -0,0 +1,15 @@
+#pragma once
+#include "BitboardEngine.h"
+
+// 64 cells per word, one word at a time
+class PackedEngine : public BitboardEngine
+{
+protected:
+    void stepBoard() override;
+
+public:
+    std::string_view getName() const override { return "packed"; }
+
+    // Steps rows [firstRow, lastRow) of in into out and flags the rows that changed, in must have its halo filled
+    static void stepRows(const Bitboard& in, Bitboard& out, uint32_t firstRow, uint32_t lastRow);
+};
@@ -0,0 +1,181 @@
+#include "Pattern.h"
+#include "Trace.h"
+#include <cctype>
+#include <utility>
+
+Pattern::Pattern(std::string name, Grid cells)
+    : name(std::move(name))
+    , cells(std::move(cells))
+{
+}
+
+Pattern Pattern::fromRle(std::string_view rle, std::string name)
+{
+    TRACE_SCOPE("Pattern::fromRle");
+    // Header ("x = 3, y = 3, rule = B3/S23") and '#' comment lines come before the cell data
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool haveHeader = false;
+    size_t position = 0;
+    while (position < rle.size() && !haveHeader) {
+        size_t lineEnd = rle.find('\n', position);
+        if (lineEnd == std::string_view::npos) lineEnd = rle.size();
+        std::string_view line = rle.substr(position, lineEnd - position);
+        position = lineEnd + 1;
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) continue;
+        line.remove_prefix(first);
+        if (line.front() == '#') {
+            if (line.size() > 3 && line[1] == 'N' && name.empty()) {
+                name = std::string(line.substr(3));
+                while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back()))) name.pop_back();
+            }
+            continue;
+        }
+        if (line.front() != 'x') throw Pattern::ParseError("missing 'x = ..., y = ...' header");
+
+        auto readField = [&line](char key) -> uint32_t {
+            for (size_t i = 0; i < line.size(); i++) {
+                if (line[i] != key || (i > 0 && std::isalpha(static_cast<unsigned char>(line[i - 1])))) continue;
+                size_t j = line.find('=', i);
+                if (j == std::string_view::npos) break;
+                j = line.find_first_not_of(" \t", j + 1);
+                uint32_t value = 0;
+                while (j < line.size() && std::isdigit(static_cast<unsigned char>(line[j]))) {
+                    value = value * 10 + static_cast<uint32_t>(line[j++] - '0');
+                }
+                return value;
+            }
+            throw Pattern::ParseError(std::string("header is missing '") + key + "'");
+        };
+        width = readField('x');
+        height = readField('y');
+        haveHeader = true;
+    }
+    if (!haveHeader) throw Pattern::ParseError("empty input");
+
+    Grid cells(width, height);
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t run = 0;
+    for (; position < rle.size(); position++) {
+        const char c = rle[position];
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            run = run * 10 + static_cast<uint32_t>(c - '0');
+            continue;
+        }
+        if (std::isspace(static_cast<unsigned char>(c))) continue;
+        if (c == '!') break;
+
+        const uint32_t count = run == 0 ? 1 : run;
+        run = 0;
+        if (c == '$') {
+            y += count;
+            x = 0;
+        } else if (c == 'b' || c == '.') {
+            x += count;
+        } else if (std::isalpha(static_cast<unsigned char>(c))) {
+            // 'o' and multi-state letters are all treated as alive
+            if (y >= height || x + count > width) throw Pattern::ParseError("cells outside the declared bounding box");
+            for (uint32_t i = 0; i < count; i++) {
+                cells.setCell(x++, y, 1);
+            }
+        } else {
+            throw Pattern::ParseError(std::string("unexpected character '") + c + "'");
+        }
+    }
+    return Pattern(std::move(name), std::move(cells));
+}
+
+std::string Pattern::toRle() const
+{
+    TRACE_SCOPE("Pattern::toRle");
+    constexpr size_t MAX_LINE_LENGTH = 70;
+    std::string body;
+    size_t lineLength = 0;
+    auto emit = [&](uint32_t count, char tag) {
+        if (count == 0) return;
+        std::string token = (count > 1 ? std::to_string(count) : std::string()) + tag;
+        if (lineLength + token.size() > MAX_LINE_LENGTH) {
+            body += '\n';
+            lineLength = 0;
+        }
+        body += token;
+        lineLength += token.size();
+    };
+
+    uint32_t pendingRows = 0;
+    for (uint32_t y = 0; y < getHeight(); y++) {
+        // Trailing dead cells are implied, so each row only runs up to its last live cell
+        uint32_t rowEnd = getWidth();
+        while (rowEnd > 0 && !cells.getCell(rowEnd - 1, y)) rowEnd--;
+        if (rowEnd == 0) {
+            pendingRows++;
+            continue;
+        }
+        if (y > 0) emit(pendingRows + 1, '$');
+        pendingRows = 0;
+
+        uint32_t x = 0;
+        while (x < rowEnd) {
+            const uint8_t state = cells.getCell(x, y);
+            uint32_t run = 0;
+            while (x < rowEnd && cells.getCell(x, y) == state) {
+                x++;
+                run++;
+            }
+            emit(run, state ? 'o' : 'b');
+        }
+    }
+    emit(1, '!');
+
+    std::string header;
+    if (!name.empty()) header += "#N " + name + "\n";
+    header += "x = " + std::to_string(getWidth()) + ", y = " + std::to_string(getHeight()) + ", rule = B3/S23\n";
+    return header + body + "\n";
+}
+
+void Pattern::stamp(Grid& grid, uint32_t x, uint32_t y) const
+{
+    for (uint32_t py = 0; py < getHeight(); py++) {
+        for (uint32_t px = 0; px < getWidth(); px++) {
+            if (cells.getCell(px, py)) {
+                grid.setCell((x + px) % grid.getWidth(), (y + py) % grid.getHeight(), 1);
+            }
+        }
+    }
+}
+
+void Pattern::stampCentered(Grid& grid) const
+{
+    const uint32_t x = grid.getWidth() > getWidth() ? (grid.getWidth() - getWidth()) / 2 : 0;
+    const uint32_t y = grid.getHeight() > getHeight() ? (grid.getHeight() - getHeight()) / 2 : 0;
+    stamp(grid, x, y);
+}
+
+const std::vector<Pattern>& Pattern::getBuiltins()
+{
+    static const std::vector<Pattern> builtins = {
+        fromRle("x = 3, y = 3\nb2o$2ob$bo!", "r-pentomino"),
+        fromRle("x = 7, y = 3\nbo5b$3bo3b$2o2b3o!", "acorn"),
+        fromRle("x = 3, y = 3\nbo$2bo$3o!", "glider"),
+        fromRle(
+            "x = 36, y = 9\n"
+            "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4b\n"
+            "obo$10bo5bo7bo$11bo3bo$12b2o!",
+            "gosper-gun"
+        ),
+        // Ten-cell block-laying switch engine, the smallest known pattern with unbounded growth
+        fromRle("x = 8, y = 6\n6bob$4bob2o$4bobob$4bo3b$2bo5b$obo!", "switch-engine"),
+    };
+    return builtins;
+}
+
+const Pattern& Pattern::getBuiltin(std::string_view name)
+{
+    for (const auto& pattern : getBuiltins()) {
+        if (pattern.getName() == name) return pattern;
+    }
+    throw std::out_of_range("no builtin pattern named '" + std::string(name) + "'");
+}
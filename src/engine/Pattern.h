@@ -0,0 +1,40 @@
+#pragma once
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Grid.h"
+
+// A named pattern (bounding box of cells) with RLE import/export
+class Pattern
+{
+private:
+    std::string name;
+    Grid cells;
+
+public:
+    class ParseError : public std::runtime_error {
+        public:
+            ParseError(const std::string& msg)
+                : std::runtime_error("Failed to parse RLE: " + msg) {}
+    };
+
+    Pattern() = default;
+    Pattern(std::string name, Grid cells);
+
+    const std::string& getName() const { return name; }
+    const Grid& getCells() const { return cells; }
+    uint32_t getWidth() const { return cells.getWidth(); }
+    uint32_t getHeight() const { return cells.getHeight(); }
+
+    static Pattern fromRle(std::string_view rle, std::string name = "");
+    std::string toRle() const;
+
+    // Copies the live cells into grid with the pattern's top-left corner at (x, y), wrapping at the edges
+    void stamp(Grid& grid, uint32_t x, uint32_t y) const;
+    void stampCentered(Grid& grid) const;
+
+    // Canonical patterns used by the benchmark corpus
+    static const std::vector<Pattern>& getBuiltins();
+    static const Pattern& getBuiltin(std::string_view name);
+};
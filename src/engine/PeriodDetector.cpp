@@ -0,0 +1,56 @@
+#include "PeriodDetector.h"
+#include "Engine.h"
+#include "Trace.h"
+#include <algorithm>
+
+PeriodDetector::PeriodDetector(uint32_t historyLength)
+    : history(std::max<uint32_t>(historyLength, 1))
+{
+    generations.reserve(history.size());
+}
+
+void PeriodDetector::reset()
+{
+    nextEntry = 0;
+    entryCount = 0;
+    generations.clear();
+    cycle.reset();
+}
+
+std::optional<PeriodDetector::Cycle> PeriodDetector::observe(uint64_t generation, uint64_t hash)
+{
+    if (cycle) return cycle;
+
+    const auto seen = generations.find(hash);
+    if (seen != generations.end()) {
+        cycle = Cycle{generation - seen->second, seen->second};
+        return cycle;
+    }
+
+    // Forget the oldest hash, unless a later generation has since claimed the same table slot
+    if (entryCount == history.size()) {
+        const Entry& oldest = history[nextEntry];
+        const auto entry = generations.find(oldest.hash);
+        if (entry != generations.end() && entry->second == oldest.generation) generations.erase(entry);
+    } else {
+        entryCount++;
+    }
+    history[nextEntry] = {hash, generation};
+    nextEntry = (nextEntry + 1) % history.size();
+    generations[hash] = generation;
+    return std::nullopt;
+}
+
+std::optional<PeriodDetector::Cycle> PeriodDetector::run(Engine& engine, uint64_t maxGenerations, uint32_t historyLength)
+{
+    TRACE_SCOPE("PeriodDetector::run");
+    PeriodDetector detector {historyLength};
+    engine.setHashTracking(true);
+    std::optional<Cycle> result = detector.observe(0, engine.stateHash());
+    for (uint64_t generation = 1; !result && generation <= maxGenerations; generation++) {
+        engine.step();
+        result = detector.observe(generation, engine.stateHash());
+    }
+    engine.setHashTracking(false);
+    return result;
+}
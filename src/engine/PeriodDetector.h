@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+class Engine;
+
+// Finds the first repeated board in a stream of per-generation StateHash values.
+// The last historyLength hashes are kept in a ring plus a hash -> generation table,
+// so any period up to historyLength is reported as soon as it closes
+class PeriodDetector
+{
+public:
+    // The board at firstGeneration recurs every period generations (a dead or still board has period 1)
+    struct Cycle {
+        uint64_t period;
+        uint64_t firstGeneration;
+    };
+
+    static constexpr uint32_t DEFAULT_HISTORY_LENGTH = 4096;
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint64_t generation;
+    };
+
+    std::vector<Entry> history;
+    size_t nextEntry = 0;
+    size_t entryCount = 0;
+    std::unordered_map<uint64_t, uint64_t> generations;
+    std::optional<Cycle> cycle;
+
+public:
+    explicit PeriodDetector(uint32_t historyLength = DEFAULT_HISTORY_LENGTH);
+
+    void reset();
+    // Records the hash of the board at generation (generations must increase, consecutive for an exact period).
+    // Returns the cycle once one is found, and keeps returning it until reset
+    std::optional<Cycle> observe(uint64_t generation, uint64_t hash);
+    const std::optional<Cycle>& getCycle() const { return cycle; }
+
+    // Steps engine one generation at a time (with hash tracking on) until its board repeats,
+    // or returns nullopt after maxGenerations
+    static std::optional<Cycle> run(Engine& engine, uint64_t maxGenerations,
+                                    uint32_t historyLength = DEFAULT_HISTORY_LENGTH);
+};
@@ -0,0 +1,238 @@
+#include "PngEncoder.h"
+#include "Trace.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t WINDOW_SIZE = 1u << 15;
+constexpr uint32_t MIN_MATCH = 3;
+constexpr uint32_t MAX_MATCH = 258;
+constexpr uint32_t HASH_BITS = 15;
+// Candidates tried per position, more barely helps on board images
+constexpr uint32_t MAX_CHAIN = 16;
+constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+constexpr std::array<uint16_t, 29> LENGTH_BASE = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> LENGTH_EXTRA = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<uint16_t, 30> DISTANCE_BASE = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+    6145, 8193, 12289, 16385, 24577};
+constexpr std::array<uint8_t, 30> DISTANCE_EXTRA = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Bits are packed from the least significant end, Huffman codes go in most significant bit first
+class BitWriter
+{
+private:
+    std::vector<uint8_t>& out;
+    uint64_t buffer = 0;
+    uint32_t count = 0;
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void write(uint32_t value, uint32_t bits)
+    {
+        buffer |= static_cast<uint64_t>(value) << count;
+        count += bits;
+        while (count >= 8) {
+            out.push_back(static_cast<uint8_t>(buffer));
+            buffer >>= 8;
+            count -= 8;
+        }
+    }
+
+    void writeCode(uint32_t code, uint32_t bits)
+    {
+        uint32_t reversed = 0;
+        for (uint32_t i = 0; i < bits; i++) {
+            reversed |= ((code >> i) & 1u) << (bits - 1 - i);
+        }
+        write(reversed, bits);
+    }
+
+    void flush()
+    {
+        if (count > 0) out.push_back(static_cast<uint8_t>(buffer));
+        buffer = 0;
+        count = 0;
+    }
+};
+
+// Fixed literal/length code of RFC 1951 section 3.2.6
+void writeLiteralLength(BitWriter& bits, uint32_t symbol)
+{
+    if (symbol < 144) bits.writeCode(0x30 + symbol, 8);
+    else if (symbol < 256) bits.writeCode(0x190 + symbol - 144, 9);
+    else if (symbol < 280) bits.writeCode(symbol - 256, 7);
+    else bits.writeCode(0xC0 + symbol - 280, 8);
+}
+
+void writeMatch(BitWriter& bits, uint32_t length, uint32_t distance)
+{
+    const size_t lengthCode = std::upper_bound(LENGTH_BASE.begin(), LENGTH_BASE.end(), length) - LENGTH_BASE.begin() - 1;
+    writeLiteralLength(bits, 257 + static_cast<uint32_t>(lengthCode));
+    bits.write(length - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+
+    const size_t distanceCode = std::upper_bound(DISTANCE_BASE.begin(), DISTANCE_BASE.end(), distance) - DISTANCE_BASE.begin() - 1;
+    bits.writeCode(static_cast<uint32_t>(distanceCode), 5);
+    bits.write(distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+}
+
+uint32_t hash3(const uint8_t* data)
+{
+    const uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+    return (value * 0x9E3779B1u) >> (32 - HASH_BITS);
+}
+
+void appendBigEndian(std::vector<uint8_t>& out, uint32_t value)
+{
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void appendChunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& data)
+{
+    appendBigEndian(out, static_cast<uint32_t>(data.size()));
+    const size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendBigEndian(out, PngEncoder::crc32(out.data() + typeStart, out.size() - typeStart));
+}
+
+}
+
+std::vector<uint8_t> PngEncoder::deflate(const uint8_t* data, size_t size)
+{
+    TRACE_SCOPE("PngEncoder::deflate");
+    std::vector<uint8_t> out;
+    out.reserve(size / 8 + 64);
+    BitWriter bits(out);
+    bits.write(1, 1);  // BFINAL, a single block
+    bits.write(1, 2);  // BTYPE 01, fixed Huffman codes
+
+    // Hash chains over the window: head is the newest position with a hash, previous links to the one before it
+    std::vector<uint32_t> head(1u << HASH_BITS, NO_POSITION);
+    std::vector<uint32_t> previous(WINDOW_SIZE, NO_POSITION);
+    auto insert = [&](size_t position) {
+        const uint32_t hash = hash3(data + position);
+        previous[position % WINDOW_SIZE] = head[hash];
+        head[hash] = static_cast<uint32_t>(position);
+    };
+
+    size_t position = 0;
+    while (position < size) {
+        uint32_t bestLength = 0;
+        uint32_t bestDistance = 0;
+        if (position + MIN_MATCH <= size) {
+            const uint32_t maxLength = static_cast<uint32_t>(std::min<size_t>(MAX_MATCH, size - position));
+            uint32_t candidate = head[hash3(data + position)];
+            for (uint32_t chain = 0; chain < MAX_CHAIN && candidate != NO_POSITION; chain++) {
+                const size_t distance = position - candidate;
+                if (distance > WINDOW_SIZE - 1) break;
+                uint32_t length = 0;
+                while (length < maxLength && data[candidate + length] == data[position + length]) {
+                    length++;
+                }
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = static_cast<uint32_t>(distance);
+                    if (length == maxLength) break;
+                }
+                const uint32_t next = previous[candidate % WINDOW_SIZE];
+                // Slots are reused once the window moves on, an older link would point forward again
+                if (next == NO_POSITION || next >= candidate) break;
+                candidate = next;
+            }
+        }
+
+        if (bestLength >= MIN_MATCH) {
+            writeMatch(bits, bestLength, bestDistance);
+            for (size_t end = position + bestLength; position < end; position++) {
+                if (position + MIN_MATCH <= size) insert(position);
+            }
+        } else {
+            writeLiteralLength(bits, data[position]);
+            if (position + MIN_MATCH <= size) insert(position);
+            position++;
+        }
+    }
+    writeLiteralLength(bits, 256);  // End of block
+    bits.flush();
+    return out;
+}
+
+uint32_t PngEncoder::crc32(const uint8_t* data, size_t size, uint32_t crc)
+{
+    static const std::array<uint32_t, 256> TABLE = [] {
+        std::array<uint32_t, 256> table {};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 1u) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            table[i] = value;
+        }
+        return table;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t PngEncoder::adler32(const uint8_t* data, size_t size)
+{
+    constexpr uint32_t MODULUS = 65521;
+    // 5552 bytes is the most that can be summed before the 32-bit sums could overflow
+    constexpr size_t BLOCK = 5552;
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (size_t start = 0; start < size; start += BLOCK) {
+        const size_t end = std::min(size, start + BLOCK);
+        for (size_t i = start; i < end; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= MODULUS;
+        b %= MODULUS;
+    }
+    return (b << 16) | a;
+}
+
+std::vector<uint8_t> PngEncoder::encode(uint32_t width, uint32_t height, const uint8_t* rgb)
+{
+    TRACE_SCOPE("PngEncoder::encode");
+    // Every scanline starts with its filter type, 0 (none)
+    const size_t rowBytes = static_cast<size_t>(width) * 3;
+    std::vector<uint8_t> scanlines((rowBytes + 1) * height);
+    for (uint32_t y = 0; y < height; y++) {
+        scanlines[y * (rowBytes + 1)] = 0;
+        std::memcpy(&scanlines[y * (rowBytes + 1) + 1], rgb + y * rowBytes, rowBytes);
+    }
+
+    // zlib stream: header (deflate, 32 KiB window, no dictionary), raw deflate, Adler-32 of the scanlines
+    std::vector<uint8_t> idat = {0x78, 0x01};
+    const std::vector<uint8_t> compressed = deflate(scanlines.data(), scanlines.size());
+    idat.insert(idat.end(), compressed.begin(), compressed.end());
+    appendBigEndian(idat, adler32(scanlines.data(), scanlines.size()));
+
+    std::vector<uint8_t> ihdr;
+    appendBigEndian(ihdr, width);
+    appendBigEndian(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});  // 8 bits per channel, RGB, deflate, standard filter set, no interlace
+
+    static constexpr uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> png(SIGNATURE, SIGNATURE + 8);
+    appendChunk(png, "IHDR", ihdr);
+    appendChunk(png, "IDAT", idat);
+    appendChunk(png, "IEND", {});
+    return png;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minimal PNG writer for FrameRenderer images: 8-bit RGB, no row filters, one IDAT chunk compressed with a
+// self-contained deflate (greedy LZ77 over a 32 KiB window, fixed Huffman codes). Life frames are mostly runs of the
+// background colour and copies of the row above, which this finds without the cost of a dynamic-Huffman encoder
+class PngEncoder
+{
+public:
+    // rgb holds height rows of width * 3 bytes, top row first
+    static std::vector<uint8_t> encode(uint32_t width, uint32_t height, const uint8_t* rgb);
+
+    // Raw deflate stream (RFC 1951) of data, exposed for testing against zlib
+    static std::vector<uint8_t> deflate(const uint8_t* data, size_t size);
+    static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+    static uint32_t adler32(const uint8_t* data, size_t size);
+};
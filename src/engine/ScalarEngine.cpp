@@ -0,0 +1,73 @@
+#include "ScalarEngine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <utility>
+
+void ScalarEngine::load(const Grid& grid)
+{
+    Topology::validate(topology, grid.getWidth(), grid.getHeight());
+    current = grid;
+    next = Grid(grid.getWidth(), grid.getHeight());
+    padded.assign(static_cast<size_t>(grid.getWidth() + 2) * (grid.getHeight() + 2), 0);
+}
+
+void ScalarEngine::store(Grid& grid) const
+{
+    grid = current;
+}
+
+void ScalarEngine::setTopology(Topology::Kind kind)
+{
+    if (current.getWidth() > 0) Topology::validate(kind, current.getWidth(), current.getHeight());
+    topology = kind;
+}
+
+void ScalarEngine::fillPadded()
+{
+    const int64_t width = current.getWidth();
+    const int64_t height = current.getHeight();
+    const int64_t stride = width + 2;
+    for (int64_t y = 0; y < height; y++) {
+        std::copy_n(current.getCells().data() + y * width, width, padded.data() + (y + 1) * stride + 1);
+    }
+
+    auto fill = [&](int64_t x, int64_t y) {
+        const auto source = Topology::haloSource(topology, x, y, current.getWidth(), current.getHeight());
+        padded[(y + 1) * stride + x + 1] =
+            source ? current.getCell(static_cast<uint32_t>(source->x), static_cast<uint32_t>(source->y)) : 0;
+    };
+    for (int64_t x = -1; x <= width; x++) {
+        fill(x, -1);
+        fill(x, height);
+    }
+    for (int64_t y = 0; y < height; y++) {
+        fill(-1, y);
+        fill(width, y);
+    }
+}
+
+void ScalarEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("ScalarEngine::step");
+    const uint32_t width = current.getWidth();
+    const uint32_t height = current.getHeight();
+    if (width == 0 || height == 0) return;
+    const size_t stride = width + 2;
+
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        fillPadded();
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                const size_t i = (y + 1) * stride + x + 1;
+                const uint32_t activeNeighbors = padded[i - stride - 1] + padded[i - stride] + padded[i - stride + 1] +
+                                                 padded[i - 1] + padded[i + 1] +
+                                                 padded[i + stride - 1] + padded[i + stride] + padded[i + stride + 1];
+                uint8_t state = 0;
+                if (activeNeighbors == 2) state = padded[i];
+                else if (activeNeighbors == 3) state = 1;
+                next.setCell(x, y, state);
+            }
+        }
+        std::swap(current, next);
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Engine.h"
+
+// Reference engine: a direct port of computeMain (one byte per cell). Like the shader it steps a copy of the
+// board with a one-cell halo filled by the topology first, so the neighbour reads need no wrap arithmetic
+class ScalarEngine : public Engine
+{
+private:
+    Grid current;
+    Grid next;
+    // (width + 2) x (height + 2), board at (1, 1)
+    std::vector<uint8_t> padded;
+    Topology::Kind topology = Topology::Kind::Torus;
+
+    // Copies current into padded and fills its halo, the job of haloMain on the GPU
+    void fillPadded();
+
+public:
+    std::string_view getName() const override { return "scalar"; }
+    void load(const Grid& grid) override;
+    void store(Grid& grid) const override;
+    void step(uint32_t generations = 1) override;
+    uint64_t population() const override { return current.population(); }
+    void setTopology(Topology::Kind kind) override;
+    Topology::Kind getTopology() const override { return topology; }
+};
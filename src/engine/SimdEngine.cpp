@@ -0,0 +1,77 @@
+#include "SimdEngine.h"
+#include "Trace.h"
+#include <cstring>
+
+namespace {
+
+#if defined(__AVX2__)
+using Lanes = uint64_t __attribute__((vector_size(32)));
+#else
+using Lanes = uint64_t __attribute__((vector_size(16)));
+#endif
+constexpr uint32_t LANE_COUNT = sizeof(Lanes) / sizeof(uint64_t);
+
+// Rows are only word aligned (the ghost word shifts them), so loads and stores go through memcpy
+template <typename T>
+inline T readWords(const uint64_t* source)
+{
+    T value;
+    std::memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+template <typename T>
+inline void writeWords(uint64_t* destination, T value)
+{
+    std::memcpy(destination, &value, sizeof(value));
+}
+
+template <typename T>
+inline T evolveAt(const uint64_t* above, const uint64_t* middle, const uint64_t* below, uint32_t w)
+{
+    const T aboveCenter = readWords<T>(above + w);
+    const T middleCenter = readWords<T>(middle + w);
+    const T belowCenter = readWords<T>(below + w);
+    return Bitboard::evolve(
+        Bitboard::shiftWest(aboveCenter, readWords<T>(above + w - 1)), aboveCenter, Bitboard::shiftEast(aboveCenter, readWords<T>(above + w + 1)),
+        Bitboard::shiftWest(middleCenter, readWords<T>(middle + w - 1)), middleCenter, Bitboard::shiftEast(middleCenter, readWords<T>(middle + w + 1)),
+        Bitboard::shiftWest(belowCenter, readWords<T>(below + w - 1)), belowCenter, Bitboard::shiftEast(belowCenter, readWords<T>(below + w + 1))
+    );
+}
+
+}
+
+void SimdEngine::stepBoard()
+{
+    TRACE_SCOPE("SimdEngine::stepBoard");
+    stepRows(current, next, 0, current.getHeight());
+}
+
+void SimdEngine::stepRows(const Bitboard& in, Bitboard& out, uint32_t firstRow, uint32_t lastRow)
+{
+    const uint32_t words = in.getWordsPerRow();
+    for (uint32_t y = firstRow; y < lastRow; y++) {
+        const uint64_t* above = in.row(static_cast<int64_t>(y) - 1);
+        const uint64_t* middle = in.row(y);
+        const uint64_t* below = in.row(y + 1);
+        uint64_t* result = out.row(y);
+
+        Lanes changedLanes = {};
+        uint32_t w = 0;
+        for (; w + LANE_COUNT <= words; w += LANE_COUNT) {
+            const Lanes value = evolveAt<Lanes>(above, middle, below, w);
+            changedLanes |= value ^ readWords<Lanes>(middle + w);
+            writeWords(result + w, value);
+        }
+        // Rows narrower than a vector, or a leftover tail
+        uint64_t changed = 0;
+        for (; w < words; w++) {
+            result[w] = evolveAt<uint64_t>(above, middle, below, w);
+            changed |= result[w] ^ middle[w];
+        }
+        for (uint32_t lane = 0; lane < LANE_COUNT; lane++) {
+            changed |= changedLanes[lane];
+        }
+        out.setRowChanged(y, changed != 0);
+    }
+}
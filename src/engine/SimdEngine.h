@@ -0,0 +1,16 @@
+#pragma once
+#include "BitboardEngine.h"
+
+// Packed engine that steps several words per instruction using compiler vector extensions,
+// which lower to SSE/AVX on native builds and to SIMD128 on wasm builds compiled with -msimd128
+class SimdEngine : public BitboardEngine
+{
+protected:
+    void stepBoard() override;
+
+public:
+    std::string_view getName() const override { return "simd"; }
+
+    // Same contract as PackedEngine::stepRows
+    static void stepRows(const Bitboard& in, Bitboard& out, uint32_t firstRow, uint32_t lastRow);
+};
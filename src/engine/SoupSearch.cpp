@@ -0,0 +1,257 @@
+#include "SoupSearch.h"
+#include "Engine.h"
+#include "CounterRng.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+namespace {
+
+// 8-connected parts of a small cell list (a spaceship cluster), quadratic but clusters are tiny
+std::vector<ObjectClassifier::Cells> connectedParts(const ObjectClassifier::Cells& cells)
+{
+    std::vector<ObjectClassifier::Cells> parts;
+    std::vector<uint8_t> assigned(cells.size(), 0);
+    for (size_t start = 0; start < cells.size(); start++) {
+        if (assigned[start]) continue;
+        assigned[start] = 1;
+        ObjectClassifier::Cells part {cells[start]};
+        for (size_t next = 0; next < part.size(); next++) {
+            for (size_t i = 0; i < cells.size(); i++) {
+                if (assigned[i]) continue;
+                if (std::abs(cells[i].x - part[next].x) > 1 || std::abs(cells[i].y - part[next].y) > 1) continue;
+                assigned[i] = 1;
+                part.push_back(cells[i]);
+            }
+        }
+        parts.push_back(std::move(part));
+    }
+    return parts;
+}
+
+}
+
+SoupSearch::SoupSearch(const Options& options)
+    : options(options)
+    , engine(Engine::create(options.engine, 1))
+    , detector(2 * MAX_ASH_PERIOD)
+{
+    if (options.boardSize < 4 * SOUP_SIZE) {
+        throw Engine::ConfigurationError("soup search boards need to be at least 64 cells wide");
+    }
+}
+
+SoupSearch::~SoupSearch() = default;
+
+void SoupSearch::fillSoup(Grid& board, uint64_t seed, uint64_t soupIndex, double density)
+{
+    board.clear();
+    const CounterRng::Key key = CounterRng::makeKey(seed);
+    const uint32_t threshold = CounterRng::threshold(density);
+    const uint32_t left = (board.getWidth() - SOUP_SIZE) / 2;
+    const uint32_t top = (board.getHeight() - SOUP_SIZE) / 2;
+    const uint64_t first = soupIndex * SOUP_SIZE * SOUP_SIZE;
+    for (uint32_t y = 0; y < SOUP_SIZE; y++) {
+        for (uint32_t x = 0; x < SOUP_SIZE; x++) {
+            const bool alive = CounterRng::at(key, first + y * SOUP_SIZE + x) < threshold;
+            board.setCell(left + x, top + y, alive ? 1 : 0);
+        }
+    }
+}
+
+std::vector<SoupSearch::Cluster> SoupSearch::findClusters(const Grid& grid, int32_t reach,
+                                                          const std::vector<uint8_t>& widened) const
+{
+    const int32_t width = static_cast<int32_t>(grid.getWidth());
+    const int32_t height = static_cast<int32_t>(grid.getHeight());
+    const std::vector<uint8_t>& cells = grid.getCells();
+    const int32_t scan = widened.empty() ? reach : reach + 1;
+
+    std::vector<Cluster> clusters;
+    std::vector<uint8_t> visited(cells.size(), 0);
+    for (uint32_t start = 0; start < cells.size(); start++) {
+        if (!cells[start] || visited[start]) continue;
+        visited[start] = 1;
+        Cluster cluster;
+        cluster.cells.push_back({static_cast<int32_t>(start % width), static_cast<int32_t>(start / width)});
+        cluster.indices.push_back(start);
+
+        // The cluster's own lists double as the BFS queue, coordinates grow past the edges instead of wrapping
+        for (size_t next = 0; next < cluster.cells.size(); next++) {
+            const ObjectClassifier::Cell cell = cluster.cells[next];
+            const uint32_t index = cluster.indices[next];
+            for (int32_t dy = -scan; dy <= scan; dy++) {
+                for (int32_t dx = -scan; dx <= scan; dx++) {
+                    const int32_t x = ((cell.x + dx) % width + width) % width;
+                    const int32_t y = ((cell.y + dy) % height + height) % height;
+                    const uint32_t neighbour = static_cast<uint32_t>(y * width + x);
+                    if (!cells[neighbour] || visited[neighbour]) continue;
+                    const bool near = std::max(std::abs(dx), std::abs(dy)) <= reach
+                        || widened[index] || widened[neighbour];
+                    if (!near) continue;
+                    visited[neighbour] = 1;
+                    cluster.cells.push_back({cell.x + dx, cell.y + dy});
+                    cluster.indices.push_back(neighbour);
+                }
+            }
+        }
+        clusters.push_back(std::move(cluster));
+    }
+    return clusters;
+}
+
+uint32_t SoupSearch::sweepSpaceships(Census::Counts& counts)
+{
+    engine->store(board);
+    uint32_t removed = 0;
+    for (const Cluster& cluster : findClusters(board, SWEEP_ISOLATION, {})) {
+        if (cluster.cells.size() > SWEEP_MAX_POPULATION) continue;
+        const ObjectClassifier::Classification& object = classifier.classify(cluster.cells);
+        if (object.kind != ObjectClassifier::Kind::Spaceship) continue;
+
+        // Spaceships flying in formation travel as one cluster, count each of them when they come apart cleanly
+        const std::vector<ObjectClassifier::Cells> parts = connectedParts(cluster.cells);
+        const bool separate = parts.size() > 1 && std::all_of(parts.begin(), parts.end(), [this](const auto& part) {
+            return classifier.classify(part).kind == ObjectClassifier::Kind::Spaceship;
+        });
+        if (separate) {
+            for (const ObjectClassifier::Cells& part : parts) {
+                counts[classifier.classify(part).apgcode]++;
+            }
+        } else {
+            counts[object.apgcode]++;
+        }
+        removed += separate ? static_cast<uint32_t>(parts.size()) : 1;
+        for (uint32_t index : cluster.indices) {
+            board.getCells()[index] = 0;
+        }
+    }
+    if (removed > 0) engine->load(board);
+    return removed;
+}
+
+uint32_t SoupSearch::countAsh(uint64_t period, Census::Counts& counts)
+{
+    std::vector<Grid> phases(period);
+    Grid ash {board.getWidth(), board.getHeight()};
+    for (Grid& phase : phases) {
+        engine->store(phase);
+        engine->step();
+        for (size_t i = 0; i < phase.getCells().size(); i++) {
+            ash.getCells()[i] |= phase.getCells()[i];
+        }
+    }
+    const int32_t width = static_cast<int32_t>(board.getWidth());
+    const int32_t height = static_cast<int32_t>(board.getHeight());
+
+    // Phase 0 cells of a cluster, in the cluster's unwrapped coordinates
+    auto firstPhase = [&phases](const Cluster& cluster) {
+        ObjectClassifier::Cells cells;
+        for (size_t i = 0; i < cluster.indices.size(); i++) {
+            if (phases[0].getCells()[cluster.indices[i]]) cells.push_back(cluster.cells[i]);
+        }
+        return cells;
+    };
+
+    // Objects are the 8-connected parts of every phase together. A part that evolves differently on its own
+    // leans on a neighbour (or is one phase of something bigger), so it is merged with everything within 2 cells
+    std::vector<uint8_t> widened;
+    std::vector<Cluster> clusters = findClusters(ash, 1, widened);
+    for (const Cluster& cluster : clusters) {
+        const ObjectClassifier::Cells cells = firstPhase(cluster);
+        const std::vector<ObjectClassifier::Cells> alone = classifier.evolve(cells, VERIFY_GENERATIONS);
+        bool independent = !cells.empty() && alone.size() == VERIFY_GENERATIONS + 1;
+        for (uint32_t generation = 1; independent && generation < alone.size(); generation++) {
+            const Grid& phase = phases[generation % period];
+            std::vector<uint32_t> expected;
+            for (uint32_t index : cluster.indices) {
+                if (phase.getCells()[index]) expected.push_back(index);
+            }
+            std::vector<uint32_t> actual;
+            for (const ObjectClassifier::Cell& cell : alone[generation]) {
+                const int32_t x = (cell.x % width + width) % width;
+                const int32_t y = (cell.y % height + height) % height;
+                actual.push_back(static_cast<uint32_t>(y * width + x));
+            }
+            std::sort(expected.begin(), expected.end());
+            std::sort(actual.begin(), actual.end());
+            independent = expected == actual;
+        }
+        if (independent) continue;
+        if (widened.empty()) widened.assign(ash.getCells().size(), 0);
+        for (uint32_t index : cluster.indices) {
+            widened[index] = 1;
+        }
+    }
+    if (!widened.empty()) clusters = findClusters(ash, 1, widened);
+
+    uint32_t objectCount = 0;
+    for (const Cluster& cluster : clusters) {
+        const ObjectClassifier::Cells cells = firstPhase(cluster);
+        if (cells.empty()) continue;
+        counts[classifier.classify(cells).apgcode]++;
+        objectCount++;
+    }
+    return objectCount;
+}
+
+SoupSearch::SoupResult SoupSearch::run(uint64_t soupIndex, Census::Counts& counts)
+{
+    TRACE_SCOPE("SoupSearch::run");
+    board = Grid(options.boardSize, options.boardSize);
+    fillSoup(board, options.seed, soupIndex, options.density);
+    engine->load(board);
+    engine->setHashTracking(true);
+    detector.reset();
+    detector.observe(0, engine->stateHash());
+
+    SoupResult result;
+    for (uint64_t generation = 1; generation <= options.maxGenerations; generation++) {
+        engine->step();
+        const std::optional<PeriodDetector::Cycle> cycle = detector.observe(generation, engine->stateHash());
+        result.generations = generation;
+        if (cycle && cycle->period <= MAX_ASH_PERIOD) {
+            result.stabilized = true;
+            result.objectCount += countAsh(cycle->period, counts);
+            break;
+        }
+        if (!cycle && generation % SWEEP_INTERVAL != 0) continue;
+
+        const uint32_t spaceships = sweepSpaceships(counts);
+        result.objectCount += spaceships;
+        if (spaceships > 0) {
+            detector.reset();
+            detector.observe(generation, engine->stateHash());
+        } else if (cycle) {
+            break;  // Repeats too slowly, and nothing could be swept away
+        }
+    }
+    engine->setHashTracking(false);
+    return result;
+}
+
+SoupSearch::BatchResult SoupSearch::runBatch(const Options& options, uint64_t soupCount, ThreadPool& pool, Census& census)
+{
+    TRACE_SCOPE("SoupSearch::runBatch");
+    std::atomic<uint64_t> nextSoup {0};
+    std::atomic<uint64_t> stabilized {0};
+    std::atomic<uint64_t> generations {0};
+    std::atomic<uint64_t> objects {0};
+
+    // One range per thread, soups take very different times so they are handed out one at a time
+    pool.parallelFor(pool.getThreadCount(), [&](uint32_t, uint32_t) {
+        SoupSearch search {options};
+        Census::Counts counts;
+        for (uint64_t soup = nextSoup++; soup < soupCount; soup = nextSoup++) {
+            const SoupResult result = search.run(soup, counts);
+            stabilized += result.stabilized ? 1 : 0;
+            generations += result.generations;
+            objects += result.objectCount;
+            census.merge(counts);
+            counts.clear();
+        }
+    });
+    return {soupCount, stabilized.load(), generations.load(), objects.load()};
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Census.h"
+#include "Grid.h"
+#include "ObjectClassifier.h"
+#include "PeriodDetector.h"
+
+class Engine;
+class ThreadPool;
+
+// apgsearch-style soup search. A random SOUP_SIZE x SOUP_SIZE soup in the middle of an empty torus is run
+// until the board repeats, then the ash is split into objects that are identified by ObjectClassifier and counted.
+// Spaceships that have left the ash are counted and removed while the soup runs, on a torus they would come back around
+class SoupSearch
+{
+public:
+    struct Options {
+        uint64_t seed = 0;
+        uint32_t boardSize = 256;
+        std::string engine = "simd";
+        double density = 0.5;
+        uint64_t maxGenerations = 1u << 15;
+    };
+    struct SoupResult {
+        uint64_t generations = 0;
+        bool stabilized = false;
+        uint32_t objectCount = 0;
+    };
+    struct BatchResult {
+        uint64_t soups = 0;
+        uint64_t stabilized = 0;
+        uint64_t generations = 0;
+        uint64_t objects = 0;
+    };
+
+    static constexpr uint32_t SOUP_SIZE = 16;
+    // Generations between spaceship sweeps
+    static constexpr uint32_t SWEEP_INTERVAL = 128;
+    // A small object is only treated as a departing spaceship when no other cell is this close to it
+    static constexpr int32_t SWEEP_ISOLATION = 8;
+    static constexpr size_t SWEEP_MAX_POPULATION = 40;
+    // Longer repeats are taken as a spaceship still orbiting the torus
+    static constexpr uint32_t MAX_ASH_PERIOD = 256;
+    // Generations an object is run alone to check it does not depend on its neighbours
+    static constexpr uint32_t VERIFY_GENERATIONS = 8;
+
+private:
+    // Live cells that belong together, in unwrapped coordinates (contiguous across the torus edges)
+    // alongside the board index of each cell
+    struct Cluster {
+        ObjectClassifier::Cells cells;
+        std::vector<uint32_t> indices;
+    };
+
+    Options options;
+    std::unique_ptr<Engine> engine;
+    ObjectClassifier classifier;
+    PeriodDetector detector;
+    Grid board;
+
+    // Groups live cells closer than reach (Chebyshev distance), or reach + 1 when either cell is marked in widened
+    std::vector<Cluster> findClusters(const Grid& grid, int32_t reach, const std::vector<uint8_t>& widened) const;
+    // Counts and erases isolated spaceships (engine state), returns how many were found
+    uint32_t sweepSpaceships(Census::Counts& counts);
+    // Splits the repeating board (engine state, period generations per cycle) into objects and counts them
+    uint32_t countAsh(uint64_t period, Census::Counts& counts);
+
+public:
+    explicit SoupSearch(const Options& options);
+    ~SoupSearch();
+    SoupSearch(const SoupSearch&) = delete;
+    SoupSearch& operator=(const SoupSearch&) = delete;
+
+    // Runs soup soupIndex of the seed and adds its objects to counts
+    SoupResult run(uint64_t soupIndex, Census::Counts& counts);
+
+    // Soup soupIndex is a pure function of (seed, soupIndex), like every CounterRng board
+    static void fillSoup(Grid& board, uint64_t seed, uint64_t soupIndex, double density);
+    // Runs soups [0, soupCount) on every thread of pool (one SoupSearch per thread, soups handed out one at a time)
+    static BatchResult runBatch(const Options& options, uint64_t soupCount, ThreadPool& pool, Census& census);
+};
@@ -0,0 +1,255 @@
+#include "SparseEngine.h"
+#include "Bitboard.h"
+#include "StateHash.h"
+#include "Trace.h"
+#include <bit>
+#include <utility>
+
+namespace {
+
+constexpr std::array<uint64_t, SparseEngine::CHUNK_SIZE> EMPTY_ROWS {};
+constexpr uint64_t WEST_EDGE = 1;
+constexpr uint64_t EAST_EDGE = 1ull << 63;
+
+// Floor division, chunk coordinates of negative cells round towards -infinity
+int32_t chunkCoordinate(int64_t cell)
+{
+    return static_cast<int32_t>(cell >= 0 ? cell / SparseEngine::CHUNK_SIZE
+                                          : (cell - SparseEngine::CHUNK_SIZE + 1) / SparseEngine::CHUNK_SIZE);
+}
+
+}
+
+uint64_t SparseEngine::keyOf(int32_t x, int32_t y)
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+}
+
+uint32_t SparseEngine::findChunk(int32_t x, int32_t y) const
+{
+    const auto found = chunkIndex.find(keyOf(x, y));
+    return found == chunkIndex.end() ? NO_CHUNK : found->second;
+}
+
+uint32_t SparseEngine::createChunk(int32_t x, int32_t y)
+{
+    uint32_t index;
+    if (!freeChunks.empty()) {
+        index = freeChunks.back();
+        freeChunks.pop_back();
+    } else {
+        index = static_cast<uint32_t>(chunks.size());
+        chunks.emplace_back();
+    }
+
+    Chunk& chunk = chunks[index];
+    chunk = Chunk{};
+    chunk.x = x;
+    chunk.y = y;
+    chunk.inUse = true;
+    for (uint32_t direction = 0; direction < 8; direction++) {
+        const uint32_t neighbour = findChunk(x + DIRECTION_X[direction], y + DIRECTION_Y[direction]);
+        chunk.neighbours[direction] = neighbour;
+        if (neighbour != NO_CHUNK) chunks[neighbour].neighbours[(direction + 4) % 8] = index;
+    }
+    chunkIndex.emplace(keyOf(x, y), index);
+    return index;
+}
+
+void SparseEngine::freeChunk(uint32_t index)
+{
+    Chunk& chunk = chunks[index];
+    for (uint32_t direction = 0; direction < 8; direction++) {
+        const uint32_t neighbour = chunk.neighbours[direction];
+        if (neighbour != NO_CHUNK) chunks[neighbour].neighbours[(direction + 4) % 8] = NO_CHUNK;
+    }
+    chunkIndex.erase(keyOf(chunk.x, chunk.y));
+    chunk.inUse = false;
+    freeChunks.push_back(index);
+}
+
+uint32_t SparseEngine::edgeMask(const Chunk& chunk)
+{
+    uint64_t columns = 0;
+    for (uint64_t row : chunk.cells) {
+        columns |= row;
+    }
+    const uint64_t top = chunk.cells.front();
+    const uint64_t bottom = chunk.cells.back();
+    // Same order as DIRECTION_X/Y: N, NE, E, SE, S, SW, W, NW
+    const bool touching[8] = {
+        top != 0, (top & EAST_EDGE) != 0, (columns & EAST_EDGE) != 0, (bottom & EAST_EDGE) != 0,
+        bottom != 0, (bottom & WEST_EDGE) != 0, (columns & WEST_EDGE) != 0, (top & WEST_EDGE) != 0,
+    };
+    uint32_t mask = 0;
+    for (uint32_t direction = 0; direction < 8; direction++) {
+        mask |= touching[direction] ? 1u << direction : 0u;
+    }
+    return mask;
+}
+
+void SparseEngine::grow()
+{
+    // Chunks created here start empty, so only the ones that existed before need checking
+    const uint32_t count = static_cast<uint32_t>(chunks.size());
+    for (uint32_t index = 0; index < count; index++) {
+        if (!chunks[index].inUse) continue;
+        const uint32_t needed = edgeMask(chunks[index]);
+        const int32_t x = chunks[index].x;
+        const int32_t y = chunks[index].y;
+        for (uint32_t direction = 0; direction < 8; direction++) {
+            // createChunk can reallocate, so the chunk is looked up again every time
+            if ((needed & (1u << direction)) && chunks[index].neighbours[direction] == NO_CHUNK) {
+                createChunk(x + DIRECTION_X[direction], y + DIRECTION_Y[direction]);
+            }
+        }
+    }
+}
+
+bool SparseEngine::isNeeded(const Chunk& chunk) const
+{
+    // grow would add the chunk straight back when a neighbour has cells on the shared edge
+    for (uint32_t direction = 0; direction < 8; direction++) {
+        const uint32_t neighbour = chunk.neighbours[direction];
+        if (neighbour != NO_CHUNK && (edgeMask(chunks[neighbour]) & (1u << ((direction + 4) % 8)))) return true;
+    }
+    return false;
+}
+
+void SparseEngine::stepChunk(Chunk& chunk)
+{
+    auto rowsOf = [this, &chunk](uint32_t direction) -> const uint64_t* {
+        const uint32_t neighbour = chunk.neighbours[direction];
+        return neighbour == NO_CHUNK ? EMPTY_ROWS.data() : chunks[neighbour].cells.data();
+    };
+    const uint64_t* north = rowsOf(0);
+    const uint64_t* northEast = rowsOf(1);
+    const uint64_t* east = rowsOf(2);
+    const uint64_t* southEast = rowsOf(3);
+    const uint64_t* south = rowsOf(4);
+    const uint64_t* southWest = rowsOf(5);
+    const uint64_t* west = rowsOf(6);
+    const uint64_t* northWest = rowsOf(7);
+    const uint64_t* cells = chunk.cells.data();
+    constexpr int32_t LAST = CHUNK_SIZE - 1;
+
+    for (int32_t y = 0; y < CHUNK_SIZE; y++) {
+        const uint64_t above = y == 0 ? north[LAST] : cells[y - 1];
+        const uint64_t aboveWest = y == 0 ? northWest[LAST] : west[y - 1];
+        const uint64_t aboveEast = y == 0 ? northEast[LAST] : east[y - 1];
+        const uint64_t below = y == LAST ? south[0] : cells[y + 1];
+        const uint64_t belowWest = y == LAST ? southWest[0] : west[y + 1];
+        const uint64_t belowEast = y == LAST ? southEast[0] : east[y + 1];
+        const uint64_t middle = cells[y];
+        chunk.next[y] = Bitboard::evolve(
+            Bitboard::shiftWest(above, aboveWest), above, Bitboard::shiftEast(above, aboveEast),
+            Bitboard::shiftWest(middle, west[y]), middle, Bitboard::shiftEast(middle, east[y]),
+            Bitboard::shiftWest(below, belowWest), below, Bitboard::shiftEast(below, belowEast)
+        );
+    }
+}
+
+void SparseEngine::load(const Grid& grid)
+{
+    chunks.clear();
+    freeChunks.clear();
+    chunkIndex.clear();
+    windowWidth = grid.getWidth();
+    windowHeight = grid.getHeight();
+    for (uint32_t y = 0; y < windowHeight; y++) {
+        for (uint32_t x = 0; x < windowWidth; x++) {
+            if (!grid.getCell(x, y)) continue;
+            const int32_t chunkX = chunkCoordinate(x);
+            const int32_t chunkY = chunkCoordinate(y);
+            uint32_t index = findChunk(chunkX, chunkY);
+            if (index == NO_CHUNK) index = createChunk(chunkX, chunkY);
+            chunks[index].cells[y % CHUNK_SIZE] |= 1ull << (x % CHUNK_SIZE);
+        }
+    }
+}
+
+void SparseEngine::store(Grid& grid) const
+{
+    grid = Grid(windowWidth, windowHeight);
+    for (const Chunk& chunk : chunks) {
+        if (!chunk.inUse) continue;
+        for (int32_t row = 0; row < CHUNK_SIZE; row++) {
+            const int64_t y = static_cast<int64_t>(chunk.y) * CHUNK_SIZE + row;
+            if (y < 0 || y >= windowHeight) continue;
+            for (uint64_t bits = chunk.cells[row]; bits != 0; bits &= bits - 1) {
+                const int64_t x = static_cast<int64_t>(chunk.x) * CHUNK_SIZE + std::countr_zero(bits);
+                if (x >= 0 && x < windowWidth) grid.setCell(static_cast<uint32_t>(x), static_cast<uint32_t>(y), 1);
+            }
+        }
+    }
+}
+
+void SparseEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("SparseEngine::step");
+    std::vector<uint8_t> active;
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        grow();
+
+        // A chunk whose whole 3x3 neighbourhood stood still last generation stays as it is
+        active.assign(chunks.size(), 0);
+        for (uint32_t index = 0; index < chunks.size(); index++) {
+            const Chunk& chunk = chunks[index];
+            if (!chunk.inUse) continue;
+            bool moving = chunk.changed;
+            for (uint32_t neighbour : chunk.neighbours) {
+                moving |= neighbour != NO_CHUNK && chunks[neighbour].changed;
+            }
+            active[index] = moving;
+        }
+        for (uint32_t index = 0; index < chunks.size(); index++) {
+            if (active[index]) stepChunk(chunks[index]);
+        }
+
+        for (uint32_t index = 0; index < chunks.size(); index++) {
+            Chunk& chunk = chunks[index];
+            if (!chunk.inUse) continue;
+            chunk.changed = active[index] && chunk.next != chunk.cells;
+            if (chunk.changed) std::swap(chunk.cells, chunk.next);
+            const bool empty = chunk.cells == EMPTY_ROWS;
+            chunk.idleGenerations = empty ? chunk.idleGenerations + 1 : 0;
+            if (chunk.idleGenerations >= IDLE_GENERATIONS && !isNeeded(chunk)) freeChunk(index);
+        }
+    }
+}
+
+void SparseEngine::setTopology(Topology::Kind kind)
+{
+    throw Engine::ConfigurationError("the sparse engine only simulates the unbounded plane, not the bounded " +
+                                     std::string(Topology::getName(kind)));
+}
+
+uint64_t SparseEngine::population() const
+{
+    uint64_t count = 0;
+    for (const Chunk& chunk : chunks) {
+        if (!chunk.inUse) continue;
+        for (uint64_t row : chunk.cells) {
+            count += std::popcount(row);
+        }
+    }
+    return count;
+}
+
+uint64_t SparseEngine::stateHash() const
+{
+    // Chunks are word aligned, so every chunk row inside the window is exactly one StateHash word
+    const int64_t wordsPerRow = (windowWidth + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    const uint32_t tailBits = windowWidth % CHUNK_SIZE;
+    uint64_t hash = 0;
+    for (const Chunk& chunk : chunks) {
+        if (!chunk.inUse || chunk.x < 0 || chunk.x >= wordsPerRow || chunk.y < 0) continue;
+        const uint64_t mask = (chunk.x == wordsPerRow - 1 && tailBits != 0) ? (1ull << tailBits) - 1 : ~0ull;
+        for (int32_t row = 0; row < CHUNK_SIZE; row++) {
+            const int64_t y = static_cast<int64_t>(chunk.y) * CHUNK_SIZE + row;
+            if (y >= windowHeight) break;
+            hash ^= StateHash::wordKey(static_cast<uint64_t>(y * wordsPerRow + chunk.x), chunk.cells[row] & mask);
+        }
+    }
+    return hash;
+}
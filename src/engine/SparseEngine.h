@@ -0,0 +1,67 @@
+#pragma once
+#include "Engine.h"
+#include <array>
+#include <unordered_map>
+
+// Unbounded plane made of 64x64 packed chunks kept in a hash map, so memory follows the live area rather than
+// a bounding box (a spaceship flying off costs a few chunks, forever). Chunks are added when cells reach an edge
+// that has no neighbour yet and freed after staying empty for a while; each caches links to its 8 neighbours.
+// Unlike the other engines nothing wraps: load and store treat the grid as a window onto the plane at (0, 0),
+// and population counts the whole plane
+class SparseEngine : public Engine
+{
+public:
+    static constexpr int32_t CHUNK_SIZE = 64;
+    // Empty generations before a chunk is freed, avoids churn on chunks next to busy edges
+    static constexpr uint32_t IDLE_GENERATIONS = 8;
+
+private:
+    static constexpr uint32_t NO_CHUNK = UINT32_MAX;
+    // Neighbour order, opposite directions are 4 apart
+    static constexpr int32_t DIRECTION_X[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static constexpr int32_t DIRECTION_Y[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    struct Chunk {
+        int32_t x = 0;
+        int32_t y = 0;
+        bool inUse = false;
+        // Whether the last step changed the chunk, unchanged neighbourhoods are not stepped again
+        bool changed = true;
+        uint32_t idleGenerations = 0;
+        std::array<uint32_t, 8> neighbours{};
+        // Row y is one word, bit i is cell x = i (same layout as Bitboard)
+        std::array<uint64_t, CHUNK_SIZE> cells{};
+        std::array<uint64_t, CHUNK_SIZE> next{};
+    };
+
+    std::vector<Chunk> chunks;
+    std::vector<uint32_t> freeChunks;
+    std::unordered_map<uint64_t, uint32_t> chunkIndex;
+    uint32_t windowWidth = 0;
+    uint32_t windowHeight = 0;
+
+    static uint64_t keyOf(int32_t x, int32_t y);
+    uint32_t findChunk(int32_t x, int32_t y) const;
+    uint32_t createChunk(int32_t x, int32_t y);
+    void freeChunk(uint32_t index);
+    // Bit d is set when the chunk has live cells on the edge or corner facing direction d
+    static uint32_t edgeMask(const Chunk& chunk);
+    bool isNeeded(const Chunk& chunk) const;
+    // Adds the missing neighbours of chunks with live cells on the matching edge or corner
+    void grow();
+    void stepChunk(Chunk& chunk);
+
+public:
+    std::string_view getName() const override { return "sparse"; }
+    void load(const Grid& grid) override;
+    void store(Grid& grid) const override;
+    void step(uint32_t generations = 1) override;
+    uint64_t population() const override;
+    // Hash of the window only, so it matches StateHash::ofGrid of store()
+    uint64_t stateHash() const override;
+    // Always throws, the plane has no edges to glue (life_bench --topology skips the engine with the reason)
+    void setTopology(Topology::Kind kind) override;
+    bool isBounded() const override { return false; }
+
+    size_t getChunkCount() const { return chunkIndex.size(); }
+};
@@ -0,0 +1,49 @@
+#include "StateHash.h"
+
+uint64_t StateHash::ofGrid(const Grid& grid)
+{
+    const uint32_t width = grid.getWidth();
+    const uint64_t wordsPerRow = (width + Bitboard::BITS_PER_WORD - 1) / Bitboard::BITS_PER_WORD;
+    uint64_t hash = 0;
+    for (uint32_t y = 0; y < grid.getHeight(); y++) {
+        for (uint32_t w = 0; w < wordsPerRow; w++) {
+            uint64_t word = 0;
+            const uint32_t first = w * Bitboard::BITS_PER_WORD;
+            for (uint32_t x = first; x < width && x < first + Bitboard::BITS_PER_WORD; x++) {
+                word |= static_cast<uint64_t>(grid.getCell(x, y) & 1) << (x - first);
+            }
+            hash ^= wordKey(y * wordsPerRow + w, word);
+        }
+    }
+    return hash;
+}
+
+uint64_t StateHash::ofBitboard(const Bitboard& board)
+{
+    const uint64_t wordsPerRow = board.getWordsPerRow();
+    uint64_t hash = 0;
+    for (uint32_t y = 0; y < board.getHeight(); y++) {
+        const uint64_t* r = board.row(y);
+        for (uint32_t w = 0; w < wordsPerRow; w++) {
+            hash ^= wordKey(y * wordsPerRow + w, r[w]);
+        }
+    }
+    return hash;
+}
+
+uint64_t StateHash::delta(const Bitboard& before, const Bitboard& after, uint32_t firstRow, uint32_t lastRow)
+{
+    const uint64_t wordsPerRow = after.getWordsPerRow();
+    uint64_t hash = 0;
+    for (uint32_t y = firstRow; y < lastRow; y++) {
+        if (!after.isRowChanged(y)) continue;
+        const uint64_t* previous = before.row(y);
+        const uint64_t* current = after.row(y);
+        for (uint32_t w = 0; w < wordsPerRow; w++) {
+            if (previous[w] == current[w]) continue;
+            const uint64_t index = y * wordsPerRow + w;
+            hash ^= wordKey(index, previous[w]) ^ wordKey(index, current[w]);
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include "Grid.h"
+#include "Bitboard.h"
+
+// 64-bit Zobrist-style hash of a board, used to spot repeated states (see PeriodDetector).
+// The hash is the XOR of wordKey(index, word) over every 64-cell run of a row, with
+// index = y * ceil(width / 64) + x / 64 and the last run of a row zero padded. Empty runs contribute
+// nothing, so a step only has to rehash the words it changed instead of the whole board
+class StateHash
+{
+public:
+    // SplitMix64 finalizer
+    static constexpr uint64_t mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    static constexpr uint64_t wordKey(uint64_t index, uint64_t word)
+    {
+        if (word == 0) return 0;
+        return mix(word ^ mix(index + 0x9E3779B97F4A7C15ull));
+    }
+
+    static uint64_t ofGrid(const Grid& grid);
+    static uint64_t ofBitboard(const Bitboard& board);
+    // Hash of after XOR hash of before, over rows [firstRow, lastRow). Only rows that after marks as
+    // changed are read, so a settled board costs one flag test per row
+    static uint64_t delta(const Bitboard& before, const Bitboard& after, uint32_t firstRow, uint32_t lastRow);
+};
@@ -0,0 +1,90 @@
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <string>
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    const unsigned count = resolveThreadCount(threads);
+    workers.reserve(count - 1);
+    for (unsigned index = 1; index < count; index++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::resolveThreadCount(unsigned threads)
+{
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    // A wasm build without -pthread cannot start threads, the calling thread does all the work
+    (void)threads;
+    return 1;
+#endif
+    if (threads > 0) return threads;
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+void ThreadPool::runChunk(const RangeTask& body, uint32_t count, unsigned index) const
+{
+    const uint64_t threads = getThreadCount();
+    const uint32_t begin = static_cast<uint32_t>(count * index / threads);
+    const uint32_t end = static_cast<uint32_t>(count * (index + 1ull) / threads);
+    if (begin < end) body(begin, end);
+}
+
+void ThreadPool::workerLoop(unsigned index)
+{
+    TRACE_THREAD_NAME("pool worker " + std::to_string(index));
+    uint64_t seenGeneration = 0;
+    while (true) {
+        const RangeTask* body = nullptr;
+        uint32_t count = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+            body = task;
+            count = taskCount;
+        }
+
+        runChunk(*body, count, index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) done.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(uint32_t count, const RangeTask& body)
+{
+    if (workers.empty() || count <= 1) {
+        if (count > 0) body(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &body;
+        taskCount = count;
+        pending = static_cast<unsigned>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    runChunk(body, count, 0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending == 0; });
+    task = nullptr;
+}
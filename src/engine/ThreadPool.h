@@ -0,0 +1,42 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of persistent workers for fork/join loops.
+// The calling thread takes part in every parallelFor, so a pool of N threads starts N - 1 workers
+class ThreadPool
+{
+private:
+    using RangeTask = std::function<void(uint32_t begin, uint32_t end)>;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const RangeTask* task = nullptr;
+    uint32_t taskCount = 0;
+    uint64_t generation = 0;
+    unsigned pending = 0;
+    bool stopping = false;
+
+    void workerLoop(unsigned index);
+    void runChunk(const RangeTask& body, uint32_t count, unsigned index) const;
+
+public:
+    // threads = 0 uses std::thread::hardware_concurrency
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Splits [0, count) into one contiguous range per thread and blocks until all ranges ran
+    void parallelFor(uint32_t count, const RangeTask& body);
+
+    static unsigned resolveThreadCount(unsigned threads);
+};
@@ -0,0 +1,28 @@
+#include "ThreadedEngine.h"
+#include "Trace.h"
+#include "SimdEngine.h"
+#include "StateHash.h"
+#include <atomic>
+
+ThreadedEngine::ThreadedEngine(unsigned threads)
+    : pool(threads)
+{
+}
+
+void ThreadedEngine::stepBoard()
+{
+    pool.parallelFor(current.getHeight(), [this](uint32_t firstRow, uint32_t lastRow) {
+        TRACE_SCOPE("ThreadedEngine::stepRows");
+        SimdEngine::stepRows(current, next, firstRow, lastRow);
+    });
+}
+
+uint64_t ThreadedEngine::hashDelta()
+{
+    // XOR is order independent, so every band folds its part straight into the total
+    std::atomic<uint64_t> delta {0};
+    pool.parallelFor(current.getHeight(), [this, &delta](uint32_t firstRow, uint32_t lastRow) {
+        delta.fetch_xor(StateHash::delta(current, next, firstRow, lastRow), std::memory_order_relaxed);
+    });
+    return delta.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "BitboardEngine.h"
+#include "ThreadPool.h"
+
+// SIMD engine with the rows of every generation split into one band per thread
+class ThreadedEngine : public BitboardEngine
+{
+private:
+    ThreadPool pool;
+
+protected:
+    void stepBoard() override;
+    uint64_t hashDelta() override;
+
+public:
+    explicit ThreadedEngine(unsigned threads = 0);
+
+    std::string_view getName() const override { return "threaded"; }
+    unsigned getThreadCount() const override { return pool.getThreadCount(); }
+};
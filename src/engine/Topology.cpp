@@ -0,0 +1,19 @@
+#include "Topology.h"
+#include "Engine.h"
+#include <string>
+
+Topology::Kind Topology::parse(std::string_view name)
+{
+    for (uint32_t i = 0; i < NAMES.size(); i++) {
+        if (NAMES[i] == name) return static_cast<Kind>(i);
+    }
+    throw Engine::ConfigurationError("unknown topology '" + std::string(name) + "'");
+}
+
+void Topology::validate(Kind kind, uint32_t width, uint32_t height)
+{
+    if (kind == Kind::Sphere && width != height) {
+        throw Engine::ConfigurationError("a sphere needs a square board, not " + std::to_string(width) + "x" +
+                                         std::to_string(height));
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// How the edges of a bounded board are glued together. The board is surrounded by a one-cell halo that a
+// separate pass fills from the interior (haloMain in shader.wgsl, Bitboard::fillHalo, ScalarEngine), so the step
+// itself reads all nine cells without any wrap arithmetic or edge branch whatever the topology
+class Topology
+{
+public:
+    // Values are the TOPOLOGY override constant of haloMain
+    enum class Kind : uint32_t {
+        Torus,         // Opposite edges joined
+        Plane,         // Everything outside the board is dead
+        KleinBottle,   // Left and right joined, top and bottom joined with x mirrored
+        CrossSurface,  // Both pairs joined with a twist (a real projective plane)
+        Sphere,        // Top edge joined to the left edge, bottom edge to the right edge, square boards only
+    };
+    static constexpr std::array<std::string_view, 5> NAMES = {"torus", "plane", "klein", "cross", "sphere"};
+
+    struct Cell {
+        int64_t x;
+        int64_t y;
+    };
+
+    static std::string_view getName(Kind kind) { return NAMES[static_cast<uint32_t>(kind)]; }
+    // Throws Engine::ConfigurationError for names not in NAMES
+    static Kind parse(std::string_view name);
+    // Throws Engine::ConfigurationError when the board cannot have this topology (a sphere needs a square)
+    static void validate(Kind kind, uint32_t width, uint32_t height);
+
+    // Interior cell whose state halo cell (x, y) takes, or nothing when it is dead. (x, y) is in [-1, width] x
+    // [-1, height] with x or y outside the board. Mirrored by haloSource in shader.wgsl
+    static constexpr std::optional<Cell> haloSource(Kind kind, int64_t x, int64_t y, uint32_t width, uint32_t height)
+    {
+        const int64_t w = width;
+        const int64_t h = height;
+        const bool outsideX = x < 0 || x >= w;
+        const bool outsideY = y < 0 || y >= h;
+        const int64_t wrappedX = (x + w) % w;
+        const int64_t wrappedY = (y + h) % h;
+        switch (kind) {
+            case Kind::Torus:
+                return Cell{wrappedX, wrappedY};
+            case Kind::Plane:
+                return std::nullopt;
+            case Kind::KleinBottle:
+                // The four corners are one point, surrounded by the four corner cells
+                return Cell{outsideY ? w - 1 - wrappedX : wrappedX, wrappedY};
+            case Kind::CrossSurface:
+                // Opposite corners are one point, so the diagonal neighbours across a corner wrap like a torus
+                if (outsideX && outsideY) return Cell{wrappedX, wrappedY};
+                return Cell{outsideY ? w - 1 - wrappedX : wrappedX, outsideX ? h - 1 - wrappedY : wrappedY};
+            case Kind::Sphere:
+                // The corners are cone points without a neighbour on the far side
+                if (outsideX && outsideY) return std::nullopt;
+                if (y < 0) return Cell{0, x};
+                if (y >= h) return Cell{w - 1, x};
+                if (x < 0) return Cell{y, 0};
+                return Cell{y, h - 1};
+        }
+        return std::nullopt;
+    }
+};
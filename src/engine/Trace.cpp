@@ -0,0 +1,185 @@
+#include "Trace.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#if __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+namespace {
+
+constexpr uint64_t RING_CAPACITY = 1u << 16;
+
+// Fields are relaxed atomics so a dump running concurrently with the owning thread is well defined;
+// on x86 and wasm these compile to plain loads and stores
+struct Event {
+    std::atomic<const char*> name {nullptr};
+    std::atomic<uint64_t> start {0};
+    std::atomic<uint64_t> end {0};
+};
+
+struct ThreadRing {
+    std::array<Event, RING_CAPACITY> events;
+    std::atomic<uint64_t> head {0};
+    uint32_t tid = 0;
+    std::string name;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+// Rings stay registered after their thread exits, so short-lived threads still show up in a trace
+ThreadRing& threadRing()
+{
+    thread_local std::shared_ptr<ThreadRing> ring = [] {
+        auto created = std::make_shared<ThreadRing>();
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        created->tid = static_cast<uint32_t>(shared.rings.size());
+        shared.rings.push_back(created);
+        return created;
+    }();
+    return *ring;
+}
+
+void writeEscaped(std::ostream& out, const std::string& text)
+{
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+        else out << c;
+    }
+}
+
+#if __EMSCRIPTEN__
+EM_JS(void, downloadTrace, (const char* name, size_t nameLength, const char* data, size_t length), {
+    const blob = new Blob([HEAPU8.slice(data, data + length)], { type: 'application/json' });
+    const fileName = new TextDecoder().decode(HEAPU8.slice(name, name + nameLength));
+    // In a worker (index.html?worker) the page does the download
+    if (typeof document === 'undefined') {
+        postMessage({ type: 'download', name: fileName, blob });
+        return;
+    }
+    const link = document.createElement('a');
+    link.href = URL.createObjectURL(blob);
+    link.download = fileName;
+    link.click();
+    URL.revokeObjectURL(link.href);
+});
+#endif
+
+}
+
+uint64_t Trace::now()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+void Trace::record(const char* name, uint64_t startNs, uint64_t endNs)
+{
+    ThreadRing& ring = threadRing();
+    const uint64_t index = ring.head.load(std::memory_order_relaxed);
+    Event& event = ring.events[index % RING_CAPACITY];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(startNs, std::memory_order_relaxed);
+    event.end.store(endNs, std::memory_order_relaxed);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+void Trace::setThreadName(const std::string& name)
+{
+    ThreadRing& ring = threadRing();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    ring.name = name;
+}
+
+void Trace::writeJson(std::ostream& out)
+{
+    struct Snapshot {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() -> std::ostream& {
+        if (!first) out << ",\n";
+        first = false;
+        return out;
+    };
+
+    out << std::fixed << std::setprecision(3);
+    for (const auto& ring : shared.rings) {
+        if (!ring->name.empty()) {
+            separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring->tid
+                        << ",\"args\":{\"name\":\"";
+            writeEscaped(out, ring->name);
+            out << "\"}}";
+        }
+
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t oldest = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+        std::vector<Snapshot> events;
+        events.reserve(head - oldest);
+        for (uint64_t i = oldest; i < head; i++) {
+            const Event& event = ring->events[i % RING_CAPACITY];
+            events.push_back({
+                event.name.load(std::memory_order_relaxed),
+                event.start.load(std::memory_order_relaxed),
+                event.end.load(std::memory_order_relaxed),
+            });
+        }
+        // The owning thread may have lapped the oldest slots while they were copied, drop those
+        const uint64_t headAfter = ring->head.load(std::memory_order_acquire);
+        const uint64_t firstValid = headAfter > RING_CAPACITY ? headAfter - RING_CAPACITY : 0;
+        const size_t skip = firstValid > oldest ? static_cast<size_t>(std::min(firstValid - oldest, head - oldest)) : 0;
+
+        for (size_t i = skip; i < events.size(); i++) {
+            const Snapshot& event = events[i];
+            separator() << "{\"ph\":\"X\",\"name\":\"";
+            writeEscaped(out, event.name ? event.name : "?");
+            out << "\",\"pid\":1,\"tid\":" << ring->tid
+                << ",\"ts\":" << static_cast<double>(event.start) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.end - event.start) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool Trace::save(const std::string& path)
+{
+#if __EMSCRIPTEN__
+    std::ostringstream json;
+    writeJson(json);
+    const std::string data = json.str();
+    const std::string name = path.substr(path.find_last_of('/') + 1);
+    downloadTrace(name.data(), name.size(), data.data(), data.size());
+    return true;
+#else
+    std::ofstream file(path);
+    if (!file) return false;
+    writeJson(file);
+    return static_cast<bool>(file);
+#endif
+}
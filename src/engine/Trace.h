@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Scoped hot-path instrumentation, exported as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+// Each thread records into its own fixed-size ring (single writer, no locks on the hot path),
+// so a trace always holds the most recent events of every thread.
+// Built with LIFE_TRACING=0 (the default, see LIFE_ENABLE_TRACING in CMakeLists.txt) the macros compile to nothing.
+#ifndef LIFE_TRACING
+#define LIFE_TRACING 0
+#endif
+
+class Trace
+{
+public:
+    // Records [construction, destruction) as a complete event. name must be a string literal (or otherwise outlive the trace)
+    class Scope {
+        private:
+            const char* name;
+            uint64_t start;
+        public:
+            explicit Scope(const char* name) : name(name), start(Trace::now()) {}
+            ~Scope() { Trace::record(name, start, Trace::now()); }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+    };
+
+    static constexpr bool ENABLED = LIFE_TRACING != 0;
+
+    // Nanoseconds since the first trace call of the process
+    static uint64_t now();
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+    // Shown as the thread's label in the viewer
+    static void setThreadName(const std::string& name);
+
+    static void writeJson(std::ostream& out);
+    // Native builds write the file, wasm builds offer it as a browser download named after the file
+    static bool save(const std::string& path);
+};
+
+#if LIFE_TRACING
+#define LIFE_TRACE_CONCAT_INNER(a, b) a##b
+#define LIFE_TRACE_CONCAT(a, b) LIFE_TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) const Trace::Scope LIFE_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
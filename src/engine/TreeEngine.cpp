@@ -0,0 +1,242 @@
+#include "TreeEngine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <bit>
+
+size_t TreeEngine::NodeKeyHash::operator()(const NodeKey& key) const
+{
+    uint64_t hash = ((static_cast<uint64_t>(key.nw) << 32) | key.ne) * 0x9E3779B97F4A7C15ull;
+    hash ^= ((static_cast<uint64_t>(key.sw) << 32) | key.se) * 0xC2B2AE3D27D4EB4Full;
+    hash ^= hash >> 29;
+    return static_cast<size_t>(hash);
+}
+
+TreeEngine::TreeEngine()
+{
+    reset();
+}
+
+void TreeEngine::reset()
+{
+    nodes.clear();
+    table.clear();
+    nodes.push_back({NO_NODE, NO_NODE, NO_NODE, NO_NODE, 0, NO_NODE, 0}); // DEAD
+    nodes.push_back({NO_NODE, NO_NODE, NO_NODE, NO_NODE, 0, NO_NODE, 1}); // ALIVE
+    emptyNodes.assign(1, DEAD);
+    root = DEAD;
+    rootLevel = 0;
+    offset = 0;
+    memoStepLog = 0;
+}
+
+uint32_t TreeEngine::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+{
+    const NodeKey key {nw, ne, sw, se};
+    auto found = table.find(key);
+    if (found != table.end()) return found->second;
+
+    const uint64_t population = nodes[nw].population + nodes[ne].population +
+                                nodes[sw].population + nodes[se].population;
+    const uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({nw, ne, sw, se, nodes[nw].level + 1, NO_NODE, population});
+    table.emplace(key, index);
+    return index;
+}
+
+uint32_t TreeEngine::emptyNode(uint32_t level)
+{
+    while (emptyNodes.size() <= level) {
+        const uint32_t child = emptyNodes.back();
+        emptyNodes.push_back(join(child, child, child, child));
+    }
+    return emptyNodes[level];
+}
+
+uint32_t TreeEngine::stepLeafSquare(uint32_t node)
+{
+    // 4x4 square of leaves, advanced one generation, returns its 2x2 centre
+    const Node square = nodes[node];
+    auto cellAt = [&](uint32_t x, uint32_t y) -> uint32_t {
+        const uint32_t quadrant = (y < 2) ? ((x < 2) ? square.nw : square.ne)
+                                          : ((x < 2) ? square.sw : square.se);
+        const Node& pair = nodes[quadrant];
+        const uint32_t leaf = (y % 2 == 0) ? ((x % 2 == 0) ? pair.nw : pair.ne)
+                                           : ((x % 2 == 0) ? pair.sw : pair.se);
+        return leaf == ALIVE ? 1 : 0;
+    };
+    auto nextLeaf = [&](uint32_t x, uint32_t y) -> uint32_t {
+        uint32_t activeNeighbors = 0;
+        for (uint32_t dy = 0; dy < 3; dy++) {
+            for (uint32_t dx = 0; dx < 3; dx++) {
+                if (dx != 1 || dy != 1) activeNeighbors += cellAt(x + dx - 1, y + dy - 1);
+            }
+        }
+        if (activeNeighbors == 3) return ALIVE;
+        if (activeNeighbors == 2 && cellAt(x, y)) return ALIVE;
+        return DEAD;
+    };
+    return join(nextLeaf(1, 1), nextLeaf(2, 1), nextLeaf(1, 2), nextLeaf(2, 2));
+}
+
+uint32_t TreeEngine::successor(uint32_t node, uint32_t stepLog)
+{
+    // Returns the centre of node (one level down) advanced 2^min(stepLog, level - 2) generations
+    const Node n = nodes[node];
+    if (n.population == 0) return emptyNode(n.level - 1);
+    if (n.result != NO_NODE) return n.result;
+
+    uint32_t result;
+    if (n.level == 2) {
+        result = stepLeafSquare(node);
+    } else {
+        const Node nw = nodes[n.nw];
+        const Node ne = nodes[n.ne];
+        const Node sw = nodes[n.sw];
+        const Node se = nodes[n.se];
+
+        // Nine overlapping sub-squares, each half the size of node
+        const uint32_t n00 = n.nw;
+        const uint32_t n01 = join(nw.ne, ne.nw, nw.se, ne.sw);
+        const uint32_t n02 = n.ne;
+        const uint32_t n10 = join(nw.sw, nw.se, sw.nw, sw.ne);
+        const uint32_t n11 = join(nw.se, ne.sw, sw.ne, se.nw);
+        const uint32_t n12 = join(ne.sw, ne.se, se.nw, se.ne);
+        const uint32_t n20 = n.sw;
+        const uint32_t n21 = join(sw.ne, se.nw, sw.se, se.sw);
+        const uint32_t n22 = n.se;
+
+        const uint32_t c00 = successor(n00, stepLog);
+        const uint32_t c01 = successor(n01, stepLog);
+        const uint32_t c02 = successor(n02, stepLog);
+        const uint32_t c10 = successor(n10, stepLog);
+        const uint32_t c11 = successor(n11, stepLog);
+        const uint32_t c12 = successor(n12, stepLog);
+        const uint32_t c20 = successor(n20, stepLog);
+        const uint32_t c21 = successor(n21, stepLog);
+        const uint32_t c22 = successor(n22, stepLog);
+
+        if (stepLog < n.level - 2) {
+            // Partial speed: the nine results already hold the target generation, stitch their centres
+            auto centreOf = [this](uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+                return join(nodes[a].se, nodes[b].sw, nodes[c].ne, nodes[d].nw);
+            };
+            const uint32_t q0 = centreOf(c00, c01, c10, c11);
+            const uint32_t q1 = centreOf(c01, c02, c11, c12);
+            const uint32_t q2 = centreOf(c10, c11, c20, c21);
+            const uint32_t q3 = centreOf(c11, c12, c21, c22);
+            result = join(q0, q1, q2, q3);
+        } else {
+            // Full speed: the nine results are halfway there, step the four overlapping quadrants again
+            const uint32_t q0 = successor(join(c00, c01, c10, c11), stepLog);
+            const uint32_t q1 = successor(join(c01, c02, c11, c12), stepLog);
+            const uint32_t q2 = successor(join(c10, c11, c20, c21), stepLog);
+            const uint32_t q3 = successor(join(c11, c12, c21, c22), stepLog);
+            result = join(q0, q1, q2, q3);
+        }
+    }
+
+    nodes[node].result = result;
+    return result;
+}
+
+void TreeEngine::setMemoStepLog(uint32_t stepLog)
+{
+    if (stepLog == memoStepLog) return;
+    for (auto& node : nodes) {
+        node.result = NO_NODE;
+    }
+    memoStepLog = stepLog;
+}
+
+void TreeEngine::advance(uint32_t stepLog)
+{
+    // A 2x2 tiling of the torus evolves exactly like the torus for up to half the board size in generations,
+    // and its centre is the board rotated by half a board in x and y
+    setMemoStepLog(stepLog);
+    const uint32_t tiling = join(root, root, root, root);
+    root = successor(tiling, stepLog);
+    const uint32_t size = 1u << rootLevel;
+    offset = (offset + size / 2) % size;
+}
+
+void TreeEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("TreeEngine::step");
+    if (rootLevel < 2) return;
+    const uint32_t maxStepLog = rootLevel - 1;
+    while (generations > 0) {
+        const uint32_t stepLog = std::min<uint32_t>(std::bit_width(generations) - 1, maxStepLog);
+        advance(stepLog);
+        generations -= 1u << stepLog;
+        if (nodes.size() > COLLECT_THRESHOLD) collect();
+    }
+}
+
+uint32_t TreeEngine::copyInto(TreeEngine& target, uint32_t node, std::vector<uint32_t>& remap) const
+{
+    if (node == DEAD || node == ALIVE) return node;
+    if (remap[node] != NO_NODE) return remap[node];
+    const Node& n = nodes[node];
+    const uint32_t nw = copyInto(target, n.nw, remap);
+    const uint32_t ne = copyInto(target, n.ne, remap);
+    const uint32_t sw = copyInto(target, n.sw, remap);
+    const uint32_t se = copyInto(target, n.se, remap);
+    remap[node] = target.join(nw, ne, sw, se);
+    return remap[node];
+}
+
+void TreeEngine::collect()
+{
+    // Drop every node (and memoized result) not reachable from the current root
+    TreeEngine fresh;
+    std::vector<uint32_t> remap(nodes.size(), NO_NODE);
+    fresh.root = copyInto(fresh, root, remap);
+    fresh.rootLevel = rootLevel;
+    fresh.offset = offset;
+    *this = std::move(fresh);
+}
+
+uint32_t TreeEngine::build(const Grid& grid, uint32_t x, uint32_t y, uint32_t level)
+{
+    if (level == 0) return grid.getCell(x, y) ? ALIVE : DEAD;
+    const uint32_t half = 1u << (level - 1);
+    const uint32_t nw = build(grid, x, y, level - 1);
+    const uint32_t ne = build(grid, x + half, y, level - 1);
+    const uint32_t sw = build(grid, x, y + half, level - 1);
+    const uint32_t se = build(grid, x + half, y + half, level - 1);
+    return join(nw, ne, sw, se);
+}
+
+void TreeEngine::load(const Grid& grid)
+{
+    const uint32_t size = grid.getWidth();
+    if (size != grid.getHeight() || !std::has_single_bit(size) || size < 4) {
+        throw Engine::ConfigurationError("the tree engine needs a square power-of-two board of at least 4x4");
+    }
+    reset();
+    rootLevel = static_cast<uint32_t>(std::countr_zero(size));
+    root = build(grid, 0, 0, rootLevel);
+}
+
+void TreeEngine::write(uint32_t node, uint32_t x, uint32_t y, Grid& grid) const
+{
+    const Node& n = nodes[node];
+    if (n.population == 0) return;
+    if (n.level == 0) {
+        const uint32_t size = grid.getWidth();
+        grid.setCell((x + offset) % size, (y + offset) % size, 1);
+        return;
+    }
+    const uint32_t half = 1u << (n.level - 1);
+    write(n.nw, x, y, grid);
+    write(n.ne, x + half, y, grid);
+    write(n.sw, x, y + half, grid);
+    write(n.se, x + half, y + half, grid);
+}
+
+void TreeEngine::store(Grid& grid) const
+{
+    const uint32_t size = 1u << rootLevel;
+    grid = Grid(size, size);
+    write(root, 0, 0, grid);
+}
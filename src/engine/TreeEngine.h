@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine.h"
+#include <unordered_map>
+
+// HashLife: the board is a hash-consed quadtree and the future of every node is memoized,
+// so repeated structure (empty space, still lifes, guns) is only ever simulated once.
+// The torus is simulated by stepping a 2x2 tiling of the board, which needs a square power-of-two board
+class TreeEngine : public Engine
+{
+private:
+    struct Node {
+        uint32_t nw, ne, sw, se;
+        uint32_t level;
+        uint32_t result;       // Memoized successor for memoStepLog, NO_NODE when unknown
+        uint64_t population;
+    };
+    struct NodeKey {
+        uint32_t nw, ne, sw, se;
+        bool operator==(const NodeKey& other) const = default;
+    };
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const;
+    };
+
+    static constexpr uint32_t DEAD = 0;
+    static constexpr uint32_t ALIVE = 1;
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+    // Rebuild the node table from the live tree once it holds this many nodes
+    static constexpr size_t COLLECT_THRESHOLD = 1u << 22;
+
+    std::vector<Node> nodes;
+    std::unordered_map<NodeKey, uint32_t, NodeKeyHash> table;
+    std::vector<uint32_t> emptyNodes;
+    uint32_t root = DEAD;
+    uint32_t rootLevel = 0;
+    // Torus coordinate of the root's top-left cell, stepping a tiling shifts the board by half its size
+    uint32_t offset = 0;
+    uint32_t memoStepLog = 0;
+
+    void reset();
+    uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+    uint32_t emptyNode(uint32_t level);
+    uint32_t successor(uint32_t node, uint32_t stepLog);
+    uint32_t stepLeafSquare(uint32_t node);
+    uint32_t build(const Grid& grid, uint32_t x, uint32_t y, uint32_t level);
+    void write(uint32_t node, uint32_t x, uint32_t y, Grid& grid) const;
+    void advance(uint32_t stepLog);
+    void setMemoStepLog(uint32_t stepLog);
+    void collect();
+    uint32_t copyInto(TreeEngine& target, uint32_t node, std::vector<uint32_t>& remap) const;
+
+public:
+    TreeEngine();
+
+    std::string_view getName() const override { return "tree"; }
+    void load(const Grid& grid) override;
+    void store(Grid& grid) const override;
+    void step(uint32_t generations = 1) override;
+    uint64_t population() const override { return nodes[root].population; }
+    size_t getNodeCount() const { return nodes.size(); }
+};
@@ -0,0 +1,150 @@
+#include "VoxelEngine.h"
+#include "Trace.h"
+#include <utility>
+
+namespace {
+
+// Bit planes of a count per cell, plane i holding bit i. The x-y sums of nine cells fit 4 bits, the 3x3x3 totals 5
+struct Sum9 {
+    uint64_t planes[4];
+};
+
+// No live cell in the 3x3 squares of the layer
+bool isEmpty(const Sum9& sum)
+{
+    return (sum.planes[0] | sum.planes[1] | sum.planes[2] | sum.planes[3]) == 0;
+}
+
+// Sum of three one-bit words as (ones, twos)
+inline void add3(uint64_t a, uint64_t b, uint64_t c, uint64_t& ones, uint64_t& twos)
+{
+    const uint64_t ab = a ^ b;
+    ones = ab ^ c;
+    twos = (a & b) | (c & ab);
+}
+
+// Sum of every cell's 3x3 square in the x-y plane, from the brick layer around it as [dy + 1][dx + 1]
+Sum9 sumXY(const uint64_t (&bricks)[3][3])
+{
+    uint64_t ones[3];
+    uint64_t twos[3];
+    for (int dy = 0; dy < 3; dy++) {
+        const uint64_t center = bricks[dy][1];
+        add3(VoxelVolume::fromWest(center, bricks[dy][0]), center, VoxelVolume::fromEast(center, bricks[dy][2]),
+             ones[dy], twos[dy]);
+    }
+    // Three 2-bit row sums along y
+    uint64_t r0, carry2, t2, t4;
+    add3(VoxelVolume::fromSouth(ones[1], ones[0]), ones[1], VoxelVolume::fromNorth(ones[1], ones[2]), r0, carry2);
+    add3(VoxelVolume::fromSouth(twos[1], twos[0]), twos[1], VoxelVolume::fromNorth(twos[1], twos[2]), t2, t4);
+    const uint64_t carry4 = t2 & carry2;
+    return {{r0, t2 ^ carry2, t4 ^ carry4, t4 & carry4}};
+}
+
+// 5-bit totals of the 3x3x3 blocks from the x-y sums of the brick below, the brick and the one above
+void sumZ(const Sum9& below, const Sum9& center, const Sum9& above, uint64_t (&total)[5])
+{
+    uint64_t a[4];
+    uint64_t c[4];
+    for (int i = 0; i < 4; i++) {
+        a[i] = VoxelVolume::fromBelow(center.planes[i], below.planes[i]);
+        c[i] = VoxelVolume::fromAbove(center.planes[i], above.planes[i]);
+    }
+    const uint64_t* b = center.planes;
+    uint64_t carry2, p2, q4, carry4, p4, q8, carry8, p8, q16, carry16;
+    add3(a[0], b[0], c[0], total[0], carry2);
+    add3(a[1], b[1], c[1], p2, q4);
+    total[1] = p2 ^ carry2;
+    carry4 = p2 & carry2;
+    add3(a[2], b[2], c[2], p4, q8);
+    add3(p4, q4, carry4, total[2], carry8);
+    add3(a[3], b[3], c[3], p8, q16);
+    add3(p8, q8, carry8, total[3], carry16);
+    // Totals stop at 27, there is no bit 5
+    total[4] = q16 ^ carry16;
+}
+
+// Next state of every cell of center from its 3x3x3 totals (the cell included, so a live cell survives with a total
+// one above its neighbour count)
+uint64_t applyRule(const VoxelRule& rule, uint64_t center, const uint64_t (&total)[5])
+{
+    const uint32_t survive = rule.getSurviveMask() << 1;
+    const uint32_t birth = rule.getBirthMask();
+    uint64_t next = 0;
+    for (uint32_t value = 1; value <= VoxelRule::NEIGHBOURS + 1; value++) {
+        const bool keeps = (survive >> value) & 1;
+        const bool births = (birth >> value) & 1;
+        if (!keeps && !births) continue;
+        uint64_t match = ~0ull;
+        for (int i = 0; i < 5; i++) match &= (value >> i) & 1 ? total[i] : ~total[i];
+        next |= match & (keeps ? (births ? ~0ull : center) : ~center);
+    }
+    return next;
+}
+
+}
+
+VoxelEngine::VoxelEngine(const VoxelRule& rule, unsigned threads)
+    : rule(rule),
+      pool(threads)
+{
+}
+
+void VoxelEngine::load(const VoxelVolume& volume)
+{
+    current = volume;
+    next = VoxelVolume(volume.getSide());
+}
+
+void VoxelEngine::stepLayers(uint32_t begin, uint32_t end)
+{
+    const uint32_t n = current.getBricksPerSide();
+    const std::vector<uint64_t>& source = current.getBricks();
+    std::vector<uint64_t>& target = next.getBricks();
+    for (uint32_t by = 0; by < n; by++) {
+        const uint32_t ys[3] = {(by + n - 1) % n, by, (by + 1) % n};
+        for (uint32_t bx = 0; bx < n; bx++) {
+            const uint32_t xs[3] = {(bx + n - 1) % n, bx, (bx + 1) % n};
+            auto layerSum = [&](uint32_t bz, uint64_t& center) {
+                uint64_t bricks[3][3];
+                for (int dy = 0; dy < 3; dy++) {
+                    for (int dx = 0; dx < 3; dx++) bricks[dy][dx] = source[current.brickIndex(xs[dx], ys[dy], bz)];
+                }
+                center = bricks[1][1];
+                return sumXY(bricks);
+            };
+            // Sliding window up the column: the sums below, at and above bz
+            uint64_t unused, center, aboveCenter;
+            Sum9 below = layerSum((begin + n - 1) % n, unused);
+            Sum9 at = layerSum(begin, center);
+            for (uint32_t bz = begin; bz < end; bz++) {
+                const Sum9 above = layerSum((bz + 1) % n, aboveCenter);
+                uint64_t& out = target[current.brickIndex(bx, by, bz)];
+                if (isEmpty(below) && isEmpty(at) && isEmpty(above)) {
+                    // Every total is 0 and births need a live neighbour, so empty space stays empty without the adders
+                    out = 0;
+                } else {
+                    uint64_t total[5];
+                    sumZ(below, at, above, total);
+                    out = applyRule(rule, center, total);
+                }
+                below = at;
+                at = above;
+                center = aboveCenter;
+            }
+        }
+    }
+}
+
+void VoxelEngine::step(uint32_t generations)
+{
+    TRACE_SCOPE("VoxelEngine::step");
+    const uint32_t n = current.getBricksPerSide();
+    if (n == 0) return;
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        pool.parallelFor(n, [&](uint32_t begin, uint32_t end) {
+            if (begin < end) stepLayers(begin, end);
+        });
+        std::swap(current, next);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "ThreadPool.h"
+#include "VoxelRule.h"
+#include "VoxelVolume.h"
+
+// 3D Life (VoxelRule) on a torus of VoxelVolume bricks. A brick's 64 cells are stepped at once with bit-sliced
+// adders, separably: the three cells along x are summed into 2-bit planes, three of those sums along y into 4-bit
+// planes and three of those along z into the 5-bit total of the 3x3x3 block, which the rule reads as planes too. The
+// x and y sums of a brick serve the bricks below and above it as well, so each thread walks its share of brick layers
+// up one column at a time, keeping the last three. Bricks with all three sums empty skip the adders and stay empty.
+// Life's voxelMain is the GPU counterpart
+class VoxelEngine
+{
+private:
+    VoxelRule rule;
+    ThreadPool pool;
+    VoxelVolume current;
+    VoxelVolume next;
+
+    // Bricks bz in [begin, end) of every column
+    void stepLayers(uint32_t begin, uint32_t end);
+
+public:
+    // threads = 0 uses all hardware threads
+    explicit VoxelEngine(const VoxelRule& rule = VoxelRule{}, unsigned threads = 0);
+
+    // Takes effect with the next step, the volume is kept
+    void setRule(const VoxelRule& newRule) { rule = newRule; }
+    const VoxelRule& getRule() const { return rule; }
+    unsigned getThreadCount() const { return pool.getThreadCount(); }
+
+    void load(const VoxelVolume& volume);
+    const VoxelVolume& getVolume() const { return current; }
+    void step(uint32_t generations = 1);
+    uint64_t population() const { return current.population(); }
+};
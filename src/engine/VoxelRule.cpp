@@ -0,0 +1,60 @@
+#include "VoxelRule.h"
+#include "Engine.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Non-empty decimal number, the whole of text
+uint32_t parseNumber(std::string_view text, std::string_view rule)
+{
+    const bool digits = std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
+    if (text.empty() || text.size() > 2 || !digits) {
+        throw Engine::ConfigurationError("bad count in rule '" + std::string(rule) + "'");
+    }
+    uint32_t value = 0;
+    for (const char c : text) value = value * 10 + static_cast<uint32_t>(c - '0');
+    return value;
+}
+
+}
+
+VoxelRule VoxelRule::parse(std::string_view text)
+{
+    // "4555" is one digit per count, "4,5,5,5" one field per count
+    std::vector<std::string_view> fields;
+    if (text.find(',') == std::string_view::npos) {
+        for (size_t i = 0; i < text.size(); i++) fields.push_back(text.substr(i, 1));
+    } else {
+        for (size_t start = 0; start <= text.size();) {
+            const size_t comma = std::min(text.find(',', start), text.size());
+            fields.push_back(text.substr(start, comma - start));
+            start = comma + 1;
+        }
+    }
+    if (fields.size() != 4) {
+        throw Engine::ConfigurationError("3D rule '" + std::string(text) +
+                                         "' needs four counts: survival min and max, then birth min and max");
+    }
+
+    VoxelRule rule;
+    rule.surviveMin = parseNumber(fields[0], text);
+    rule.surviveMax = parseNumber(fields[1], text);
+    rule.birthMin = parseNumber(fields[2], text);
+    rule.birthMax = parseNumber(fields[3], text);
+    if (rule.surviveMin > rule.surviveMax || rule.birthMin > rule.birthMax || rule.surviveMax > NEIGHBOURS ||
+        rule.birthMax > NEIGHBOURS) {
+        throw Engine::ConfigurationError("bad count range in rule '" + std::string(text) + "'");
+    }
+    // A birth with no live cell around would fill the whole volume from nothing
+    if (rule.birthMin == 0) throw Engine::ConfigurationError("births need a live cell around (a birth minimum of 0)");
+    return rule;
+}
+
+std::string VoxelRule::toString() const
+{
+    const bool digits = surviveMax < 10 && birthMax < 10;
+    const std::string separator = digits ? "" : ",";
+    return std::to_string(surviveMin) + separator + std::to_string(surviveMax) + separator +
+           std::to_string(birthMin) + separator + std::to_string(birthMax);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 3D outer-totalistic rule over the 26 neighbours of a cubic cell, in Bays' notation: "4555" keeps a live cell with 4
+// to 5 live neighbours and gives birth with 5 to 5 (the environment range, then the fertility range). Counts of ten
+// and more are written with commas, "4,5,5,5" is the same rule. VoxelEngine and Life's voxelMain step it
+class VoxelRule
+{
+public:
+    static constexpr uint32_t NEIGHBOURS = 26;
+
+    uint32_t surviveMin = 4;
+    uint32_t surviveMax = 5;
+    uint32_t birthMin = 5;
+    uint32_t birthMax = 5;
+
+    // Throws Engine::ConfigurationError for anything but four counts up to NEIGHBOURS with min <= max, or a birth
+    // range that starts at 0
+    static VoxelRule parse(std::string_view text);
+    std::string toString() const;
+
+    // Bit n set: n live neighbours keep a live cell (survive) or make a dead one live (birth)
+    uint32_t getSurviveMask() const { return rangeMask(surviveMin, surviveMax); }
+    uint32_t getBirthMask() const { return rangeMask(birthMin, birthMax); }
+    bool nextState(bool alive, uint32_t count) const
+    {
+        return alive ? count >= surviveMin && count <= surviveMax : count >= birthMin && count <= birthMax;
+    }
+
+    bool operator==(const VoxelRule& other) const
+    {
+        return surviveMin == other.surviveMin && surviveMax == other.surviveMax && birthMin == other.birthMin &&
+               birthMax == other.birthMax;
+    }
+    bool operator!=(const VoxelRule& other) const { return !(*this == other); }
+
+private:
+    static uint32_t rangeMask(uint32_t min, uint32_t max) { return ((2u << max) - 1) & ~((1u << min) - 1); }
+};
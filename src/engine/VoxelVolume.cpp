@@ -0,0 +1,39 @@
+#include "VoxelVolume.h"
+#include "CounterRng.h"
+#include "Engine.h"
+#include <bitset>
+#include <string>
+
+VoxelVolume::VoxelVolume(uint32_t side)
+    : side(side),
+      bricksPerSide(side / BRICK_SIDE)
+{
+    if (side == 0 || side % BRICK_SIDE != 0) {
+        throw Engine::ConfigurationError("voxel volume side " + std::to_string(side) + " is not a multiple of " +
+                                         std::to_string(BRICK_SIDE));
+    }
+    bricks.assign(static_cast<size_t>(bricksPerSide) * bricksPerSide * bricksPerSide, 0);
+}
+
+uint64_t VoxelVolume::population() const
+{
+    uint64_t count = 0;
+    for (const uint64_t brick : bricks) count += std::bitset<64>(brick).count();
+    return count;
+}
+
+VoxelVolume VoxelVolume::makeSoup(uint32_t side, uint64_t seed, double density)
+{
+    VoxelVolume volume(side);
+    const CounterRng::Key key = CounterRng::makeKey(seed);
+    const uint32_t threshold = CounterRng::threshold(density);
+    for (uint32_t z = side / 4; z < side - side / 4; z++) {
+        for (uint32_t y = side / 4; y < side - side / 4; y++) {
+            for (uint32_t x = side / 4; x < side - side / 4; x++) {
+                const uint64_t index = (static_cast<uint64_t>(z) * side + y) * side + x;
+                if (CounterRng::at(key, index) < threshold) volume.setCell(x, y, z, true);
+            }
+        }
+    }
+    return volume;
+}
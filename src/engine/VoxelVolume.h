@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bit-packed cubic volume of cells in 4x4x4 bricks, one 64-bit word per brick: bit x + 4y + 16z of brick (bx, by, bz)
+// is cell (4bx + x, 4by + y, 4bz + z), and bricks are stored x fastest, then y, then z. Every neighbour of a cell is in
+// its own brick or one of the 26 around it, so a brick is stepped from 27 words instead of 64 * 27 cell reads.
+// Life's voxel buffers hold the same bytes, each brick as two u32 (z 0-1, then z 2-3)
+class VoxelVolume
+{
+public:
+    static constexpr uint32_t BRICK_SIDE = 4;
+
+    // Brick bits with x = 0, x = 3, y = 0 and y = 3
+    static constexpr uint64_t X0 = 0x1111111111111111ull;
+    static constexpr uint64_t X3 = 0x8888888888888888ull;
+    static constexpr uint64_t Y0 = 0x000F000F000F000Full;
+    static constexpr uint64_t Y3 = 0xF000F000F000F000ull;
+
+    // Every bit of the result is the cell one step west (x - 1), east, south (y - 1), north, below (z - 1) or above
+    // of the same bit in center, taken from the neighbouring brick on that side at the brick's face
+    static constexpr uint64_t fromWest(uint64_t center, uint64_t west)
+    {
+        return ((center << 1) & ~X0) | ((west >> 3) & X0);
+    }
+    static constexpr uint64_t fromEast(uint64_t center, uint64_t east)
+    {
+        return ((center >> 1) & ~X3) | ((east << 3) & X3);
+    }
+    static constexpr uint64_t fromSouth(uint64_t center, uint64_t south)
+    {
+        return ((center << 4) & ~Y0) | ((south >> 12) & Y0);
+    }
+    static constexpr uint64_t fromNorth(uint64_t center, uint64_t north)
+    {
+        return ((center >> 4) & ~Y3) | ((north << 12) & Y3);
+    }
+    static constexpr uint64_t fromBelow(uint64_t center, uint64_t below) { return (center << 16) | (below >> 48); }
+    static constexpr uint64_t fromAbove(uint64_t center, uint64_t above) { return (center >> 16) | (above << 48); }
+
+private:
+    uint32_t side = 0;
+    uint32_t bricksPerSide = 0;
+    std::vector<uint64_t> bricks;
+
+public:
+    VoxelVolume() = default;
+    // Empty side^3 volume. Throws Engine::ConfigurationError unless side is a positive multiple of BRICK_SIDE
+    explicit VoxelVolume(uint32_t side);
+
+    uint32_t getSide() const { return side; }
+    uint32_t getBricksPerSide() const { return bricksPerSide; }
+    std::vector<uint64_t>& getBricks() { return bricks; }
+    const std::vector<uint64_t>& getBricks() const { return bricks; }
+    size_t brickIndex(uint32_t bx, uint32_t by, uint32_t bz) const
+    {
+        return (static_cast<size_t>(bz) * bricksPerSide + by) * bricksPerSide + bx;
+    }
+
+    bool getCell(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        return (bricks[brickIndex(x / 4, y / 4, z / 4)] >> bitIndex(x, y, z)) & 1;
+    }
+    void setCell(uint32_t x, uint32_t y, uint32_t z, bool alive)
+    {
+        uint64_t& brick = bricks[brickIndex(x / 4, y / 4, z / 4)];
+        const uint64_t bit = 1ull << bitIndex(x, y, z);
+        brick = alive ? brick | bit : brick & ~bit;
+    }
+    uint64_t population() const;
+
+    bool operator==(const VoxelVolume& other) const { return side == other.side && bricks == other.bricks; }
+    bool operator!=(const VoxelVolume& other) const { return !(*this == other); }
+
+    // Random cells in the middle cube of half the side, dead elsewhere. Only depends on (seed, x + side * (y + side *
+    // z)), like Grid::fillRandom
+    static VoxelVolume makeSoup(uint32_t side, uint64_t seed, double density);
+
+private:
+    static uint32_t bitIndex(uint32_t x, uint32_t y, uint32_t z) { return (x & 3) + 4 * (y & 3) + 16 * (z & 3); }
+};
@@ -0,0 +1,386 @@
+#include "WebSocketServer.h"
+#include "Trace.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// Appended to Sec-WebSocket-Key before hashing (RFC 6455, section 1.3)
+constexpr std::string_view HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+constexpr uint8_t OPCODE_BINARY = 0x2;
+constexpr uint8_t OPCODE_CLOSE = 0x8;
+constexpr uint8_t OPCODE_PING = 0x9;
+constexpr uint8_t OPCODE_PONG = 0xA;
+
+// Written from the front, erased once this much of the output buffer has been sent
+constexpr size_t OUTPUT_COMPACT_BYTES = 64 * 1024;
+
+uint32_t rotateLeft(uint32_t value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+std::array<uint8_t, 20> sha1(std::string_view text)
+{
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    std::vector<uint8_t> message(text.begin(), text.end());
+    const uint64_t bitLength = static_cast<uint64_t>(text.size()) * 8;
+    message.push_back(0x80);
+    while (message.size() % 64 != 56) message.push_back(0);
+    for (int i = 7; i >= 0; i--) message.push_back(static_cast<uint8_t>(bitLength >> (i * 8)));
+
+    for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            const uint8_t* bytes = &message[chunk + i * 4];
+            w[i] = static_cast<uint32_t>(bytes[0]) << 24 | static_cast<uint32_t>(bytes[1]) << 16 |
+                   static_cast<uint32_t>(bytes[2]) << 8 | bytes[3];
+        }
+        for (int i = 16; i < 80; i++) w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+            const uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest {};
+    for (int i = 0; i < 20; i++) digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - i % 4 * 8));
+    return digest;
+}
+
+std::string base64(const uint8_t* data, size_t size)
+{
+    static constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < size; i += 3) {
+        const uint32_t chunk = static_cast<uint32_t>(data[i]) << 16 |
+                               (i + 1 < size ? static_cast<uint32_t>(data[i + 1]) << 8 : 0) |
+                               (i + 2 < size ? data[i + 2] : 0);
+        out += ALPHABET[chunk >> 18 & 63];
+        out += ALPHABET[chunk >> 12 & 63];
+        out += i + 1 < size ? ALPHABET[chunk >> 6 & 63] : '=';
+        out += i + 2 < size ? ALPHABET[chunk & 63] : '=';
+    }
+    return out;
+}
+
+std::string toLower(std::string_view text)
+{
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    return lower;
+}
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+bool setNonBlocking(int socket)
+{
+    const int flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+std::string errorText()
+{
+    return std::strerror(errno);
+}
+
+}
+
+WebSocketServer::WebSocketServer(const std::string& address, uint16_t port)
+{
+    sockaddr_in socketAddress {};
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &socketAddress.sin_addr) != 1) {
+        throw ServerError("not an IPv4 address: " + address);
+    }
+
+    listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSocket < 0) throw ServerError("socket: " + errorText());
+    const int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(listenSocket, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0 ||
+        listen(listenSocket, SOMAXCONN) != 0 || !setNonBlocking(listenSocket)) {
+        const std::string error = errorText();
+        ::close(listenSocket);
+        throw ServerError("cannot listen on " + address + ":" + std::to_string(port) + ": " + error);
+    }
+
+    socklen_t length = sizeof(socketAddress);
+    getsockname(listenSocket, reinterpret_cast<sockaddr*>(&socketAddress), &length);
+    this->port = ntohs(socketAddress.sin_port);
+}
+
+WebSocketServer::~WebSocketServer()
+{
+    for (auto& [id, connection] : connections) {
+        ::close(connection.socket);
+    }
+    if (listenSocket >= 0) ::close(listenSocket);
+}
+
+void WebSocketServer::poll(int timeoutMs)
+{
+    TRACE_SCOPE("WebSocketServer::poll");
+    std::vector<pollfd> sockets;
+    std::vector<ConnectionId> ids;
+    sockets.push_back({listenSocket, POLLIN, 0});
+    for (const auto& [id, connection] : connections) {
+        const bool writing = connection.outputOffset < connection.output.size();
+        sockets.push_back({connection.socket, static_cast<short>(POLLIN | (writing ? POLLOUT : 0)), 0});
+        ids.push_back(id);
+    }
+    if (::poll(sockets.data(), sockets.size(), timeoutMs) < 0) {
+        if (errno == EINTR) return;
+        throw ServerError("poll: " + errorText());
+    }
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        const short events = sockets[i + 1].revents;
+        auto it = connections.find(ids[i]);
+        if (it == connections.end()) continue;
+        Connection& connection = it->second;
+        bool alive = true;
+        if (events & (POLLIN | POLLHUP | POLLERR)) alive = read(ids[i], connection);
+        if (alive && (events & POLLOUT)) alive = flush(connection);
+        if (alive && connection.state == State::Closing && connection.outputOffset == connection.output.size()) {
+            alive = false;
+        }
+        if (!alive) drop(ids[i]);
+    }
+    if (sockets[0].revents & POLLIN) accept();
+}
+
+void WebSocketServer::accept()
+{
+    while (true) {
+        const int socket = ::accept(listenSocket, nullptr, nullptr);
+        if (socket < 0) return;
+        if (!setNonBlocking(socket)) {
+            ::close(socket);
+            continue;
+        }
+        // Messages are written whole, there is nothing to gain from Nagle's delay
+        const int noDelay = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        connections[nextId++].socket = socket;
+    }
+}
+
+bool WebSocketServer::read(ConnectionId id, Connection& connection)
+{
+    char buffer[4096];
+    while (true) {
+        const ssize_t received = recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (received == 0) return false;
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // Whatever a closing client still says does not matter
+        if (connection.state != State::Closing) connection.input.append(buffer, static_cast<size_t>(received));
+    }
+    if (connection.state == State::Handshake && !handshake(id, connection)) return false;
+    if (connection.state == State::Open && !readFrames(connection)) return false;
+    return flush(connection);
+}
+
+bool WebSocketServer::handshake(ConnectionId id, Connection& connection)
+{
+    const size_t end = connection.input.find("\r\n\r\n");
+    if (end == std::string::npos) return connection.input.size() <= MAX_INPUT_BYTES;
+    const std::string_view request = std::string_view(connection.input).substr(0, end + 2);
+
+    // "GET /target HTTP/1.1", then "Name: value" lines
+    std::string target;
+    std::string key;
+    bool upgrade = false;
+    size_t lineStart = 0;
+    while (lineStart < request.size()) {
+        const size_t lineEnd = request.find("\r\n", lineStart);
+        const std::string_view line = request.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 2;
+        if (target.empty()) {
+            const size_t first = line.find(' ');
+            const size_t second = line.find(' ', first + 1);
+            if (!line.starts_with("GET ") || second == std::string_view::npos) break;
+            target = line.substr(first + 1, second - first - 1);
+            continue;
+        }
+        const size_t colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        const std::string name = toLower(trim(line.substr(0, colon)));
+        const std::string_view value = trim(line.substr(colon + 1));
+        if (name == "upgrade") upgrade = toLower(value) == "websocket";
+        else if (name == "sec-websocket-key") key = value;
+    }
+    connection.input.erase(0, end + 4);
+
+    if (target.empty() || !upgrade || key.empty() || (onOpen && !onOpen(id, target))) {
+        static constexpr std::string_view REFUSED =
+            "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        connection.output.insert(connection.output.end(), REFUSED.begin(), REFUSED.end());
+        connection.state = State::Closing;
+        return true;
+    }
+
+    const std::array<uint8_t, 20> digest = sha1(key + std::string(HANDSHAKE_GUID));
+    const std::string response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                                 "Sec-WebSocket-Accept: " + base64(digest.data(), digest.size()) + "\r\n\r\n";
+    connection.output.insert(connection.output.end(), response.begin(), response.end());
+    connection.state = State::Open;
+    connection.opened = true;
+    return true;
+}
+
+bool WebSocketServer::readFrames(Connection& connection)
+{
+    while (connection.state == State::Open) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(connection.input.data());
+        const size_t available = connection.input.size();
+        if (available < 2) break;
+        const uint8_t opcode = bytes[0] & 0x0F;
+        // Clients always mask their frames
+        if (!(bytes[1] & 0x80)) return false;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (available < 4) break;
+            length = static_cast<uint64_t>(bytes[2]) << 8 | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; i++) length = length << 8 | bytes[2 + i];
+            header = 10;
+        }
+        if (length > MAX_INPUT_BYTES) return false;
+        if (available < header + 4 + length) break;
+
+        const uint8_t* mask = bytes + header;
+        std::vector<uint8_t> payload(length);
+        for (size_t i = 0; i < length; i++) payload[i] = bytes[header + 4 + i] ^ mask[i % 4];
+        connection.input.erase(0, header + 4 + length);
+
+        if (opcode == OPCODE_CLOSE) {
+            // Echo the status code (if any), then hang up once it is written
+            queueFrame(connection, OPCODE_CLOSE, payload.data(), std::min<size_t>(payload.size(), 2));
+            connection.state = State::Closing;
+        } else if (opcode == OPCODE_PING) {
+            queueFrame(connection, OPCODE_PONG, payload.data(), payload.size());
+        }
+    }
+    return connection.input.size() <= MAX_INPUT_BYTES + 14;
+}
+
+bool WebSocketServer::flush(Connection& connection)
+{
+    while (connection.outputOffset < connection.output.size()) {
+        const ssize_t written = ::send(connection.socket, connection.output.data() + connection.outputOffset,
+                                       connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        connection.outputOffset += static_cast<size_t>(written);
+    }
+    if (connection.outputOffset == connection.output.size()) {
+        connection.output.clear();
+        connection.outputOffset = 0;
+    } else if (connection.outputOffset >= OUTPUT_COMPACT_BYTES) {
+        connection.output.erase(connection.output.begin(), connection.output.begin() + connection.outputOffset);
+        connection.outputOffset = 0;
+    }
+    return true;
+}
+
+void WebSocketServer::queueFrame(Connection& connection, uint8_t opcode, const uint8_t* data, size_t size)
+{
+    std::vector<uint8_t>& out = connection.output;
+    // FIN set, one frame per message, servers never mask
+    out.push_back(static_cast<uint8_t>(0x80 | opcode));
+    if (size < 126) {
+        out.push_back(static_cast<uint8_t>(size));
+    } else if (size <= 0xFFFF) {
+        out.push_back(126);
+        out.push_back(static_cast<uint8_t>(size >> 8));
+        out.push_back(static_cast<uint8_t>(size));
+    } else {
+        out.push_back(127);
+        for (int i = 7; i >= 0; i--) out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(size) >> (i * 8)));
+    }
+    out.insert(out.end(), data, data + size);
+}
+
+bool WebSocketServer::send(ConnectionId id, const uint8_t* data, size_t size)
+{
+    auto it = connections.find(id);
+    if (it == connections.end() || it->second.state != State::Open) return false;
+    Connection& connection = it->second;
+    queueFrame(connection, OPCODE_BINARY, data, size);
+    if (!flush(connection)) {
+        // Dropped by the next poll, the caller may still be iterating its clients
+        connection.state = State::Closing;
+        connection.output.clear();
+        connection.outputOffset = 0;
+        return false;
+    }
+    return true;
+}
+
+void WebSocketServer::close(ConnectionId id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end() || it->second.state != State::Open) return;
+    // Status 1000, normal closure
+    const uint8_t status[2] = {0x03, 0xE8};
+    queueFrame(it->second, OPCODE_CLOSE, status, sizeof(status));
+    it->second.state = State::Closing;
+}
+
+void WebSocketServer::drop(ConnectionId id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    ::close(it->second.socket);
+    const bool opened = it->second.opened;
+    connections.erase(it);
+    if (opened && onClose) onClose(id);
+}
+
+size_t WebSocketServer::getQueuedBytes(ConnectionId id) const
+{
+    auto it = connections.find(id);
+    return it == connections.end() ? 0 : it->second.output.size() - it->second.outputOffset;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Minimal single-threaded WebSocket (RFC 6455) server for pushing binary messages to browsers, POSIX sockets only.
+// Everything happens inside poll: accepting, the HTTP upgrade, answering pings and closes, and writing queued
+// messages as far as each socket takes them. Messages from clients are read and dropped. A client that reads slower
+// than it is sent to keeps its backlog in getQueuedBytes, the caller decides when to stop sending to it
+class WebSocketServer
+{
+public:
+    class ServerError : public std::runtime_error {
+        public:
+            ServerError(const std::string& msg)
+                : std::runtime_error("WebSocket server: " + msg) {}
+    };
+
+    using ConnectionId = uint64_t;
+    // Called once a client completed the upgrade, with the request target (e.g. "/?x=0&y=0").
+    // Returning false refuses the client with a 400 response instead
+    using OpenCallback = std::function<bool(ConnectionId, const std::string& target)>;
+    // Called when an open connection goes away, for any reason
+    using CloseCallback = std::function<void(ConnectionId)>;
+
+private:
+    enum class State {
+        Handshake,
+        Open,
+        // Flushing the last bytes (a close frame or an error response), then closed
+        Closing,
+    };
+
+    struct Connection {
+        int socket = -1;
+        State state = State::Handshake;
+        // Upgraded (and accepted by onOpen), onClose is due when it goes
+        bool opened = false;
+        std::string input;
+        std::vector<uint8_t> output;
+        // Bytes of output already written
+        size_t outputOffset = 0;
+    };
+
+    // Handshake requests and client frames larger than this close the connection
+    static constexpr size_t MAX_INPUT_BYTES = 16 * 1024;
+
+    int listenSocket = -1;
+    uint16_t port = 0;
+    ConnectionId nextId = 1;
+    std::map<ConnectionId, Connection> connections;
+    OpenCallback onOpen;
+    CloseCallback onClose;
+
+    void accept();
+    // False once the connection should be dropped
+    bool read(ConnectionId id, Connection& connection);
+    bool handshake(ConnectionId id, Connection& connection);
+    bool readFrames(Connection& connection);
+    bool flush(Connection& connection);
+    void queueFrame(Connection& connection, uint8_t opcode, const uint8_t* data, size_t size);
+    void drop(ConnectionId id);
+
+public:
+    // Listens on address:port, port 0 picks a free port (see getPort)
+    WebSocketServer(const std::string& address, uint16_t port);
+    ~WebSocketServer();
+    WebSocketServer(const WebSocketServer&) = delete;
+    WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+    void setOnOpen(OpenCallback callback) { onOpen = std::move(callback); }
+    void setOnClose(CloseCallback callback) { onClose = std::move(callback); }
+
+    // Waits up to timeoutMs for socket activity and handles all of it
+    void poll(int timeoutMs);
+    // Queues a binary message and writes what the socket takes right away. False for connections that are not open
+    bool send(ConnectionId id, const uint8_t* data, size_t size);
+    // Sends a close frame, the connection goes once it is written
+    void close(ConnectionId id);
+
+    // Bytes queued for a connection and not yet taken by its socket
+    size_t getQueuedBytes(ConnectionId id) const;
+    // Connections in any state, including the ones still writing their last bytes
+    size_t getConnectionCount() const { return connections.size(); }
+    uint16_t getPort() const { return port; }
+};
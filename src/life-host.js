@@ -0,0 +1,168 @@
+// Where Life runs: on the page's main thread, or in a dedicated worker when index.html is opened with ?worker.
+// In the worker the page transfers its canvas (transferControlToOffscreen), the whole main loop runs here and the page
+// only forwards input and resizes by postMessage, so its own jank (layout, DOM work, slow handlers) cannot drop frames.
+// index.html loads this file as a plain script for lifeCommands and readLifeStatus, and starts it as the worker.
+// Every command takes { Module, canvas } first, the canvas being the page's element or the OffscreenCanvas
+
+// Snapshot of what the HUD shows. offsetMs moves the worker's clock onto the page's (ms since navigation start)
+function readLifeStatus(Module, offsetMs = 0) {
+    if (!Module || !Module._getPassTimingMs) return null;
+    const mark = (ms) => ms < 0 ? ms : ms + offsetMs;
+    return {
+        gridSize: Module._getGridSize(),
+        lattice: Module._getLattice(),
+        voxel: Module._getVoxel() !== 0,
+        // [pass][p50, p95, p99], pass as GpuTimer::Pass
+        timings: [0, 1, 2, 3].map((pass) => [50, 95, 99].map((p) => Module._getPassTimingMs(pass, p))),
+        period: Module._getCyclePeriod(),
+        generation: Module._getGeneration(),
+        paused: Module._isPaused() !== 0,
+        historyFirst: Module._getHistoryFirst(),
+        historyLast: Module._getHistoryLast(),
+        historyBytes: Module._getHistoryBytes(),
+        // Life::StartupMilestone order
+        startupMs: [0, 1, 2, 3, 4].map((milestone) => mark(Module._getStartupMs(milestone))),
+        stream: lifeStream.url ? {
+            connected: lifeStream.connected,
+            bytes: lifeStream.bytes,
+            messages: lifeStream.messages,
+            keyframes: lifeStream.keyframes,
+        } : null,
+    };
+}
+
+// life_serve connection (see connectStream), lives next to Life so messages never wait on the page
+const lifeStream = { url: null, connected: false, bytes: 0, messages: 0, keyframes: 0 };
+
+const lifeCommands = {
+    resize({ Module, canvas }, width, height) {
+        canvas.width = width;
+        canvas.height = height;
+        if (Module && Module._handleResize) Module._handleResize();
+    },
+
+    // cells is a list of [x, y], y = 0 the bottom row
+    setCells({ Module }, cells, alive) {
+        if (!Module || !Module._setCell) return;
+        for (const [x, y] of cells) Module._setCell(x, y, alive);
+    },
+
+    stamp({ Module }, pattern, x, y) {
+        if (!Module || !Module._stampPattern) return;
+        Module.ccall('stampPattern', 'number', ['string', 'number', 'number'], [pattern, x, y]);
+    },
+
+    // Golly Larger than Life notation or a name like 'bosco' (LtlRule::NAMES)
+    setRule({ Module }, rule) {
+        if (!Module || !Module._setRule) return;
+        Module.ccall('setRule', 'number', ['string'], [rule]);
+    },
+
+    // Lenia rule like 'R13,T10,M0.15,S0.015' or 'orbium' (LeniaRule::NAMES), '' for the binary rules again
+    setLenia({ Module }, rule) {
+        if (!Module || !Module._setLeniaRule) return;
+        Module.ccall('setLeniaRule', 'number', ['string'], [rule]);
+    },
+
+    // Lattice rule like 'B2/S34H' or 'triangle' (LatticeRule::NAMES), '' for the square lattice again
+    setLattice({ Module }, rule) {
+        if (!Module || !Module._setLatticeRule) return;
+        Module.ccall('setLatticeRule', 'number', ['string'], [rule]);
+    },
+
+    // 3D rule in Bays' notation like '4555' (VoxelRule), '' for the board again
+    setVoxel({ Module }, rule) {
+        if (!Module || !Module._setVoxelRule) return;
+        Module.ccall('setVoxelRule', 'number', ['string'], [rule]);
+    },
+
+    // Orbit of the voxel camera: yaw and pitch in radians, distance in volume sides
+    setVoxelView({ Module }, yaw, pitch, distance) {
+        if (Module && Module._setVoxelView) Module._setVoxelView(yaw, pitch, distance);
+    },
+
+    togglePause({ Module }) {
+        if (!Module || !Module._setPaused) return;
+        Module._setPaused(Module._isPaused() ? 0 : 1);
+    },
+
+    // Pauses and moves stride generations through the history. Stepping past the newest recorded generation
+    // simulates it
+    seekBy({ Module }, stride) {
+        if (!Module || !Module._seekGeneration) return;
+        Module._setPaused(1);
+        if (stride < 0) {
+            const first = Module._getHistoryFirst();
+            if (first >= 0) Module._seekGeneration(Math.max(first, Module._getGeneration() + stride));
+        } else if (!Module._seekGeneration(Module._getGeneration() + stride)) {
+            Module._requestStep();
+        }
+    },
+
+    saveTrace({ Module }) {
+        if (Module && Module._saveTrace) Module._saveTrace();
+    },
+
+    // Shows the window of this grid's size at (x, y) of a life_serve board instead of simulating. Every DeltaStream
+    // message goes to Life, which uploads the newest board each frame. Lost or out-of-step connections are reopened
+    // after a second and start over from a keyframe
+    connectStream(context, url, x, y) {
+        const { Module } = context;
+        lifeStream.url = url;
+        // Life takes messages once its resources exist (StartupMilestone::Resources)
+        if (!Module || !Module._getStartupMs || Module._getStartupMs(2) < 0) {
+            setTimeout(() => lifeCommands.connectStream(context, url, x, y), 100);
+            return;
+        }
+        const target = new URL(url);
+        const size = String(Module._getGridSize());
+        target.searchParams.set('x', x);
+        target.searchParams.set('y', y);
+        target.searchParams.set('width', size);
+        target.searchParams.set('height', size);
+        const socket = new WebSocket(target);
+        socket.binaryType = 'arraybuffer';
+        socket.onopen = () => { lifeStream.connected = true; };
+        socket.onmessage = (event) => {
+            const message = new Uint8Array(event.data);
+            lifeStream.bytes += message.length;
+            lifeStream.messages++;
+            if (message[0] === 'K'.charCodeAt(0)) lifeStream.keyframes++;
+            if (!Module.ccall('receiveStreamMessage', 'number', ['array', 'number'], [message, message.length])) {
+                socket.close();
+            }
+        };
+        socket.onclose = () => {
+            lifeStream.connected = false;
+            Module._resetStream();
+            setTimeout(() => lifeCommands.connectStream(context, url, x, y), 1000);
+        };
+    },
+};
+
+// Worker entry: { type: 'start', canvas, arguments, script, timeOrigin } once, then { type: command, args }.
+// Posts { type: 'status', status } a few times a second and { type: 'download', name, blob } for saveTrace
+if (typeof WorkerGlobalScope !== 'undefined' && self instanceof WorkerGlobalScope) {
+    const STATUS_INTERVAL_MS = 250;
+    let context = null;
+    self.onmessage = ({ data }) => {
+        if (data.type !== 'start') {
+            if (context) lifeCommands[data.type](context, ...data.args);
+            return;
+        }
+        const offsetMs = performance.timeOrigin - data.timeOrigin;
+        self.Module = {
+            canvas: data.canvas,
+            arguments: data.arguments,
+            // Surface creation and canvas size queries look up "#canvas", which only the page's document has
+            preRun: [(module) => { module.specialHTMLTargets['#canvas'] = data.canvas; }],
+            onRuntimeInitialized: () => {
+                postMessage({ type: 'runtime', ms: performance.now() + offsetMs });
+                setInterval(() => postMessage({ type: 'status', status: readLifeStatus(self.Module, offsetMs) }),
+                            STATUS_INTERVAL_MS);
+            },
+        };
+        context = { Module: self.Module, canvas: data.canvas };
+        importScripts(data.script);
+    };
+}
@@ -1,12 +1,28 @@
 #define WEBGPU_CPP_IMPLEMENTATION
 #include "webgpu.hpp"
 #include "Life.h"
+#include "Trace.h"
+#include "Pattern.h"
+#include <random>
+#include <string>
 
 static constexpr int FPS = 0;
 static constexpr bool SIMULATE_INFINITE_LOOP = true;
 
-// Global pointer to access from C callback
+// Owns the simulation for the lifetime of the page (main returns into the browser's event loop)
+static std::unique_ptr<Life> g_lifeOwner;
+// Global pointer to access from C callback, set once startup finished so the exports ignore calls until then
 static Life* g_life = nullptr;
+// The main loop is paused while Life is idle (halted, paused or showing a quiet stream), so an always-on page that
+// shows a dead board wakes up neither the CPU nor the GPU. Every export that can give the next frame work resumes it
+static bool g_mainLoopPaused = false;
+
+static void wakeMainLoop() {
+    if (g_mainLoopPaused) {
+        g_mainLoopPaused = false;
+        emscripten_resume_main_loop();
+    }
+}
 
 // Emscripten exposed function, called during window resize
 extern "C" {
@@ -14,23 +30,343 @@ extern "C" {
     void handleResize() {
         if (g_life) {
             g_life->handleResize();
+            wakeMainLoop();
+        }
+    }
+
+    // Rolling per-pass timing for the HUD, pass is a GpuTimer::Pass (0 compute, 1 render, 2 submit-to-done, 3 CPU encode)
+    // Returns -1 when there are no samples (e.g. no timestamp-query support for the GPU passes)
+    EMSCRIPTEN_KEEPALIVE
+    double getPassTimingMs(int pass, double percentile) {
+        if (!g_life || pass < 0 || pass >= static_cast<int>(GpuTimer::PASS_COUNT)) {
+            return -1.0;
+        }
+        return g_life->getGpuTimer().getPercentileMs(static_cast<GpuTimer::Pass>(pass), percentile);
+    }
+
+    // Restarts the simulation from a new seeded board (seed is passed as a double, so exact up to 2^53)
+    EMSCRIPTEN_KEEPALIVE
+    void reseed(double seed, double density) {
+        if (g_life) {
+            g_life->seed(static_cast<uint64_t>(seed), density);
+            wakeMainLoop();
+        }
+    }
+
+    // Period of the repeating board (1 for dead or still boards), 0 until a repeat has been seen
+    EMSCRIPTEN_KEEPALIVE
+    double getCyclePeriod() {
+        if (!g_life || !g_life->getPeriodMonitor().getCycle()) {
+            return 0.0;
+        }
+        return static_cast<double>(g_life->getPeriodMonitor().getCycle()->period);
+    }
+
+    // Whether stepping stops once the board repeats (on by default)
+    EMSCRIPTEN_KEEPALIVE
+    void setHaltOnCycle(int halt) {
+        if (g_life) {
+            g_life->setHaltOnCycle(halt != 0);
+            wakeMainLoop();
+        }
+    }
+
+    // Glues the board edges as Topology::Kind kind (0 torus, 1 plane, 2 Klein bottle, 3 cross-surface, 4 sphere),
+    // returns 0 when the board cannot have that topology
+    EMSCRIPTEN_KEEPALIVE
+    int setTopology(int kind) {
+        if (!g_life || kind < 0 || kind >= static_cast<int>(Topology::NAMES.size())) {
+            return 0;
+        }
+        try {
+            g_life->setTopology(static_cast<Topology::Kind>(kind));
+            wakeMainLoop();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 0;
+        }
+        return 1;
+    }
+
+    // Steps the board with rule from now on: Golly's Larger than Life notation ("R5,C0,M1,S34..58,B34..45,NM") or a
+    // name like "bosco" or "life" (see LtlRule::NAMES). Returns 0 when it cannot be parsed or run on this topology
+    EMSCRIPTEN_KEEPALIVE
+    int setRule(const char* rule) {
+        if (!g_life || !rule) {
+            return 0;
+        }
+        try {
+            g_life->setRule(LtlRule::parse(rule));
+            wakeMainLoop();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 0;
+        }
+        return 1;
+    }
+
+    // Switches to Lenia with rule ("R13,T10,M0.15,S0.015" or a name like "orbium", see LeniaRule::NAMES), or back to
+    // the binary rules with an empty string. Reseeds the board. Returns 0 when it cannot be parsed or run on this
+    // topology
+    EMSCRIPTEN_KEEPALIVE
+    int setLeniaRule(const char* rule) {
+        if (!g_life || !rule) {
+            return 0;
+        }
+        try {
+            const std::string_view text = rule;
+            g_life->setLeniaRule(text.empty() ? std::nullopt : std::optional<LeniaRule>(LeniaRule::parse(text)));
+            wakeMainLoop();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 0;
+        }
+        return 1;
+    }
+
+    // Switches to the hexagonal or triangular lattice with rule ("B2/S34H", "B4/S345T", or "hex", "triangle", see
+    // LatticeRule::NAMES), or back to the square one with an empty string. Keeps the board. Returns 0 when it cannot be
+    // parsed or run with the current rule and topology
+    EMSCRIPTEN_KEEPALIVE
+    int setLatticeRule(const char* rule) {
+        if (!g_life || !rule) {
+            return 0;
+        }
+        try {
+            const std::string_view text = rule;
+            g_life->setLatticeRule(text.empty() ? std::nullopt
+                                                : std::optional<LatticeRule>(LatticeRule::parse(text)));
+            wakeMainLoop();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 0;
+        }
+        return 1;
+    }
+
+    // LatticeRule::Kind of the board, 0 for squares (the page maps pointer positions to cells with it)
+    EMSCRIPTEN_KEEPALIVE
+    int getLattice() {
+        if (!g_life || !g_life->getLatticeRule()) {
+            return 0;
+        }
+        return static_cast<int>(g_life->getLatticeRule()->kind);
+    }
+
+    // Switches to 3D Life with rule in Bays' notation ("4555" or "4,5,5,5", see VoxelRule) on a getGridSize()^3
+    // volume, or back to the board with an empty string. Reseeds either way. Returns 0 when it cannot be parsed or run
+    // with the current modes and topology
+    EMSCRIPTEN_KEEPALIVE
+    int setVoxelRule(const char* rule) {
+        if (!g_life || !rule) {
+            return 0;
+        }
+        try {
+            const std::string_view text = rule;
+            g_life->setVoxelRule(text.empty() ? std::nullopt : std::optional<VoxelRule>(VoxelRule::parse(text)));
+            wakeMainLoop();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 0;
+        }
+        return 1;
+    }
+
+    // 1 while a volume is shown (the page orbits the camera on drags instead of editing cells)
+    EMSCRIPTEN_KEEPALIVE
+    int getVoxel() {
+        return g_life && g_life->getVoxelRule() ? 1 : 0;
+    }
+
+    // Orbits the voxel camera, yaw and pitch in radians, distance in volume sides (see Life::setVoxelView)
+    EMSCRIPTEN_KEEPALIVE
+    void setVoxelView(float yaw, float pitch, float distance) {
+        if (g_life) {
+            g_life->setVoxelView(yaw, pitch, distance);
+            wakeMainLoop();
         }
     }
+
+    // Board width and height in cells (the page maps pointer positions to cells with it)
+    EMSCRIPTEN_KEEPALIVE
+    int getGridSize() {
+        return Life::getGridSize();
+    }
+
+    // Draws (alive = 1) or erases (alive = 0) one cell, y = 0 is the bottom row. Applied on the next frame
+    EMSCRIPTEN_KEEPALIVE
+    void setCell(int x, int y, int alive) {
+        if (g_life) {
+            g_life->getCellEditor().setCell(x, y, alive != 0);
+            wakeMainLoop();
+        }
+    }
+
+    // Stamps the live cells of pattern (a builtin name like "glider", or RLE text) centred on cell (x, y).
+    // Returns 0 when the pattern cannot be parsed
+    EMSCRIPTEN_KEEPALIVE
+    int stampPattern(const char* pattern, int x, int y) {
+        if (!g_life || !pattern) {
+            return 0;
+        }
+        try {
+            const std::string_view text = pattern;
+            const Pattern stamp = text.find('!') != std::string_view::npos ? Pattern::fromRle(text)
+                                                                            : Pattern::getBuiltin(text);
+            const int64_t left = x - static_cast<int64_t>(stamp.getWidth() / 2);
+            const int64_t top = y + static_cast<int64_t>(stamp.getHeight() / 2);
+            g_life->getCellEditor().stamp(stamp.getCells(), left, top);
+            wakeMainLoop();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 0;
+        }
+        return 1;
+    }
+
+    // Generation currently shown (as a double, like the seed)
+    EMSCRIPTEN_KEEPALIVE
+    double getGeneration() {
+        return g_life ? static_cast<double>(g_life->getGeneration()) : 0.0;
+    }
+
+    // Oldest and newest generation the board can be rewound to, -1 while nothing has been recorded
+    EMSCRIPTEN_KEEPALIVE
+    double getHistoryFirst() {
+        if (!g_life || !g_life->getHistory().getFirstGeneration()) {
+            return -1.0;
+        }
+        return static_cast<double>(*g_life->getHistory().getFirstGeneration());
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getHistoryLast() {
+        if (!g_life || !g_life->getHistory().getLastGeneration()) {
+            return -1.0;
+        }
+        return static_cast<double>(*g_life->getHistory().getLastGeneration());
+    }
+
+    // Memory held by the compressed history
+    EMSCRIPTEN_KEEPALIVE
+    double getHistoryBytes() {
+        return g_life ? static_cast<double>(g_life->getHistory().getMemoryBytes()) : 0.0;
+    }
+
+    // Rewinds (or fast-forwards) to a recorded generation, returns 0 when it is not in the history
+    EMSCRIPTEN_KEEPALIVE
+    int seekGeneration(double generation) {
+        if (!g_life || generation < 0.0) {
+            return 0;
+        }
+        wakeMainLoop();
+        return g_life->seekGeneration(static_cast<uint64_t>(generation)) ? 1 : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setPaused(int pause) {
+        if (g_life) {
+            g_life->setPaused(pause != 0);
+            wakeMainLoop();
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int isPaused() {
+        return g_life && g_life->isPaused() ? 1 : 0;
+    }
+
+    // Steps one generation on the next frame, also while paused
+    EMSCRIPTEN_KEEPALIVE
+    void requestStep() {
+        if (g_life) {
+            g_life->requestStep();
+            wakeMainLoop();
+        }
+    }
+
+    // Applies one binary message of a life_serve stream (index.html ?stream=), stepping stops with the first board.
+    // Returns 0 when it does not apply (out of order or another board size), the page then reconnects for a keyframe
+    EMSCRIPTEN_KEEPALIVE
+    int receiveStreamMessage(const uint8_t* data, int size) {
+        if (!g_life || !data || size <= 0) {
+            return 0;
+        }
+        wakeMainLoop();
+        return g_life->receiveStreamMessage(data, static_cast<size_t>(size)) ? 1 : 0;
+    }
+
+    // The stream connection closed, the next one has to start with a keyframe
+    EMSCRIPTEN_KEEPALIVE
+    void resetStream() {
+        if (g_life) {
+            g_life->resetStream();
+        }
+    }
+
+    // Page time in ms (since navigation start) a Life::StartupMilestone was reached at: 0 adapter, 1 device,
+    // 2 resources, 3 first frame, 4 first generation. -1 until then
+    EMSCRIPTEN_KEEPALIVE
+    double getStartupMs(int milestone) {
+        if (!g_lifeOwner || milestone < 0 || milestone >= static_cast<int>(Life::STARTUP_MILESTONE_COUNT)) {
+            return -1.0;
+        }
+        return g_lifeOwner->getStartupMs(static_cast<Life::StartupMilestone>(milestone));
+    }
+
+    // Downloads the recorded frame trace (empty unless built with LIFE_ENABLE_TRACING)
+    EMSCRIPTEN_KEEPALIVE
+    void saveTrace() {
+        Trace::save("life-trace.json");
+    }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    TRACE_THREAD_NAME("main");
     try {
-        Life life {};
-        g_life = &life;
-        auto renderLoop = [&life]() {
-            life.renderFrame();
-        };
-        emscripten_set_main_loop_arg(
-            [](void* arg) {
-                auto* loop = static_cast<decltype(renderLoop)*>(arg);
-                (*loop)();
+        // Optional "--seed N --density D --halt 0|1 --topology name --steps N --rule rule --lenia rule
+        // --lattice rule --voxel rule" (index.html forwards the same page parameters)
+        uint64_t seed = std::random_device{}();
+        double density = 0.5;
+        bool haltOnCycle = true;
+        Topology::Kind topology = Topology::Kind::Torus;
+        uint32_t stepsPerFrame = 1;
+        LtlRule rule;
+        std::optional<LeniaRule> leniaRule;
+        std::optional<LatticeRule> latticeRule;
+        std::optional<VoxelRule> voxelRule;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string_view arg = argv[i];
+            if (arg == "--seed") seed = std::stoull(argv[i + 1]);
+            else if (arg == "--density") density = std::stod(argv[i + 1]);
+            else if (arg == "--halt") haltOnCycle = std::string_view(argv[i + 1]) != "0";
+            else if (arg == "--topology") topology = Topology::parse(argv[i + 1]);
+            else if (arg == "--steps") stepsPerFrame = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+            else if (arg == "--rule") rule = LtlRule::parse(argv[i + 1]);
+            else if (arg == "--lenia") leniaRule = LeniaRule::parse(argv[i + 1]);
+            else if (arg == "--lattice") latticeRule = LatticeRule::parse(argv[i + 1]);
+            else if (arg == "--voxel") voxelRule = VoxelRule::parse(argv[i + 1]);
+        }
+        // Startup continues from WebGPU callbacks, the loop draws nothing until the board is ready
+        g_lifeOwner = std::make_unique<Life>(seed, density);
+        g_lifeOwner->setHaltOnCycle(haltOnCycle);
+        g_lifeOwner->setStepsPerFrame(stepsPerFrame);
+        if (topology != Topology::Kind::Torus) g_lifeOwner->setTopology(topology);
+        if (!rule.isConway()) g_lifeOwner->setRule(rule);
+        if (leniaRule) g_lifeOwner->setLeniaRule(leniaRule);
+        if (latticeRule) g_lifeOwner->setLatticeRule(latticeRule);
+        if (voxelRule) g_lifeOwner->setVoxelRule(voxelRule);
+        g_lifeOwner->setOnReady([](Life& life) {
+            g_life = &life;
+        });
+        emscripten_set_main_loop(
+            []() {
+                g_lifeOwner->renderFrame();
+                if (g_lifeOwner->isIdle()) {
+                    g_mainLoopPaused = true;
+                    emscripten_pause_main_loop();
+                }
             },
-            &renderLoop,
             FPS,
             SIMULATE_INFINITE_LOOP
         );
@@ -0,0 +1,22 @@
+// Helpers shared by the shaders, pulled in with an include line (see cmake/EmbedShaders.cmake).
+// They expect the grid uniform of the including shader
+fn storageIndex(cell: vec2i) -> u32 {
+  // Cells are stored in a 1D array of (grid.x + 2) x (grid.y + 2) cells with the board at (1, 1),
+  // so cell (x, y) is valid for x in [-1, grid.x] and y in [-1, grid.y] (the halo filled by haloMain)
+  return u32(cell.y + 1) * (u32(grid.x) + 2) + u32(cell.x + 1);
+}
+
+// Counter-based RNG, must match CounterRng::mix and CounterRng::at bit for bit
+fn mix32(value: u32) -> u32 {
+  var x = value;
+  x ^= x >> 16u;
+  x *= 0x7feb352du;
+  x ^= x >> 15u;
+  x *= 0x846ca68bu;
+  x ^= x >> 16u;
+  return x;
+}
+
+fn cellRandom(key: vec2u, index: u32) -> u32 {
+  return mix32(mix32(index ^ key.x) ^ key.y);
+}
@@ -6,10 +6,69 @@
 
 // Cell state buffers (Alternative between Life::PingPongBuffers::read and ::write each frame)
 // Stored as u32 (not bool) for arithmetic convenience and storage buffer compatibility
+// The board is surrounded by a one-cell halo filled by haloMain (see storageIndex)
 // This could be optimized with bitpacking and bitwise operations, but memory savings are negligible at low grid sizes
 @group(0) @binding(1) var<storage> cellStateIn: array<u32>; // Current state
 @group(0) @binding(2) var<storage, read_write> cellStateOut: array<u32>; // Next state
 
+// Seed parameters (Life::SeedParams), key derived from the seed by CounterRng::makeKey on the CPU
+struct SeedParams {
+  key: vec2u,
+  threshold: u32, // Cells with cellRandom(key, index) < threshold start alive
+  padding: u32,
+};
+@group(0) @binding(3) var<uniform> seedParams: SeedParams;
+
+// Read back by PeriodMonitor (PeriodMonitor::getSummaryBuffer) and cleared before each step: the hash of the board
+// written by hashMain (low and high 32 bits) and the number of cells computeMain changed
+struct BoardSummary {
+  hash: array<atomic<u32>, 2>,
+  changedCells: atomic<u32>,
+};
+@group(0) @binding(4) var<storage, read_write> boardSummary: BoardSummary;
+
+// Pointer edits for editMain (CellEditor::upload), each cell packed as storageIndex << 1 | state
+struct CellEdits {
+  count: u32,
+  cells: array<u32>,
+};
+@group(0) @binding(5) var<storage> cellEdits: CellEdits;
+
+// Bit-packed board for the rewind history (HistoryRecorder), 32 cells per word in row-major order.
+// Written by packMain for readback, read by unpackMain when seeking
+@group(0) @binding(6) var<storage, read_write> packedBoard: array<u32>;
+
+// Summed-area table of the board for the Larger than Life passes (ltlRowsMain, ltlColumnsMain, ltlMain), sized for
+// LtlRule::MAX_RADIUS. Laid out as ltlTableIndex describes
+@group(0) @binding(7) var<storage, read_write> ltlTable: array<u32>;
+
+// Lenia kernel weights for leniaMain, (2 * LENIA_RADIUS + 1)^2 in row-major order (LeniaRule::kernel), sized for
+// LeniaRule::MAX_RADIUS
+@group(0) @binding(8) var<storage> leniaKernel: array<f32>;
+
+// Occupancy mip of the 3D volume (Life::VOXEL_MIP_LEVELS levels, see voxelOccupancyIndex): level 1 flags the bricks
+// with a live cell, every level above the 2x2x2 blocks of the one below. Written by voxelMain and voxelMipMain, read
+// by voxelFragmentMain to skip empty space
+@group(0) @binding(9) var<storage, read_write> voxelOccupancy: array<u32>;
+
+// Orbit camera of voxelFragmentMain (Life::writeVoxelCamera), in cell units of the volume. right and up are scaled to
+// the edges of the view, so the ray of a pixel is forward + ndc.x * right + ndc.y * up
+struct VoxelCamera {
+  eye: vec4f,
+  right: vec4f,
+  up: vec4f,
+  forward: vec4f,
+};
+@group(0) @binding(10) var<uniform> voxelCamera: VoxelCamera;
+
+// Continuous states (Lenia): every cell holds the bits of an f32 in [0, 1] instead of 0 or 1. Baked into the render
+// and edit variants, the stepping passes are Lenia's own (leniaMain)
+override CONTINUOUS: bool = false;
+
+// Lattice the cells are drawn on (LatticeRule::Kind): 0 squares, 1 hexagons in offset rows, 2 triangles. Baked into
+// the render variants, every lattice has its own shape in Life::vertexBuffer and its own stepping pass
+override LATTICE: u32 = 0;
+
 // ======================================================
 // Vertex Shader Input/Output Structs
 // ======================================================
@@ -20,28 +79,61 @@ struct VertexInput {
 struct VertexOutput {
   @builtin(position) pos: vec4f, // Clip space position, must be returned to GPU
   @location(0) cell: vec2f, // Cell position in grid, use in fragment shader
+  @location(1) @interpolate(flat) value: f32, // Continuous state of the cell, 0 unless CONTINUOUS
 };
 
 // ======================================================
 // Vertex Shader
 // ======================================================
+// Centre of a cell in cell units: odd hex rows sit half a cell to the right, triangles half a cell apart
+fn latticeCenter(cell: vec2f) -> vec2f {
+  if (LATTICE == 1u) {
+    return vec2f(cell.x + 0.5 + 0.5 * (cell.y % 2), cell.y + 0.5);
+  }
+  if (LATTICE == 2u) {
+    return vec2f(0.5 * cell.x + 0.5, cell.y + 0.5);
+  }
+  return cell + 0.5;
+}
+
+// Size of the board in cell units, stretched over the whole canvas
+fn latticeExtent() -> vec2f {
+  if (LATTICE == 1u) {
+    return vec2f(grid.x + 0.5, grid.y);
+  }
+  if (LATTICE == 2u) {
+    return vec2f(0.5 * grid.x + 0.5, grid.y);
+  }
+  return grid;
+}
+
 @vertex
 fn vertexMain(input: VertexInput) -> VertexOutput  {
   // Convert instance index to cell position
   let i = f32(input.instance); // Get instance index as float
   let cell = vec2f(i % grid.x, floor(i / grid.x)); // Convert to cell coordinates (x,y)
 
-  // Get cell state (0 or 1)
-  let state = f32(cellStateIn[input.instance]);
+  // Get cell state (0 or 1). Continuous cells are all drawn, coloured by their value
+  var state = f32(cellStateIn[storageIndex(vec2i(cell))]);
+  var value = 0.0;
+  if (CONTINUOUS) {
+    value = bitcast<f32>(cellStateIn[storageIndex(vec2i(cell))]);
+    state = 1.0;
+  }
 
-  // Convert cell's grid position to clip space
-  let cellOffset = cell / grid * 2;
-  let gridPos = (input.pos * state + 1) / grid - 1 + cellOffset;
+  // Convert cell's grid position to clip space, vertices are in half-cell units around the centre.
+  // Triangles point up where x + y is even, the others are the same shape flipped
+  var corner = input.pos * state;
+  if (LATTICE == 2u && (u32(cell.x) + u32(cell.y)) % 2u == 1u) {
+    corner.y = -corner.y;
+  }
+  let gridPos = (latticeCenter(cell) + corner * 0.5) / latticeExtent() * 2 - 1;
 
   // Return output to GPU
   var output: VertexOutput;
   output.pos = vec4f(gridPos, 0, 1);
   output.cell = cell;
+  output.value = value;
   return output;
 }
 
@@ -52,25 +144,31 @@ fn vertexMain(input: VertexInput) -> VertexOutput  {
 // Takes VertexOutput (see above) as fragment input
 // Runs for each pixel in each fragment in each cell
 fn fragmentMain(input: VertexOutput) -> @location(0) vec4f {
+  if (CONTINUOUS) {
+    return vec4f(viridis(input.value), 1);
+  }
   // Color based on cell position in grid (gradient effect calculated from x, y position)
-  let c = input.cell / grid;
+  let c = (latticeCenter(input.cell) - 0.5) / latticeExtent();
   return vec4f(c.x, c.y, 1-c.x, 1);
 }
 
+// Viridis colormap of t in [0, 1], a degree 6 polynomial fit per channel
+fn viridis(t: f32) -> vec3f {
+  let c0 = vec3f(0.2777273272234177, 0.005407344544966578, 0.3340998053353061);
+  let c1 = vec3f(0.1050930431085774, 1.404613529898575, 1.384590162594685);
+  let c2 = vec3f(-0.3308618287255563, 0.214847559468213, 0.09509516302823659);
+  let c3 = vec3f(-4.634230498983486, -5.799100973351585, -19.33244095627987);
+  let c4 = vec3f(6.228269936347081, 14.17993336680509, 56.69055260068105);
+  let c5 = vec3f(4.776384997670288, -13.74514537774601, -65.35303263337234);
+  let c6 = vec3f(-5.435455855934631, 4.645852612178535, 26.3124352495832);
+  let x = clamp(t, 0.0, 1.0);
+  return c0 + x * (c1 + x * (c2 + x * (c3 + x * (c4 + x * (c5 + x * c6)))));
+}
+
 // ======================================================
 // Compute Shader Helper Functions
 // ======================================================
-fn cellIndex(cell: vec2u) -> u32 {
-  // Cells are stored in a 1D array, so converts 2D (x,y) to 1D index
-  // Wraps around edges using modulo operator, so opposite edges are connected
-  return (cell.y % u32(grid.y)) * u32(grid.x) +
-         (cell.x % u32(grid.x));
-}
-
-fn cellActive(x: u32, y: u32) -> u32 {
-  // Gets cell active state (0 or 1) for index converted from (x,y)
-  return cellStateIn[cellIndex(vec2(x, y))];
-}
+#include "common.wgsl"
 
 // ======================================================
 // Compute Shader
@@ -79,29 +177,681 @@ fn cellActive(x: u32, y: u32) -> u32 {
 // Default to 8, but dynamically overriden in compute pipeline
 override WORKGROUP_SIZE: u32 = 8;
 
+var<workgroup> groupChangedCells: atomic<u32>;
+
+// Counts the cells a step changed into boardSummary, PeriodMonitor stops stepping (for free) once a generation
+// changes nothing. Like hashMain, the workgroup adds its count with one global atomic. Call from uniform control flow
+fn countChangedCell(changed: bool, local: u32) {
+  if (changed) {
+    atomicAdd(&groupChangedCells, 1u);
+  }
+  workgroupBarrier();
+  if (local == 0u) {
+    let count = atomicLoad(&groupChangedCells);
+    if (count != 0u) {
+      atomicAdd(&boardSummary.changedCells, count);
+    }
+  }
+}
+
 @compute
 @workgroup_size(WORKGROUP_SIZE, WORKGROUP_SIZE)
-fn computeMain(@builtin(global_invocation_id) cell: vec3u) {
-  // Count active neighbors
-  let activeNeighbors = cellActive(cell.x+1, cell.y+1) +
-                        cellActive(cell.x+1, cell.y) +
-                        cellActive(cell.x+1, cell.y-1) +
-                        cellActive(cell.x, cell.y-1) +
-                        cellActive(cell.x-1, cell.y-1) +
-                        cellActive(cell.x-1, cell.y) +
-                        cellActive(cell.x-1, cell.y+1) +
-                        cellActive(cell.x, cell.y+1);
+fn computeMain(@builtin(global_invocation_id) cell: vec3u, @builtin(local_invocation_index) local: u32) {
+  // Count active neighbors, the halo (filled by haloMain for the current topology) means no wrapping here
+  let i = storageIndex(vec2i(cell.xy));
+  let row = u32(grid.x) + 2;
+  let activeNeighbors = cellStateIn[i - row - 1] + cellStateIn[i - row] + cellStateIn[i - row + 1] +
+                        cellStateIn[i - 1] + cellStateIn[i + 1] +
+                        cellStateIn[i + row - 1] + cellStateIn[i + row] + cellStateIn[i + row + 1];
   // Apply Conway's Game of Life rules
-  let i = cellIndex(cell.xy);
+  var next = 0u; // Cells with < 2 or > 3 neighbors become inactive.
   switch activeNeighbors {
     case 2: { // Active cells with 2 neighbors stay active.
-      cellStateOut[i] = cellStateIn[i];
+      next = cellStateIn[i];
     }
     case 3: { // Cells with 3 neighbors become or stay active.
-      cellStateOut[i] = 1;
+      next = 1u;
     }
-    default: { // Cells with < 2 or > 3 neighbors become inactive.
-      cellStateOut[i] = 0;
+    default: {}
+  }
+  cellStateOut[i] = next;
+  countChangedCell(next != cellStateIn[i], local);
+}
+
+// Fills cellStateOut with a random board (Life::seed), each cell only depends on (seed, cell index)
+@compute
+@workgroup_size(WORKGROUP_SIZE, WORKGROUP_SIZE)
+fn seedMain(@builtin(global_invocation_id) cell: vec3u) {
+  if (cell.x >= u32(grid.x) || cell.y >= u32(grid.y)) {
+    return;
+  }
+  let i = cell.y * u32(grid.x) + cell.x;
+  cellStateOut[storageIndex(vec2i(cell.xy))] = select(0u, 1u, cellRandom(seedParams.key, i) < seedParams.threshold);
+}
+
+// Writes the pending pointer edits into cellStateOut (the current generation), one invocation per edited cell.
+// Only the edited cells are touched, so editing costs the same on any board size
+@compute
+@workgroup_size(WORKGROUP_SIZE * WORKGROUP_SIZE)
+fn editMain(@builtin(global_invocation_id) id: vec3u) {
+  if (id.x >= cellEdits.count) {
+    return;
+  }
+  let edit = cellEdits.cells[id.x];
+  cellStateOut[edit >> 1] = select(edit & 1u, bitcast<u32>(f32(edit & 1u)), CONTINUOUS);
+}
+
+// Packs the board of cellStateIn into packedBoard, one invocation per 32-cell word (grid.x is a multiple of 32)
+@compute
+@workgroup_size(WORKGROUP_SIZE * WORKGROUP_SIZE)
+fn packMain(@builtin(global_invocation_id) id: vec3u) {
+  let wordsPerRow = u32(grid.x) / 32u;
+  if (id.x >= wordsPerRow * u32(grid.y)) {
+    return;
+  }
+  let y = i32(id.x / wordsPerRow);
+  let x = i32(id.x % wordsPerRow * 32u);
+  var word = 0u;
+  for (var bit = 0; bit < 32; bit++) {
+    word |= (cellStateIn[storageIndex(vec2i(x + bit, y))] & 1u) << u32(bit);
+  }
+  packedBoard[id.x] = word;
+}
+
+// Writes the board of packedBoard into cellStateOut (Life::seekGeneration), its halo is filled afterwards
+@compute
+@workgroup_size(WORKGROUP_SIZE, WORKGROUP_SIZE)
+fn unpackMain(@builtin(global_invocation_id) cell: vec3u) {
+  if (cell.x >= u32(grid.x) || cell.y >= u32(grid.y)) {
+    return;
+  }
+  let i = cell.y * u32(grid.x) + cell.x;
+  cellStateOut[storageIndex(vec2i(cell.xy))] = (packedBoard[i / 32u] >> (i % 32u)) & 1u;
+}
+
+// How the board edges are glued (Topology::Kind): 0 torus, 1 plane, 2 Klein bottle, 3 cross-surface, 4 sphere
+override TOPOLOGY: u32 = 0;
+
+// Board cell that halo cell (x, y) copies, or (-1, -1) when it is dead. Mirrors Topology::haloSource
+fn haloSource(cell: vec2i) -> vec2i {
+  let size = vec2i(grid);
+  let outside = (cell < vec2i(0)) | (cell >= size);
+  let wrapped = (cell + size) % size;
+  let mirrored = size - 1 - wrapped;
+  switch TOPOLOGY {
+    case 1u: { // Plane
+      return vec2i(-1);
+    }
+    case 2u: { // Klein bottle
+      return vec2i(select(wrapped.x, mirrored.x, outside.y), wrapped.y);
+    }
+    case 3u: { // Cross-surface, corners wrap like a torus
+      if (all(outside)) {
+        return wrapped;
+      }
+      return select(wrapped, mirrored, outside.yx);
+    }
+    case 4u: { // Sphere (square boards), corners are dead
+      if (all(outside)) {
+        return vec2i(-1);
+      }
+      if (cell.y < 0) {
+        return vec2i(0, cell.x);
+      }
+      if (cell.y >= size.y) {
+        return vec2i(size.x - 1, cell.x);
+      }
+      if (cell.x < 0) {
+        return vec2i(cell.y, 0);
+      }
+      return vec2i(cell.y, size.y - 1);
+    }
+    default: { // Torus
+      return wrapped;
+    }
+  }
+}
+
+// Fills the halo of cellStateOut from its board, after every pass that writes a generation (computeMain, seedMain).
+// One invocation per halo cell: the top and bottom rows (corners included), then the left and right columns.
+// The modulo and branches of the topology are paid by these 4 * (size + 1) cells instead of every neighbour read
+@compute
+@workgroup_size(WORKGROUP_SIZE * WORKGROUP_SIZE)
+fn haloMain(@builtin(global_invocation_id) id: vec3u) {
+  let size = vec2i(grid);
+  let i = i32(id.x);
+  let rowCells = size.x + 2;
+  var cell: vec2i;
+  if (i < rowCells) {
+    cell = vec2i(i - 1, -1);
+  } else if (i < 2 * rowCells) {
+    cell = vec2i(i - rowCells - 1, size.y);
+  } else if (i < 2 * rowCells + size.y) {
+    cell = vec2i(-1, i - 2 * rowCells);
+  } else if (i < 2 * rowCells + 2 * size.y) {
+    cell = vec2i(size.x, i - 2 * rowCells - size.y);
+  } else {
+    return;
+  }
+  let source = haloSource(cell);
+  var state = 0u;
+  if (source.x >= 0) {
+    state = cellStateOut[storageIndex(source)];
+  }
+  cellStateOut[storageIndex(cell)] = state;
+}
+
+// Zobrist keys for hashMain: two independent cellRandom streams give each cell a 64-bit key without a table
+const HASH_KEYS = vec4u(0x2545f491u, 0x9e3779b9u, 0x85ebca6bu, 0xc2b2ae35u);
+var<workgroup> groupHash: array<atomic<u32>, 2>;
+
+// XORs the key of every live cell of cellStateIn into boardSummary.hash (cleared beforehand by PeriodMonitor).
+// Equal boards give equal hashes, Life stops stepping once a hash repeats. Other states than 1 (continuous cells)
+// salt the key with their bits, mix32(0) is 0 so binary boards hash as they always did
+@compute
+@workgroup_size(WORKGROUP_SIZE, WORKGROUP_SIZE)
+fn hashMain(@builtin(global_invocation_id) cell: vec3u, @builtin(local_invocation_index) local: u32) {
+  if (cell.x < u32(grid.x) && cell.y < u32(grid.y)) {
+    let i = cell.y * u32(grid.x) + cell.x;
+    let state = cellStateIn[storageIndex(vec2i(cell.xy))];
+    if (state != 0u) {
+      let salt = mix32(state ^ 1u);
+      atomicXor(&groupHash[0], cellRandom(HASH_KEYS.xy, i) ^ salt);
+      atomicXor(&groupHash[1], cellRandom(HASH_KEYS.zw, i) ^ mix32(salt));
+    }
+  }
+  // Fold the workgroup into one pair of global atomics instead of one per live cell
+  workgroupBarrier();
+  if (local == 0u) {
+    atomicXor(&boardSummary.hash[0], atomicLoad(&groupHash[0]));
+    atomicXor(&boardSummary.hash[1], atomicLoad(&groupHash[1]));
+  }
+}
+
+// ======================================================
+// Larger than Life (LtlRule)
+// ======================================================
+// A cell counts the live cells of the (2 * LTL_RADIUS + 1)^2 square around it (itself too with LTL_INCLUDE_CENTER).
+// Reading the square would cost (2R + 1)^2 loads per cell, so each step first builds a summed-area table of the board
+// extended by LTL_RADIUS on every side: ltlRowsMain sums along the rows and ltlColumnsMain down the columns, one
+// invocation per line. ltlMain then reads each count from four corners, and the cost stays flat as R grows.
+// The rule is baked in as override constants (Life::requestLtlPipelines), like the topology of haloMain.
+// Torus (wrapped) and plane (dead outside) only, TOPOLOGY is 0 or 1
+override LTL_RADIUS: u32 = 1;
+override LTL_INCLUDE_CENTER: bool = false;
+override LTL_BIRTH_MIN: u32 = 3;
+override LTL_BIRTH_MAX: u32 = 3;
+override LTL_SURVIVE_MIN: u32 = 2;
+override LTL_SURVIVE_MAX: u32 = 3;
+
+// The table has (grid + 2R + 1) entries per side: row and column 0 are zero, entry (x + 1, y + 1) sums the extended
+// board up to and including (x, y), where extended (x, y) is board cell (x - R, y - R)
+fn ltlTableWidth() -> u32 {
+  return u32(grid.x) + 2u * LTL_RADIUS + 1u;
+}
+
+fn ltlTableIndex(x: u32, y: u32) -> u32 {
+  return y * ltlTableWidth() + x;
+}
+
+// State of extended cell (x, y) of cellStateIn
+fn ltlCell(x: u32, y: u32) -> u32 {
+  let size = vec2i(grid);
+  let cell = vec2i(i32(x), i32(y)) - i32(LTL_RADIUS);
+  let outside = any(cell < vec2i(0)) || any(cell >= size);
+  if (outside && TOPOLOGY == 1u) {
+    return 0u;
+  }
+  return cellStateIn[storageIndex((cell % size + size) % size)];
+}
+
+@compute
+@workgroup_size(WORKGROUP_SIZE * WORKGROUP_SIZE)
+fn ltlRowsMain(@builtin(global_invocation_id) id: vec3u) {
+  let width = ltlTableWidth();
+  if (id.x >= u32(grid.y) + 2u * LTL_RADIUS) {
+    return;
+  }
+  // The first invocation also clears row 0, the radius (and so the layout) may have changed since the last step
+  if (id.x == 0u) {
+    for (var x = 0u; x < width; x++) {
+      ltlTable[x] = 0u;
     }
   }
-}
\ No newline at end of file
+  var sum = 0u;
+  ltlTable[ltlTableIndex(0u, id.x + 1u)] = 0u;
+  for (var x = 0u; x + 1u < width; x++) {
+    sum += ltlCell(x, id.x);
+    ltlTable[ltlTableIndex(x + 1u, id.x + 1u)] = sum;
+  }
+}
+
+@compute
+@workgroup_size(WORKGROUP_SIZE * WORKGROUP_SIZE)
+fn ltlColumnsMain(@builtin(global_invocation_id) id: vec3u) {
+  let width = ltlTableWidth();
+  if (id.x == 0u || id.x >= width) {
+    return;
+  }
+  var sum = 0u;
+  for (var y = 1u; y < u32(grid.y) + 2u * LTL_RADIUS + 1u; y++) {
+    sum += ltlTable[ltlTableIndex(id.x, y)];
+    ltlTable[ltlTableIndex(id.x, y)] = sum;
+  }
+}
+
+@compute
+@workgroup_size(WORKGROUP_SIZE, WORKGROUP_SIZE)
+fn ltlMain(@builtin(global_invocation_id) cell: vec3u, @builtin(local_invocation_index) local: u32) {
+  // The square of cell (x, y) is extended [x, x + 2R] x [y, y + 2R]
+  let side = 2u * LTL_RADIUS + 1u;
+  let x = cell.x;
+  let y = cell.y;
+  var count = ltlTable[ltlTableIndex(x + side, y + side)] + ltlTable[ltlTableIndex(x, y)] -
+              ltlTable[ltlTableIndex(x + side, y)] - ltlTable[ltlTableIndex(x, y + side)];
+  let i = storageIndex(vec2i(cell.xy));
+  let state = cellStateIn[i];
+  if (!LTL_INCLUDE_CENTER) {
+    count -= state;
+  }
+  var next = 0u;
+  if (state != 0u) {
+    next = select(0u, 1u, count >= LTL_SURVIVE_MIN && count <= LTL_SURVIVE_MAX);
+  } else {
+    next = select(0u, 1u, count >= LTL_BIRTH_MIN && count <= LTL_BIRTH_MAX);
+  }
+  cellStateOut[i] = next;
+  countChangedCell(next != state, local);
+}
+
+// ======================================================
+// Lenia (LeniaRule)
+// ======================================================
+// Continuous states: a cell's potential is the leniaKernel-weighted sum of the (2 * LENIA_RADIUS + 1)^2 square
+// around it, and its state moves by growth(potential) / LENIA_TICKS. Every cell would read up to 129^2 neighbours
+// from storage, so each 16x16 workgroup instead walks its footprint (the tile grown by the radius on every side) in
+// 16x16 blocks: the workgroup loads a block into workgroup memory with one read per invocation, and every
+// invocation adds the part of the block within its own square. Torus (wrapped) and plane (dead outside) only
+override LENIA_RADIUS: u32 = 13;
+override LENIA_MU: f32 = 0.15;
+override LENIA_SIGMA: f32 = 0.015;
+override LENIA_TICKS: f32 = 10.0;
+const LENIA_TILE = 16;
+var<workgroup> leniaBlock: array<f32, 256>;
+
+@compute
+@workgroup_size(LENIA_TILE, LENIA_TILE)
+fn leniaMain(@builtin(workgroup_id) group: vec3u, @builtin(local_invocation_id) local: vec3u,
+             @builtin(local_invocation_index) localIndex: u32) {
+  let size = vec2i(grid);
+  let radius = i32(LENIA_RADIUS);
+  let side = 2 * radius + 1;
+  let origin = vec2i(group.xy) * LENIA_TILE;
+  let cell = origin + vec2i(local.xy);
+  let blocks = (LENIA_TILE + 2 * radius + LENIA_TILE - 1) / LENIA_TILE;
+  var potential = 0.0;
+  for (var by = 0; by < blocks; by++) {
+    for (var bx = 0; bx < blocks; bx++) {
+      let blockOrigin = origin - radius + vec2i(bx, by) * LENIA_TILE;
+      let source = blockOrigin + vec2i(local.xy);
+      let outside = any(source < vec2i(0)) || any(source >= size);
+      var state = 0.0;
+      if (!outside || TOPOLOGY != 1u) {
+        state = bitcast<f32>(cellStateIn[storageIndex((source % size + size) % size)]);
+      }
+      // The previous block is done with before it is overwritten
+      workgroupBarrier();
+      leniaBlock[localIndex] = state;
+      workgroupBarrier();
+      // This cell's square within the block
+      let low = max(cell - radius - blockOrigin, vec2i(0));
+      let high = min(cell + radius - blockOrigin, vec2i(LENIA_TILE - 1));
+      for (var y = low.y; y <= high.y; y++) {
+        let kernelRow = (blockOrigin.y + y - cell.y + radius) * side + radius + blockOrigin.x - cell.x;
+        for (var x = low.x; x <= high.x; x++) {
+          potential += leniaBlock[y * LENIA_TILE + x] * leniaKernel[kernelRow + x];
+        }
+      }
+    }
+  }
+
+  let i = storageIndex(cell);
+  let state = bitcast<f32>(cellStateIn[i]);
+  let distance = (potential - LENIA_MU) / LENIA_SIGMA;
+  let growth = 2.0 * exp(-0.5 * distance * distance) - 1.0;
+  let next = clamp(state + growth / LENIA_TICKS, 0.0, 1.0);
+  cellStateOut[i] = bitcast<u32>(next);
+  countChangedCell(next != state, localIndex);
+}
+
+// ======================================================
+// Hexagonal and triangular lattices (LatticeRule)
+// ======================================================
+// Both lattices are stored like the square one, so seeding, the halo, hashing, edits and history are shared and only
+// the neighbour reads differ. Each has its own pass with fixed offsets from the cell, not a neighbour list. The rule
+// is baked in as bit masks (Life::requestLatticePipeline): bit n set means n live neighbours give birth or survive
+override LATTICE_BIRTH: u32 = 4u;
+override LATTICE_SURVIVE: u32 = 24u;
+
+fn latticeNext(state: u32, count: u32) -> u32 {
+  return (select(LATTICE_BIRTH, LATTICE_SURVIVE, state != 0u) >> count) & 1u;
+}
+
+// Six neighbours: (x - 1, y), (x + 1, y) and two cells in each row around. Odd rows sit half a cell to the right, so
+// those are x - 1 and x for even rows and x and x + 1 for odd ones, the square kernel's reads shifted by the parity
+@compute
+@workgroup_size(WORKGROUP_SIZE, WORKGROUP_SIZE)
+fn hexMain(@builtin(global_invocation_id) cell: vec3u, @builtin(local_invocation_index) local: u32) {
+  let i = storageIndex(vec2i(cell.xy));
+  let row = u32(grid.x) + 2;
+  let shift = cell.y & 1u;
+  let below = i - row + shift;
+  let above = i + row + shift;
+  let count = cellStateIn[i - 1] + cellStateIn[i + 1] +
+              cellStateIn[below - 1] + cellStateIn[below] +
+              cellStateIn[above - 1] + cellStateIn[above];
+  let state = cellStateIn[i];
+  let next = latticeNext(state, count);
+  cellStateOut[i] = next;
+  countChangedCell(next != state, local);
+}
+
+// Cell (x, y) for the triangle's reads two columns across, past the one-cell halo: wrapped on the torus, dead off
+// the plane. y may be a halo row. Always one read, so a row costs the same at the edges
+fn triangleOuter(x: i32, y: i32) -> u32 {
+  let width = i32(grid.x);
+  let wrapped = (x + width) % width;
+  let dead = TOPOLOGY == 1u && wrapped != x;
+  return select(cellStateIn[storageIndex(vec2i(wrapped, y))], 0u, dead);
+}
+
+// Twelve neighbours: x - 2 .. x + 2 in the cell's own row and in the row across its flat side, x - 1 .. x + 1 in the
+// row across its tip. Cells point up where x + y is even, with the flat side on the row below (y = 0 is the bottom
+// row), so every cell reads the three cells around it in both rows plus the two outer ones of its flat side's row
+@compute
+@workgroup_size(WORKGROUP_SIZE, WORKGROUP_SIZE)
+fn triangleMain(@builtin(global_invocation_id) cell: vec3u, @builtin(local_invocation_index) local: u32) {
+  let i = storageIndex(vec2i(cell.xy));
+  let row = u32(grid.x) + 2;
+  let below = i - row;
+  let above = i + row;
+  let x = i32(cell.x);
+  let y = i32(cell.y);
+  let flatRow = select(y + 1, y - 1, ((cell.x + cell.y) & 1u) == 0u);
+  let count = triangleOuter(x - 2, y) + cellStateIn[i - 1] + cellStateIn[i + 1] + triangleOuter(x + 2, y) +
+              cellStateIn[below - 1] + cellStateIn[below] + cellStateIn[below + 1] +
+              cellStateIn[above - 1] + cellStateIn[above] + cellStateIn[above + 1] +
+              triangleOuter(x - 2, flatRow) + triangleOuter(x + 2, flatRow);
+  let state = cellStateIn[i];
+  let next = latticeNext(state, count);
+  cellStateOut[i] = next;
+  countChangedCell(next != state, local);
+}
+
+// ======================================================
+// 3D Life (VoxelRule)
+// ======================================================
+// A grid.x^3 torus in cellStateIn and cellStateOut as VoxelVolume bricks: brick (bx, by, bz) of 4x4x4 cells is the
+// two words at 2 * ((bz * bricks + by) * bricks + bx), z 0-1 then z 2-3, and bit x + 4y + 16(z % 2) of a word is cell
+// (x, y, z) of the brick. A word is two 4x4 layers of cells, and every cell of it is stepped at once with bit-sliced
+// adders like VoxelEngine's: the three cells along x are summed into 2-bit planes, three of those along y into 4-bit
+// planes and three of those along z into the 5-bit total of the 3x3x3 block. The rule is baked in as neighbour count
+// masks (Life::requestVoxelPipelines): bit n set means n live neighbours keep a cell or give birth
+override VOXEL_SURVIVE: u32 = 48u;
+override VOXEL_BIRTH: u32 = 32u;
+const VOXEL_WORKGROUP = 4;
+// Levels of voxelOccupancy (Life::VOXEL_MIP_LEVELS) and the level voxelMipMain builds
+const VOXEL_MIP_LEVELS = 5u;
+override VOXEL_MIP_LEVEL: u32 = 2u;
+
+// Word bits with x = 0, x = 3, y = 0 and y = 3 (VoxelVolume::X0 and so on, one 32-bit half)
+const VOXEL_X0 = 0x11111111u;
+const VOXEL_X3 = 0x88888888u;
+const VOXEL_Y0 = 0x000f000fu;
+const VOXEL_Y3 = 0xf000f000u;
+
+// Every bit of the result is the cell one step west (x - 1), east, south (y - 1) or north of the same bit in center,
+// taken from the word of the neighbouring brick on that side at the brick's face
+fn voxelFromWest(center: u32, west: u32) -> u32 {
+  return ((center << 1u) & ~VOXEL_X0) | ((west >> 3u) & VOXEL_X0);
+}
+fn voxelFromEast(center: u32, east: u32) -> u32 {
+  return ((center >> 1u) & ~VOXEL_X3) | ((east << 3u) & VOXEL_X3);
+}
+fn voxelFromSouth(center: u32, south: u32) -> u32 {
+  return ((center << 4u) & ~VOXEL_Y0) | ((south >> 12u) & VOXEL_Y0);
+}
+fn voxelFromNorth(center: u32, north: u32) -> u32 {
+  return ((center >> 4u) & ~VOXEL_Y3) | ((north << 12u) & VOXEL_Y3);
+}
+
+// Sum of three one-bit words as (ones, twos)
+fn voxelAdd3(a: u32, b: u32, c: u32) -> vec2u {
+  let ab = a ^ b;
+  return vec2u(ab ^ c, (a & b) | (c & ab));
+}
+
+fn voxelBrickIndex(brick: vec3u) -> u32 {
+  let bricks = u32(grid.x) / 4u;
+  return (brick.z * bricks + brick.y) * bricks + brick.x;
+}
+
+// 4-bit planes of the 3x3 square sums in the x-y plane of word half (0 for z 0-1, 1 for z 2-3) of brick, wrapped
+fn voxelSumXY(brick: vec3u, half: u32) -> vec4u {
+  let bricks = u32(grid.x) / 4u;
+  let west = (brick.x + bricks - 1u) % bricks;
+  let east = (brick.x + 1u) % bricks;
+  var ones: array<u32, 3>;
+  var twos: array<u32, 3>;
+  for (var dy = 0u; dy < 3u; dy++) {
+    let y = (brick.y + bricks + dy - 1u) % bricks;
+    let center = cellStateIn[2u * voxelBrickIndex(vec3u(brick.x, y, brick.z)) + half];
+    let sum = voxelAdd3(voxelFromWest(center, cellStateIn[2u * voxelBrickIndex(vec3u(west, y, brick.z)) + half]),
+                        center,
+                        voxelFromEast(center, cellStateIn[2u * voxelBrickIndex(vec3u(east, y, brick.z)) + half]));
+    ones[dy] = sum.x;
+    twos[dy] = sum.y;
+  }
+  // Three 2-bit row sums along y
+  let low = voxelAdd3(voxelFromSouth(ones[1], ones[0]), ones[1], voxelFromNorth(ones[1], ones[2]));
+  let high = voxelAdd3(voxelFromSouth(twos[1], twos[0]), twos[1], voxelFromNorth(twos[1], twos[2]));
+  let carry4 = high.x & low.y;
+  return vec4u(low.x, high.x ^ low.y, high.y ^ carry4, high.y & carry4);
+}
+
+// 5-bit totals of the 3x3x3 blocks of a word from the x-y sums of the word below it, its own and the one above. A
+// word's two layers take the cells across z from each other and from the 16 bits of the neighbouring words nearest
+fn voxelSumZ(below: vec4u, center: vec4u, above: vec4u) -> array<u32, 5> {
+  let a = (center << vec4u(16u)) | (below >> vec4u(16u));
+  let c = (center >> vec4u(16u)) | (above << vec4u(16u));
+  let bit0 = voxelAdd3(a.x, center.x, c.x);
+  let bit1 = voxelAdd3(a.y, center.y, c.y);
+  let carry4 = bit1.x & bit0.y;
+  let bit2 = voxelAdd3(a.z, center.z, c.z);
+  let total2 = voxelAdd3(bit2.x, bit1.y, carry4);
+  let bit3 = voxelAdd3(a.w, center.w, c.w);
+  let total3 = voxelAdd3(bit3.x, bit2.y, total2.y);
+  // Totals stop at 27, there is no bit 5
+  return array<u32, 5>(bit0.x, bit1.x ^ bit0.y, total2.x, total3.x, bit3.y ^ total3.y);
+}
+
+// Next state of every cell of center from its 3x3x3 totals. They count the cell too, so a live cell survives with a
+// total one above its neighbour count
+fn voxelNext(center: u32, totals: array<u32, 5>) -> u32 {
+  var planes = totals;
+  let keeps = VOXEL_SURVIVE << 1u;
+  var next = 0u;
+  for (var value = 1u; value < 28u; value++) {
+    let keep = ((keeps >> value) & 1u) != 0u;
+    let birth = ((VOXEL_BIRTH >> value) & 1u) != 0u;
+    if (!keep && !birth) {
+      continue;
+    }
+    var matches = 0xffffffffu;
+    for (var bit = 0u; bit < 5u; bit++) {
+      matches &= select(~planes[bit], planes[bit], ((value >> bit) & 1u) != 0u);
+    }
+    next |= matches & (select(0u, center, keep) | select(0u, ~center, birth));
+  }
+  return next;
+}
+
+// One invocation per brick: four word layers of x-y sums (the top word of the brick below, the brick's two, the
+// bottom word of the brick above) give both words' totals. Bricks with nothing live around stay empty without the
+// adders, births need a live neighbour. Also flags the brick in mip level 1 for voxelMipMain and the raymarcher
+@compute
+@workgroup_size(VOXEL_WORKGROUP, VOXEL_WORKGROUP, VOXEL_WORKGROUP)
+fn voxelMain(@builtin(global_invocation_id) brick: vec3u, @builtin(local_invocation_index) local: u32) {
+  let bricks = u32(grid.x) / 4u;
+  let sum0 = voxelSumXY(vec3u(brick.xy, (brick.z + bricks - 1u) % bricks), 1u);
+  let sum1 = voxelSumXY(brick, 0u);
+  let sum2 = voxelSumXY(brick, 1u);
+  let sum3 = voxelSumXY(vec3u(brick.xy, (brick.z + 1u) % bricks), 0u);
+  let index = voxelBrickIndex(brick);
+  let low = cellStateIn[2u * index];
+  let high = cellStateIn[2u * index + 1u];
+  var nextLow = 0u;
+  var nextHigh = 0u;
+  if (any((sum0 | sum1 | sum2 | sum3) != vec4u(0u))) {
+    nextLow = voxelNext(low, voxelSumZ(sum0, sum1, sum2));
+    nextHigh = voxelNext(high, voxelSumZ(sum1, sum2, sum3));
+  }
+  cellStateOut[2u * index] = nextLow;
+  cellStateOut[2u * index + 1u] = nextHigh;
+  voxelOccupancy[index] = select(0u, 1u, (nextLow | nextHigh) != 0u);
+  countChangedCell(nextLow != low || nextHigh != high, local);
+}
+
+// Flag of mip cell (level >= 1) in voxelOccupancy: the levels one after the other, each x fastest like the bricks
+fn voxelOccupancyIndex(level: u32, cell: vec3u) -> u32 {
+  var offset = 0u;
+  var side = u32(grid.x) / 4u;
+  for (var below = 1u; below < level; below++) {
+    offset += side * side * side;
+    side /= 2u;
+  }
+  return offset + (cell.z * side + cell.y) * side + cell.x;
+}
+
+// Level VOXEL_MIP_LEVEL of voxelOccupancy from the level below, one invocation per cell. Dispatched level by level
+// after voxelMain in the same pass, which orders them
+@compute
+@workgroup_size(VOXEL_WORKGROUP, VOXEL_WORKGROUP, VOXEL_WORKGROUP)
+fn voxelMipMain(@builtin(global_invocation_id) cell: vec3u) {
+  let side = u32(grid.x) >> (VOXEL_MIP_LEVEL + 1u);
+  if (any(cell >= vec3u(side))) {
+    return;
+  }
+  var occupied = 0u;
+  for (var child = 0u; child < 8u; child++) {
+    let offset = vec3u(child & 1u, (child >> 1u) & 1u, child >> 2u);
+    occupied |= voxelOccupancy[voxelOccupancyIndex(VOXEL_MIP_LEVEL - 1u, cell * 2u + offset)];
+  }
+  voxelOccupancy[voxelOccupancyIndex(VOXEL_MIP_LEVEL, cell)] = occupied;
+}
+
+// hashMain for volumes: every non-empty word of cellStateIn salts the keys of its index with its bits
+@compute
+@workgroup_size(VOXEL_WORKGROUP, VOXEL_WORKGROUP, VOXEL_WORKGROUP)
+fn voxelHashMain(@builtin(global_invocation_id) brick: vec3u, @builtin(local_invocation_index) local: u32) {
+  let index = voxelBrickIndex(brick);
+  for (var half = 0u; half < 2u; half++) {
+    let i = 2u * index + half;
+    let word = cellStateIn[i];
+    if (word != 0u) {
+      atomicXor(&groupHash[0], mix32(word ^ cellRandom(HASH_KEYS.xy, i)));
+      atomicXor(&groupHash[1], mix32(word ^ cellRandom(HASH_KEYS.zw, i)));
+    }
+  }
+  workgroupBarrier();
+  if (local == 0u) {
+    atomicXor(&boardSummary.hash[0], atomicLoad(&groupHash[0]));
+    atomicXor(&boardSummary.hash[1], atomicLoad(&groupHash[1]));
+  }
+}
+
+// ======================================================
+// 3D Life raymarcher
+// ======================================================
+// One triangle covers the target and every pixel walks its ray through the volume. Rays start at the top of the
+// occupancy mip: an empty mip cell is left in one step to its exit face, and the next cell is tried a level up; an
+// occupied one is looked into a level down, down to the cells themselves (level 0). Empty space of any size costs a
+// step or two per block, a soup in the middle of the volume is reached from outside in a handful
+const VOXEL_MAX_STEPS = 512u;
+// Rays move this far past a face, so the next lookup is in the next cell
+const VOXEL_EPSILON = 1e-3;
+
+struct VoxelVertexOutput {
+  @builtin(position) pos: vec4f,
+  @location(0) ndc: vec2f,
+};
+
+@vertex
+fn voxelVertexMain(@builtin(vertex_index) index: u32) -> VoxelVertexOutput {
+  let ndc = vec2f(f32(index & 1u) * 4.0 - 1.0, f32(index >> 1u) * 4.0 - 1.0);
+  var output: VoxelVertexOutput;
+  output.pos = vec4f(ndc, 0, 1);
+  output.ndc = ndc;
+  return output;
+}
+
+// Side of the mip cells of level in cells: 1 for the cells, 4 for the bricks, then doubling
+fn voxelCellSide(level: u32) -> f32 {
+  return select(f32(2u << level), 1.0, level == 0u);
+}
+
+fn voxelOccupied(level: u32, cell: vec3u) -> bool {
+  if (level == 0u) {
+    let word = cellStateIn[2u * voxelBrickIndex(cell >> vec3u(2u)) + ((cell.z >> 1u) & 1u)];
+    return ((word >> ((cell.x & 3u) + 4u * (cell.y & 3u) + 16u * (cell.z & 1u))) & 1u) != 0u;
+  }
+  return voxelOccupancy[voxelOccupancyIndex(level, cell)] != 0u;
+}
+
+@fragment
+fn voxelFragmentMain(input: VoxelVertexOutput) -> @location(0) vec4f {
+  let size = grid.x;
+  let origin = voxelCamera.eye.xyz;
+  let ray = normalize(voxelCamera.forward.xyz + input.ndc.x * voxelCamera.right.xyz + input.ndc.y * voxelCamera.up.xyz);
+  // Axis-parallel rays get a tiny slope, so every face has a finite distance of the right sign
+  let direction = select(ray, vec3f(1e-6), ray == vec3f(0.0));
+  let inverse = 1.0 / direction;
+
+  // Into the volume's box, or past it
+  let near = min(-origin * inverse, (vec3f(size) - origin) * inverse);
+  let far = max(-origin * inverse, (vec3f(size) - origin) * inverse);
+  var t = max(max(near.x, near.y), max(near.z, 0.0));
+  let exit = min(min(far.x, far.y), far.z);
+  // Face the ray last crossed, 0 to 2 for x to z
+  var axis = select(select(2u, 1u, near.y == t), 0u, near.x == t);
+
+  var level = VOXEL_MIP_LEVELS;
+  var hit = false;
+  for (var i = 0u; i < VOXEL_MAX_STEPS && t < exit; i++) {
+    let side = voxelCellSide(level);
+    let position = clamp(origin + direction * t, vec3f(0.0), vec3f(size - VOXEL_EPSILON));
+    let cell = vec3u(position / side);
+    if (voxelOccupied(level, cell)) {
+      if (level == 0u) {
+        hit = true;
+        break;
+      }
+      level--;
+      continue;
+    }
+    let low = vec3f(cell) * side;
+    let faces = (select(low, low + side, direction > vec3f(0.0)) - origin) * inverse;
+    let next = min(min(faces.x, faces.y), faces.z);
+    axis = select(select(2u, 1u, faces.y == next), 0u, faces.x == next);
+    t = max(next, t) + VOXEL_EPSILON;
+    level = min(level + 1u, VOXEL_MIP_LEVELS);
+  }
+  if (!hit) {
+    discard;
+  }
+
+  // The board's gradient over the volume, faces shaded by their axis
+  let c = clamp(origin + direction * t, vec3f(0.0), vec3f(size)) / size;
+  let shade = select(select(1.0, 0.85, axis == 1u), 0.7, axis == 0u);
+  return vec4f(vec3f(c.x, c.y, 1 - c.x) * shade, 1);
+}
@@ -0,0 +1,328 @@
+// life_bench: runs every headless engine over a fixed corpus of boards and reports throughput.
+// Results are printed as a table and optionally written as JSON (stable key order, no timestamps)
+// so runs can be diffed for regressions. With --verify every final board is checked against the scalar engine,
+// which is how the Node.js (wasm) builds are tested for correctness.
+#include "Engine.h"
+#include "Pattern.h"
+#include "Trace.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+struct Options {
+    std::vector<std::string> engines;
+    std::vector<std::string> boards = {"soup", "r-pentomino", "acorn", "gosper-gun", "switch-engine", "empty"};
+    std::vector<uint32_t> sizes = {256, 1024, 4096};
+    std::vector<unsigned> threads;
+    uint32_t generations = 0;   // 0 picks a count per size, see generationsFor
+    uint64_t seed = 1;
+    double density = 0.5;
+    bool batch = false;
+    bool verify = false;
+    Topology::Kind topology = Topology::Kind::Torus;
+    std::string jsonPath;
+    std::string tracePath;
+};
+
+struct Result {
+    std::string engine;
+    unsigned threads = 1;
+    std::string board;
+    uint32_t size = 0;
+    uint32_t generations = 0;
+    double seconds = 0.0;
+    uint64_t peakRssBytes = 0;
+    uint64_t population = 0;
+    uint64_t checksum = 0;
+    // Whether the engine simulates the bounded board, see Engine::isBounded
+    bool bounded = true;
+};
+
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_bench [options]\n"
+        "  --engines a,b,...     engines to run (default: all)\n"
+        "  --boards a,b,...      soup, empty, or builtin pattern names (default: all)\n"
+        "  --sizes n,...         square board sizes (default: 256,1024,4096)\n"
+        "  --threads n,...       thread counts for the threaded engine (default: 1,2,4,hardware)\n"
+        "  --generations n       generations per case (default: scales with board size)\n"
+        "  --batch               step all generations in one call instead of one at a time\n"
+        "  --verify              check every final board against the scalar engine (exit code 1 on a mismatch)\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           soup density (default: 0.5)\n"
+        "  --topology name       torus, plane, klein, cross or sphere (default: torus)\n"
+        "  --json path           write results as JSON ('-' for stdout)\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--engines") options.engines = splitList(value());
+        else if (arg == "--boards") options.boards = splitList(value());
+        else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& size : splitList(value())) options.sizes.push_back(static_cast<uint32_t>(std::stoul(size)));
+        }
+        else if (arg == "--threads") {
+            options.threads.clear();
+            for (const auto& count : splitList(value())) options.threads.push_back(static_cast<unsigned>(std::stoul(count)));
+        }
+        else if (arg == "--generations") options.generations = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--batch") options.batch = true;
+        else if (arg == "--verify") options.verify = true;
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--topology") options.topology = Topology::parse(value());
+        else if (arg == "--json") options.jsonPath = value();
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+
+    if (options.engines.empty()) {
+        for (auto name : Engine::getEngineNames()) options.engines.emplace_back(name);
+    }
+    if (options.threads.empty()) {
+        const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned count : {1u, 2u, 4u, hardware}) {
+            if (count <= hardware && std::find(options.threads.begin(), options.threads.end(), count) == options.threads.end()) {
+                options.threads.push_back(count);
+            }
+        }
+    }
+    return options;
+}
+
+uint32_t generationsFor(const Options& options, uint32_t size)
+{
+    if (options.generations > 0) return options.generations;
+    // Roughly 2^26 cell updates per case, but never fewer than 8 generations
+    const uint64_t cells = static_cast<uint64_t>(size) * size;
+    return static_cast<uint32_t>(std::max<uint64_t>(8, (1ull << 26) / cells));
+}
+
+Grid makeBoard(const Options& options, const std::string& board, uint32_t size)
+{
+    Grid grid(size, size);
+    static ThreadPool fillPool;
+    if (board == "soup") grid.fillRandom(options.density, options.seed, fillPool);
+    else if (board != "empty") Pattern::getBuiltin(board).stampCentered(grid);
+    return grid;
+}
+
+// Linux keeps a resettable high-water mark (VmHWM), which lets every case report its own peak.
+// Elsewhere this falls back to the process-wide maximum from getrusage
+void resetPeakRss()
+{
+#if defined(__GLIBC__)
+    // Hand memory freed by the previous case back to the OS, otherwise it still counts as resident
+    malloc_trim(0);
+#endif
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs) clearRefs << "5";
+}
+
+uint64_t readPeakRss()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+Result runCase(const Options& options, const std::string& engineName, unsigned threads, const std::string& board, uint32_t size)
+{
+    Result result;
+    result.engine = engineName;
+    result.board = board;
+    result.size = size;
+    result.generations = generationsFor(options, size);
+
+    const Grid initial = makeBoard(options, board, size);
+    resetPeakRss();
+    auto engine = Engine::create(engineName, threads);
+    result.threads = engine->getThreadCount();
+    result.bounded = engine->isBounded();
+    if (options.topology != Topology::Kind::Torus) engine->setTopology(options.topology);
+    engine->load(initial);
+
+    const auto start = std::chrono::steady_clock::now();
+    if (options.batch) {
+        engine->step(result.generations);
+    } else {
+        for (uint32_t generation = 0; generation < result.generations; generation++) {
+            engine->step(1);
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.peakRssBytes = readPeakRss();
+
+    Grid final;
+    engine->store(final);
+    result.population = final.population();
+    result.checksum = final.checksum();
+    return result;
+}
+
+double cellUpdatesPerSecond(const Result& result)
+{
+    const double updates = static_cast<double>(result.size) * result.size * result.generations;
+    return result.seconds > 0.0 ? updates / result.seconds : 0.0;
+}
+
+double nsPerGeneration(const Result& result)
+{
+    return result.seconds * 1e9 / result.generations;
+}
+
+void printRow(const Result& result)
+{
+    std::cout << std::left << std::setw(10) << result.engine
+              << std::right << std::setw(4) << result.threads << "  "
+              << std::left << std::setw(15) << result.board
+              << std::right << std::setw(6) << result.size
+              << std::setw(7) << result.generations
+              << std::setw(14) << std::fixed << std::setprecision(0) << nsPerGeneration(result)
+              << std::setw(12) << std::setprecision(1) << cellUpdatesPerSecond(result) / 1e6
+              << std::setw(10) << result.peakRssBytes / (1024 * 1024)
+              << std::setw(10) << result.population << std::endl;
+}
+
+void writeJson(std::ostream& out, const Options& options, const std::vector<Result>& results)
+{
+    out << "{\n";
+    out << "  \"schema\": 1,\n";
+    out << "  \"config\": {\"seed\": " << options.seed
+        << ", \"density\": " << options.density
+        << ", \"batch\": " << (options.batch ? "true" : "false")
+        << ", \"topology\": \"" << Topology::getName(options.topology) << "\""
+        << ", \"hardwareThreads\": " << std::thread::hardware_concurrency() << "},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        out << "    {\"engine\": \"" << r.engine << "\""
+            << ", \"threads\": " << r.threads
+            << ", \"board\": \"" << r.board << "\""
+            << ", \"width\": " << r.size
+            << ", \"height\": " << r.size
+            << ", \"generations\": " << r.generations
+            << ", \"seconds\": " << std::setprecision(9) << std::defaultfloat << r.seconds
+            << ", \"nsPerGeneration\": " << std::fixed << std::setprecision(1) << nsPerGeneration(r)
+            << ", \"cellUpdatesPerSecond\": " << std::setprecision(0) << cellUpdatesPerSecond(r)
+            << ", \"peakRssBytes\": " << r.peakRssBytes
+            << ", \"population\": " << r.population
+            << ", \"checksum\": \"" << std::hex << std::setw(16) << std::setfill('0') << r.checksum
+            << std::dec << std::setfill(' ') << "\"}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+
+        std::cout << "engine    thr  board            size   gens       ns/gen   Mcells/s   rss(MB)       pop" << std::endl;
+        std::vector<Result> results;
+        uint32_t mismatches = 0;
+        for (uint32_t size : options.sizes) {
+            for (const auto& board : options.boards) {
+                // Scalar result of this case, run (unprinted) the first time a board needs checking
+                std::optional<Result> reference;
+                for (const auto& engine : options.engines) {
+                    const std::vector<unsigned> threadCounts = (engine == "threaded") ? options.threads : std::vector<unsigned>{1};
+                    for (unsigned threads : threadCounts) {
+                        try {
+                            results.push_back(runCase(options, engine, threads, board, size));
+                            const Result& result = results.back();
+                            printRow(result);
+                            if (!options.verify || !result.bounded) continue;
+                            if (engine == "scalar") reference = result;
+                            if (!reference) reference = runCase(options, "scalar", 1, board, size);
+                            if (result.population != reference->population || result.checksum != reference->checksum) {
+                                mismatches++;
+                                std::cout << "MISMATCH " << engine << " on " << board << " " << size << ": population "
+                                          << result.population << ", checksum " << std::hex << result.checksum
+                                          << " but scalar has " << std::dec << reference->population << ", "
+                                          << std::hex << reference->checksum << std::dec << std::endl;
+                            }
+                        } catch (const Engine::ConfigurationError& e) {
+                            std::cout << "skipped " << engine << " on " << board << " " << size << ": " << e.what() << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (options.jsonPath == "-") {
+            writeJson(std::cout, options, results);
+        } else if (!options.jsonPath.empty()) {
+            std::ofstream file(options.jsonPath);
+            if (!file) throw std::runtime_error("cannot write " + options.jsonPath);
+            writeJson(file, options, results);
+        }
+
+        if (!options.tracePath.empty()) {
+            if (!Trace::ENABLED) std::cerr << "Tracing is compiled out, rebuild with -DLIFE_ENABLE_TRACING=ON" << std::endl;
+            if (!Trace::save(options.tracePath)) throw std::runtime_error("cannot write " + options.tracePath);
+        }
+
+        if (options.verify) {
+            std::cout << (mismatches == 0 ? "verified: every board matches the scalar engine"
+                                          : std::to_string(mismatches) + " board(s) differ from the scalar engine")
+                      << std::endl;
+            if (mismatches > 0) return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+// life_capture: steps a board headlessly and streams every k-th generation out as rendered frames, either a PNG
+// sequence or raw RGB24 for a video encoder. Rendering and encoding run on a pool of writer threads behind a bounded
+// queue (FrameWriter), so stepping only waits when the writers cannot keep up
+#include "Engine.h"
+#include "FrameWriter.h"
+#include "LtlEngine.h"
+#include "Pattern.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+struct Options {
+    FrameWriter::Options writer;
+    std::string engine = "simd";
+    // Larger than Life rule, empty for Conway's Life on engine
+    std::string rule;
+    std::string board = "soup";
+    uint32_t size = 256;
+    uint64_t seed = 1;
+    double density = 0.5;
+    Topology::Kind topology = Topology::Kind::Torus;
+    uint64_t frames = 100;
+    uint32_t every = 1;
+    std::string tracePath;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_capture [options] (--png dir | --raw path | --pipe command)\n"
+        "  --png dir             write frame_000000.png, frame_000001.png, ... into dir\n"
+        "  --raw path            write raw RGB24 frames back to back ('-' for stdout)\n"
+        "  --pipe command        feed raw RGB24 frames to command's stdin, e.g.\n"
+        "                        'ffmpeg -f rawvideo -pix_fmt rgb24 -s 1024x1024 -r 60 -i - out.mp4'\n"
+        "  --frames n            frames to write (default: 100)\n"
+        "  --every k             generations stepped between frames (default: 1)\n"
+        "  --board name          soup, empty, a builtin pattern name or an .rle file (default: soup)\n"
+        "  --size n              square board size (default: 256)\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           soup density (default: 0.5)\n"
+        "  --topology name       torus, plane, klein, cross or sphere (default: torus)\n"
+        "  --engine name         engine stepping the board (default: simd)\n"
+        "  --rule rule           Larger than Life rule (Golly notation or a name like bosco), stepped by the ltl\n"
+        "                        engine\n"
+        "  --cell n              pixels per cell (default: 4)\n"
+        "  --threads n           encoder threads (default: hardware)\n"
+        "  --queue n             frames queued or encoding at most (default: 16)\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    bool hasOutput = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--png") {
+            options.writer.format = FrameWriter::Format::Png;
+            options.writer.path = value();
+            hasOutput = true;
+        }
+        else if (arg == "--raw") {
+            options.writer.format = FrameWriter::Format::Raw;
+            options.writer.path = value();
+            hasOutput = true;
+        }
+        else if (arg == "--pipe") {
+            options.writer.format = FrameWriter::Format::Raw;
+            options.writer.command = value();
+            hasOutput = true;
+        }
+        else if (arg == "--frames") options.frames = std::stoull(value());
+        else if (arg == "--every") options.every = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--board") options.board = value();
+        else if (arg == "--size") options.size = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--topology") options.topology = Topology::parse(value());
+        else if (arg == "--engine") options.engine = value();
+        else if (arg == "--rule") options.rule = value();
+        else if (arg == "--cell") options.writer.cellPixels = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--threads") options.writer.threads = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--queue") options.writer.queueCapacity = std::stoul(value());
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    if (!hasOutput) throw std::runtime_error("pick an output with --png, --raw or --pipe (see --help)");
+    return options;
+}
+
+Grid makeBoard(const Options& options)
+{
+    Grid grid(options.size, options.size);
+    if (options.board == "soup") {
+        ThreadPool fillPool;
+        grid.fillRandom(options.density, options.seed, fillPool);
+    } else if (options.board.ends_with(".rle")) {
+        std::ifstream file(options.board);
+        if (!file) throw std::runtime_error("cannot read " + options.board);
+        std::stringstream text;
+        text << file.rdbuf();
+        Pattern::fromRle(text.str(), options.board).stampCentered(grid);
+    } else if (options.board != "empty") {
+        Pattern::getBuiltin(options.board).stampCentered(grid);
+    }
+    return grid;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+        // A crashed encoder process should surface as a write error, not kill the run
+        if (!options.writer.command.empty()) std::signal(SIGPIPE, SIG_IGN);
+
+        std::unique_ptr<Engine> engine = options.rule.empty()
+            ? Engine::create(options.engine)
+            : std::make_unique<LtlEngine>(LtlRule::parse(options.rule));
+        engine->setTopology(options.topology);
+        engine->load(makeBoard(options));
+
+        FrameWriter writer {options.writer};
+        const uint32_t imageSize = options.size * options.writer.cellPixels;
+        std::cerr << options.frames << " frames of " << imageSize << "x" << imageSize << " on "
+                  << writer.getThreadCount() << " writer thread(s)" << std::endl;
+
+        const auto start = std::chrono::steady_clock::now();
+        double stepSeconds = 0.0;
+        for (uint64_t frame = 0; frame < options.frames; frame++) {
+            Grid board;
+            engine->store(board);
+            writer.submit(std::move(board));
+            if (frame + 1 < options.frames) {
+                const auto stepStart = std::chrono::steady_clock::now();
+                engine->step(options.every);
+                stepSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - stepStart).count();
+            }
+        }
+        const FrameWriter::Stats stats = writer.finish();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cerr << std::fixed << std::setprecision(2) << stats.frames << " frames, "
+                  << static_cast<double>(stats.bytes) / (1 << 20) << " MiB in " << seconds << " s ("
+                  << (seconds > 0.0 ? stats.frames / seconds : 0.0) << " frames/s). Stepping took "
+                  << stepSeconds << " s, waiting on the writers " << stats.waitSeconds << " s" << std::endl;
+
+        if (!options.tracePath.empty()) {
+            if (!Trace::ENABLED) std::cerr << "Tracing is compiled out, rebuild with -DLIFE_ENABLE_TRACING=ON" << std::endl;
+            if (!Trace::save(options.tracePath)) throw std::runtime_error("cannot write " + options.tracePath);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,243 @@
+// life_domain: scaling harness for Decomposition, a torus split into strips that separate processes step and exchange
+// halo rows through shared memory. Strong scaling keeps the board and adds processes, weak scaling grows the board
+// with them (--height rows per process). Every configuration is also run per halo depth, and --verify checks the
+// final board hash against the SIMD engine on one process
+#include "Decomposition.h"
+#include "Engine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<uint32_t> processes;
+    std::vector<uint32_t> haloDepths = {1, 4, 16};
+    uint32_t width = 4096;
+    uint32_t height = 4096;
+    uint32_t generations = 256;
+    uint64_t seed = 1;
+    double density = 0.5;
+    bool weak = false;
+    bool verify = false;
+    std::string jsonPath;
+    std::string tracePath;
+};
+
+struct Row {
+    Decomposition::Config config;
+    Decomposition::Result result;
+    double efficiency = 0.0;
+};
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+    std::vector<uint32_t> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+    return values;
+}
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_domain [options]\n"
+        "  --processes n,...     process counts (default: 1,2,4,hardware)\n"
+        "  --halo k,...          halo depths, the generations between exchanges (default: 1,4,16)\n"
+        "  --width n             board width, a multiple of 64 (default: 4096)\n"
+        "  --height n            board height, or rows per process with --weak (default: 4096)\n"
+        "  --generations n       generations per run (default: 256)\n"
+        "  --weak                weak scaling: the board grows with the process count\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           soup density (default: 0.5)\n"
+        "  --verify              check every final board against the SIMD engine (exit code 1 on a mismatch)\n"
+        "  --json path           write results as JSON ('-' for stdout)\n"
+        "  --trace path          write a Chrome trace of the coordinator (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--processes") options.processes = parseList(value());
+        else if (arg == "--halo") options.haloDepths = parseList(value());
+        else if (arg == "--width") options.width = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--height") options.height = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--generations") options.generations = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--weak") options.weak = true;
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--verify") options.verify = true;
+        else if (arg == "--json") options.jsonPath = value();
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    if (options.processes.empty()) {
+        const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned count : {1u, 2u, 4u, hardware}) {
+            if (count <= hardware && std::find(options.processes.begin(), options.processes.end(), count) == options.processes.end()) {
+                options.processes.push_back(count);
+            }
+        }
+    }
+    return options;
+}
+
+double cellUpdatesPerSecond(const Row& row)
+{
+    const double updates = static_cast<double>(row.config.width) * row.config.height * row.config.generations;
+    return row.result.seconds > 0.0 ? updates / row.result.seconds : 0.0;
+}
+
+void printRow(const Row& row)
+{
+    const double waitShare = row.result.seconds > 0.0 ? row.result.maxWaitSeconds / row.result.seconds : 0.0;
+    std::cout << std::right << std::setw(5) << row.config.processes
+              << std::setw(6) << row.config.haloDepth
+              << std::setw(7) << row.config.width
+              << std::setw(7) << row.config.height
+              << std::setw(6) << row.config.generations
+              << std::setw(10) << std::fixed << std::setprecision(4) << row.result.seconds
+              << std::setw(11) << std::setprecision(1) << cellUpdatesPerSecond(row) / 1e6
+              << std::setw(8) << std::setprecision(0) << row.efficiency * 100 << "%"
+              << std::setw(8) << waitShare * 100 << "%"
+              << std::setw(9) << row.result.exchanges << std::endl;
+}
+
+void writeJson(std::ostream& out, const Options& options, const std::vector<Row>& rows)
+{
+    out << "{\n";
+    out << "  \"schema\": 1,\n";
+    out << "  \"config\": {\"scaling\": \"" << (options.weak ? "weak" : "strong") << "\""
+        << ", \"seed\": " << options.seed
+        << ", \"density\": " << options.density
+        << ", \"hardwareThreads\": " << std::thread::hardware_concurrency() << "},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Row& r = rows[i];
+        out << "    {\"processes\": " << r.config.processes
+            << ", \"haloDepth\": " << r.config.haloDepth
+            << ", \"width\": " << r.config.width
+            << ", \"height\": " << r.config.height
+            << ", \"generations\": " << r.config.generations
+            << ", \"seconds\": " << std::setprecision(9) << std::defaultfloat << r.result.seconds
+            << ", \"maxComputeSeconds\": " << r.result.maxComputeSeconds
+            << ", \"maxWaitSeconds\": " << r.result.maxWaitSeconds
+            << ", \"efficiency\": " << std::fixed << std::setprecision(4) << r.efficiency
+            << ", \"cellUpdatesPerSecond\": " << std::setprecision(0) << cellUpdatesPerSecond(r)
+            << ", \"exchanges\": " << r.result.exchanges
+            << ", \"population\": " << r.result.population
+            << ", \"stateHash\": \"" << std::hex << std::setw(16) << std::setfill('0') << r.result.stateHash
+            << std::dec << std::setfill(' ') << "\"}"
+            << (i + 1 < rows.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("coordinator");
+    try {
+        const Options options = parseOptions(argc, argv);
+
+        std::cout << "procs  halo  width height  gens   seconds   Mcells/s     eff    wait  exchanges" << std::endl;
+        std::vector<Row> rows;
+        // SIMD engine hash per board height, the reference for --verify
+        std::map<uint32_t, uint64_t> expectedHashes;
+        uint32_t mismatches = 0;
+        for (uint32_t haloDepth : options.haloDepths) {
+            // Efficiency is relative to the first process count that ran at this halo depth
+            std::optional<Row> baseline;
+            for (uint32_t processes : options.processes) {
+                Row row;
+                row.config.width = options.width;
+                row.config.height = options.weak ? options.height * processes : options.height;
+                row.config.processes = processes;
+                row.config.haloDepth = haloDepth;
+                row.config.generations = options.generations;
+                row.config.seed = options.seed;
+                row.config.density = options.density;
+                try {
+                    row.result = Decomposition::run(row.config);
+                } catch (const Engine::ConfigurationError& e) {
+                    std::cout << "skipped " << processes << " processes with halo " << haloDepth << ": " << e.what() << std::endl;
+                    continue;
+                }
+                if (baseline) {
+                    // Strong: T0 * P0 / (T * P), weak: T0 / T
+                    const double ratio = baseline->result.seconds / row.result.seconds;
+                    row.efficiency = options.weak ? ratio : ratio * baseline->config.processes / processes;
+                } else {
+                    row.efficiency = 1.0;
+                }
+                if (!baseline) baseline = row;
+                rows.push_back(row);
+                printRow(row);
+
+                if (options.verify) {
+                    auto expected = expectedHashes.find(row.config.height);
+                    if (expected == expectedHashes.end()) {
+                        Grid board(row.config.width, row.config.height);
+                        board.fillRandom(options.density, options.seed);
+                        auto engine = Engine::create("simd");
+                        engine->load(board);
+                        engine->step(options.generations);
+                        expected = expectedHashes.emplace(row.config.height, engine->stateHash()).first;
+                    }
+                    if (expected->second != row.result.stateHash) {
+                        mismatches++;
+                        std::cout << "MISMATCH " << processes << " processes with halo " << haloDepth << ": hash "
+                                  << std::hex << row.result.stateHash << " but the SIMD engine has " << expected->second
+                                  << std::dec << std::endl;
+                    }
+                }
+            }
+        }
+
+        if (options.jsonPath == "-") {
+            writeJson(std::cout, options, rows);
+        } else if (!options.jsonPath.empty()) {
+            std::ofstream file(options.jsonPath);
+            if (!file) throw std::runtime_error("cannot write " + options.jsonPath);
+            writeJson(file, options, rows);
+        }
+
+        if (!options.tracePath.empty()) {
+            if (!Trace::ENABLED) std::cerr << "Tracing is compiled out, rebuild with -DLIFE_ENABLE_TRACING=ON" << std::endl;
+            if (!Trace::save(options.tracePath)) throw std::runtime_error("cannot write " + options.tracePath);
+        }
+
+        if (options.verify) {
+            std::cout << (mismatches == 0 ? "verified: every board matches the SIMD engine"
+                                          : std::to_string(mismatches) + " board(s) differ from the SIMD engine")
+                      << std::endl;
+            if (mismatches > 0) return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+// life_gpu: runs the browser's WGSL kernels natively (wgpu-native), with no surface: every frame steps a batch of
+// generations with computeMain and draws into an offscreen texture, or only steps with --compute-only. Reports
+// throughput and pass timings (CPU encode time included), checks the final board against the scalar CPU engine
+// with --verify and can save the last frame as a PNG.
+// Works on any adapter, including software ones (--software, or point VK_ICD_FILENAMES at lavapipe)
+#define WEBGPU_CPP_IMPLEMENTATION
+#include "Life.h"
+#include "Engine.h"
+#include "PngEncoder.h"
+#include "Trace.h"
+#include <webgpu/wgpu.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    Life::Headless headless;
+    uint32_t generations = 1000;
+    uint32_t stepsPerFrame = 1;
+    bool directRender = false;
+    uint64_t seed = 1;
+    double density = 0.5;
+    Topology::Kind topology = Topology::Kind::Torus;
+    bool verify = false;
+    std::string pngPath;
+    std::string tracePath;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_gpu [options]\n"
+        "  --generations n       generations to step (default: 1000)\n"
+        "  --steps-per-frame n   generations per frame, batched in one compute pass (default: 1)\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           soup density (default: 0.5)\n"
+        "  --topology name       torus, plane, klein, cross or sphere (default: torus)\n"
+        "  --width n             offscreen target width (default: 512)\n"
+        "  --height n            offscreen target height (default: 512)\n"
+        "  --compute-only        no render pass, only the compute passes\n"
+        "  --direct-render       encode the draw every frame instead of replaying a render bundle\n"
+        "  --software            request the fallback (software) adapter\n"
+        "  --verify              check the final board against the scalar engine (exit code 1 on a mismatch)\n"
+        "  --png path            write the last frame as a PNG\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--generations") options.generations = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--steps-per-frame") options.stepsPerFrame = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--topology") options.topology = Topology::parse(value());
+        else if (arg == "--width") options.headless.width = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--height") options.headless.height = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--compute-only") options.headless.computeOnly = true;
+        else if (arg == "--direct-render") options.directRender = true;
+        else if (arg == "--software") options.headless.softwareAdapter = true;
+        else if (arg == "--verify") options.verify = true;
+        else if (arg == "--png") options.pngPath = value();
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    if (options.headless.width == 0 || options.headless.height == 0) throw std::runtime_error("the target needs a size");
+    if (options.stepsPerFrame == 0) throw std::runtime_error("--steps-per-frame must be at least 1");
+    if (options.headless.computeOnly && !options.pngPath.empty()) throw std::runtime_error("--png needs the render pass");
+    return options;
+}
+
+// Waits for everything submitted so far, which also runs the pending map callbacks
+void waitForGpu(const Life& life)
+{
+    wgpuDevicePoll(life.getDevice(), true, nullptr);
+}
+
+// Copies size bytes out of the GPU with encodeCopy (into a fresh MapRead buffer) and waits for them
+std::vector<uint8_t> readBack(const Life& life, uint64_t size, const std::function<void(wgpu::CommandEncoder&, wgpu::Buffer&)>& encodeCopy)
+{
+    wgpu::BufferDescriptor stagingDesc {};
+    stagingDesc.setDefault();
+    stagingDesc.label = "Readback";
+    stagingDesc.size = size;
+    stagingDesc.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer staging = life.getDevice().createBuffer(stagingDesc);
+    if (!staging) throw std::runtime_error("cannot create the readback buffer");
+
+    wgpu::CommandEncoder encoder = life.getDevice().createCommandEncoder();
+    encodeCopy(encoder, staging);
+    wgpu::CommandBuffer commandBuffer = encoder.finish();
+    life.getQueue().submit(commandBuffer);
+
+    bool mapped = false;
+    bool failed = false;
+    auto mapCallback = staging.mapAsync(wgpu::MapMode::Read, 0, size, [&](wgpu::BufferMapAsyncStatus status) {
+        mapped = true;
+        failed = status != wgpu::BufferMapAsyncStatus::Success;
+    });
+    while (!mapped) waitForGpu(life);
+    if (failed) throw std::runtime_error("cannot map the readback buffer");
+
+    const auto* data = static_cast<const uint8_t*>(staging.getConstMappedRange(0, size));
+    std::vector<uint8_t> bytes(data, data + size);
+    staging.unmap();
+    staging.release();
+    return bytes;
+}
+
+Grid readBoard(const Life& life)
+{
+    const uint32_t size = Life::getGridSize();
+    const uint32_t padded = Life::getPaddedSize();
+    const uint64_t bytes = static_cast<uint64_t>(padded) * padded * sizeof(uint32_t);
+    const std::vector<uint8_t> data = readBack(life, bytes, [&](wgpu::CommandEncoder& encoder, wgpu::Buffer& staging) {
+        encoder.copyBufferToBuffer(life.getCurrentGenerationBuffer(), 0, staging, 0, bytes);
+    });
+
+    Grid grid(size, size);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            uint32_t cell = 0;
+            std::memcpy(&cell, data.data() + ((static_cast<size_t>(y) + 1) * padded + x + 1) * sizeof(uint32_t), sizeof(cell));
+            grid.setCell(x, y, static_cast<uint8_t>(cell != 0));
+        }
+    }
+    return grid;
+}
+
+// RGB24 of the offscreen target, top row first (the PngEncoder layout)
+std::vector<uint8_t> readFrame(const Life& life)
+{
+    const uint32_t width = life.getSurfaceConfig().width;
+    const uint32_t height = life.getSurfaceConfig().height;
+    // Texture copies need rows aligned to 256 bytes
+    const uint32_t bytesPerRow = (width * 4 + 255) / 256 * 256;
+    const std::vector<uint8_t> data = readBack(life, static_cast<uint64_t>(bytesPerRow) * height,
+        [&](wgpu::CommandEncoder& encoder, wgpu::Buffer& staging) {
+            wgpu::ImageCopyTexture source {};
+            source.setDefault();
+            source.texture = life.getOffscreenTexture();
+            wgpu::ImageCopyBuffer destination {};
+            destination.setDefault();
+            destination.buffer = staging;
+            destination.layout.bytesPerRow = bytesPerRow;
+            destination.layout.rowsPerImage = height;
+            encoder.copyTextureToBuffer(source, destination, wgpu::Extent3D(width, height, 1));
+        });
+
+    std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t* pixel = data.data() + static_cast<size_t>(y) * bytesPerRow + x * 4;
+            std::copy(pixel, pixel + 3, rgb.begin() + (static_cast<size_t>(y) * width + x) * 3);
+        }
+    }
+    return rgb;
+}
+
+void printAdapter(const Life& life)
+{
+    wgpu::AdapterProperties properties {};
+    properties.setDefault();
+    life.getAdapter().getProperties(&properties);
+    std::cout << "adapter: " << (properties.name ? properties.name : "unknown")
+              << (properties.adapterType == wgpu::AdapterType::CPU ? " (software)" : "") << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+
+        // wgpu-native answers the adapter and device requests right away, so startup is done when this returns
+        Life life {options.seed, options.density, options.headless};
+        if (!life.isReady()) throw std::runtime_error("WebGPU startup failed (see above)");
+        printAdapter(life);
+        if (options.topology != Topology::Kind::Torus) life.setTopology(options.topology);
+        life.setHaltOnCycle(false);
+        life.setSkipStillSteps(false);
+        life.setUseRenderBundles(!options.directRender);
+        life.setPaused(true);
+        std::cout << "startup: device after " << std::fixed << std::setprecision(1)
+                  << life.getStartupMs(Life::StartupMilestone::Device) << " ms, first board after "
+                  << life.getStartupMs(Life::StartupMilestone::Resources) << " ms" << std::endl;
+
+        // Every frame steps --steps-per-frame generations (requestStep works while paused) and, unless compute-only,
+        // draws. Polling without waiting lets the hash, history and timer readbacks complete as they would in a browser
+        const auto start = std::chrono::steady_clock::now();
+        uint32_t frames = 0;
+        for (uint32_t generation = 0; generation < options.generations; frames++) {
+            const uint32_t batch = std::min(options.stepsPerFrame, options.generations - generation);
+            life.requestStep(batch);
+            life.renderFrame();
+            wgpuDevicePoll(life.getDevice(), false, nullptr);
+            generation += batch;
+        }
+        waitForGpu(life);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (life.getGeneration() != options.generations) {
+            throw std::runtime_error("stepped " + std::to_string(life.getGeneration()) + " generations instead of " +
+                                     std::to_string(options.generations));
+        }
+
+        const double cells = static_cast<double>(Life::getGridSize()) * Life::getGridSize() * options.generations;
+        std::cout << options.generations << " generations in " << std::setprecision(3) << seconds << " s: "
+                  << std::setprecision(1) << seconds * 1e6 / options.generations << " us/gen, "
+                  << cells / seconds / 1e6 << " Mcells/s, " << frames << " frames" << std::endl;
+        const GpuTimer& timer = life.getGpuTimer();
+        const char* passNames[] = {"compute", "render", "submit->done", "encode (cpu)"};
+        for (uint32_t pass = 0; pass < GpuTimer::PASS_COUNT; pass++) {
+            const double ms = timer.getPercentileMs(static_cast<GpuTimer::Pass>(pass), 50);
+            if (ms >= 0.0) std::cout << "  " << passNames[pass] << " p50 " << std::setprecision(3) << ms << " ms" << std::endl;
+        }
+
+        const Grid board = readBoard(life);
+        std::cout << "population " << board.population() << ", checksum " << std::hex << board.checksum() << std::dec
+                  << std::endl;
+        // Stepping does not halt on a cycle here, the period monitor still finds it
+        if (const auto& cycle = life.getPeriodMonitor().getCycle()) {
+            std::cout << "board repeats every " << cycle->period << " generation(s) from generation "
+                      << cycle->firstGeneration << std::endl;
+        }
+
+        if (!options.pngPath.empty()) {
+            const std::vector<uint8_t> rgb = readFrame(life);
+            const std::vector<uint8_t> png = PngEncoder::encode(options.headless.width, options.headless.height, rgb.data());
+            std::ofstream file(options.pngPath, std::ios::binary);
+            if (!file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()))) {
+                throw std::runtime_error("cannot write " + options.pngPath);
+            }
+        }
+
+        if (!options.tracePath.empty()) {
+            if (!Trace::ENABLED) std::cerr << "Tracing is compiled out, rebuild with -DLIFE_ENABLE_TRACING=ON" << std::endl;
+            if (!Trace::save(options.tracePath)) throw std::runtime_error("cannot write " + options.tracePath);
+        }
+
+        if (options.verify) {
+            Grid expected(Life::getGridSize(), Life::getGridSize());
+            expected.fillRandom(options.density, options.seed);
+            auto engine = Engine::create("scalar");
+            if (options.topology != Topology::Kind::Torus) engine->setTopology(options.topology);
+            engine->load(expected);
+            engine->step(options.generations);
+            engine->store(expected);
+            if (expected.checksum() != board.checksum()) {
+                std::cout << "MISMATCH: the scalar engine has population " << expected.population() << ", checksum "
+                          << std::hex << expected.checksum() << std::dec << std::endl;
+                return 1;
+            }
+            std::cout << "verified: the GPU board matches the scalar engine" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+// life_lattice: steps soups on the hexagonal and triangular lattices (LatticeEngine) and reports the time per cell
+// next to the square Conway kernel of ScalarEngine on the same board. With --verify every run is replayed with a
+// plain neighbour list per cell (wrapped with modulo arithmetic) and the final boards compared
+#include "LatticeEngine.h"
+#include "ScalarEngine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<std::string> rules = {"hex", "triangle"};
+    std::vector<uint32_t> sizes = {256, 1024};
+    uint32_t generations = 100;
+    uint64_t seed = 1;
+    double density = 0.5;
+    Topology::Kind topology = Topology::Kind::Torus;
+    bool verify = false;
+    std::string tracePath;
+};
+
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_lattice [options]\n"
+        "  --rules a,b,...       lattice rules like B2/S34H or B4/S345T, or hex, triangle (default: hex,triangle)\n"
+        "  --sizes n,...         square board sizes, even (default: 256,1024)\n"
+        "  --generations n       generations per run (default: 100)\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           soup density (default: 0.5)\n"
+        "  --topology name       torus or plane (default: torus)\n"
+        "  --verify              check every run against a neighbour-list reference (exit code 1 on a mismatch)\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--rules") options.rules = splitList(value());
+        else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& size : splitList(value())) options.sizes.push_back(static_cast<uint32_t>(std::stoul(size)));
+        }
+        else if (arg == "--generations") options.generations = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--topology") options.topology = Topology::parse(value());
+        else if (arg == "--verify") options.verify = true;
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    return options;
+}
+
+// Seconds the engine takes for generations steps of board
+double timeSteps(Engine& engine, const Grid& board, uint32_t generations)
+{
+    engine.load(board);
+    const auto start = std::chrono::steady_clock::now();
+    engine.step(generations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Neighbours of (x, y) as (dx, dy), the way LatticeRule describes them
+std::vector<std::pair<int64_t, int64_t>> neighbourOffsets(LatticeRule::Kind kind, int64_t x, int64_t y)
+{
+    if (kind == LatticeRule::Kind::Hex) {
+        const int64_t shift = y & 1;
+        return {{-1, 0}, {1, 0}, {shift - 1, -1}, {shift, -1}, {shift - 1, 1}, {shift, 1}};
+    }
+    const int64_t flat = ((x + y) & 1) == 0 ? -1 : 1;
+    std::vector<std::pair<int64_t, int64_t>> offsets;
+    for (int64_t dx = -2; dx <= 2; dx++) {
+        if (dx != 0) offsets.push_back({dx, 0});
+        offsets.push_back({dx, flat});
+        if (dx >= -1 && dx <= 1) offsets.push_back({dx, -flat});
+    }
+    return offsets;
+}
+
+// The same generations with a neighbour list per cell, no halo
+Grid referenceRun(const Grid& board, const LatticeRule& rule, Topology::Kind topology, uint32_t generations)
+{
+    const int64_t width = board.getWidth();
+    const int64_t height = board.getHeight();
+    Grid current = board;
+    Grid next(board.getWidth(), board.getHeight());
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        for (int64_t y = 0; y < height; y++) {
+            for (int64_t x = 0; x < width; x++) {
+                uint32_t count = 0;
+                for (const auto& [dx, dy] : neighbourOffsets(rule.kind, x, y)) {
+                    int64_t nx = x + dx;
+                    int64_t ny = y + dy;
+                    const bool outside = nx < 0 || nx >= width || ny < 0 || ny >= height;
+                    if (outside && topology == Topology::Kind::Plane) continue;
+                    nx = (nx % width + width) % width;
+                    ny = (ny % height + height) % height;
+                    count += current.getCell(static_cast<uint32_t>(nx), static_cast<uint32_t>(ny));
+                }
+                const bool alive = current.getCell(static_cast<uint32_t>(x), static_cast<uint32_t>(y)) != 0;
+                next.setCell(static_cast<uint32_t>(x), static_cast<uint32_t>(y), rule.nextState(alive, count) ? 1 : 0);
+            }
+        }
+        std::swap(current, next);
+    }
+    return current;
+}
+
+void printRow(const std::string& rule, uint32_t size, uint32_t generations, double seconds, uint64_t population,
+              double squareSeconds)
+{
+    const double cells = static_cast<double>(size) * size * std::max(generations, 1u);
+    std::cout << std::left << std::setw(12) << rule
+              << std::right << std::setw(7) << size
+              << std::setw(11) << std::fixed << std::setprecision(3) << seconds * 1e9 / cells
+              << std::setw(12) << population
+              << std::setw(11) << std::setprecision(2) << seconds / squareSeconds << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+        std::vector<LatticeRule> rules;
+        for (const auto& text : options.rules) rules.push_back(LatticeRule::parse(text));
+
+        std::cout << "rule           size    ns/cell  population  vs-square" << std::endl;
+        uint32_t mismatches = 0;
+        for (const uint32_t size : options.sizes) {
+            Grid soup(size, size);
+            soup.fillRandom(options.density, options.seed);
+
+            ScalarEngine square;
+            square.setTopology(options.topology);
+            const double squareSeconds = timeSteps(square, soup, options.generations);
+            printRow("B3/S23", size, options.generations, squareSeconds, square.population(), squareSeconds);
+
+            for (const LatticeRule& rule : rules) {
+                LatticeEngine engine(rule);
+                engine.setTopology(options.topology);
+                const double seconds = timeSteps(engine, soup, options.generations);
+                printRow(rule.toString(), size, options.generations, seconds, engine.population(), squareSeconds);
+
+                if (options.verify) {
+                    Grid result;
+                    engine.store(result);
+                    const bool matches = result == referenceRun(soup, rule, options.topology, options.generations);
+                    if (!matches) {
+                        mismatches++;
+                        std::cout << "MISMATCH: " << rule.toString() << " at " << size << std::endl;
+                    }
+                }
+            }
+        }
+
+        if (!options.tracePath.empty()) Trace::save(options.tracePath);
+        if (options.verify) {
+            if (mismatches > 0) {
+                std::cout << mismatches << " runs differ from the neighbour-list reference" << std::endl;
+                return 1;
+            }
+            std::cout << "verified: every lattice run matches the neighbour-list reference" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+// life_lenia: steps a Lenia board (LeniaEngine) per kernel radius and reports the time per generation of the FFT and
+// the direct convolution, and whether it keeps up with 60 generations per second. With --verify every FFT
+// generation is checked against the direct convolution of the same board
+#include "LeniaEngine.h"
+#include "Engine.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string rule = "orbium";
+    std::vector<uint32_t> radii = {13, 25, 50};
+    uint32_t size = 512;
+    uint32_t generations = 100;
+    unsigned threads = 0;
+    uint64_t seed = 1;
+    double density = 0.5;
+    bool direct = false;
+    bool verify = false;
+    std::string tracePath;
+};
+
+constexpr double REAL_TIME_GENERATIONS_PER_SECOND = 60.0;
+// Largest state difference --verify accepts between the two convolutions after one generation
+constexpr float VERIFY_TOLERANCE = 1e-3f;
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+    std::vector<uint32_t> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+    return values;
+}
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_lenia [options]\n"
+        "  --rule rule           Lenia rule, e.g. R13,T10,M0.15,S0.015, or a name like orbium (default: orbium)\n"
+        "  --radii r,...         kernel radii to run the rule at (default: 13,25,50)\n"
+        "  --size n              square board size, a power of two (default: 512)\n"
+        "  --generations n       generations per run (default: 100)\n"
+        "  --threads n           threads (default: hardware)\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           share of non-zero cells in the soup (default: 0.5)\n"
+        "  --direct              also time the direct convolution\n"
+        "  --verify              check every FFT generation against the direct convolution (exit code 1 on a mismatch)\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--rule") options.rule = value();
+        else if (arg == "--radii") options.radii = parseList(value());
+        else if (arg == "--size") options.size = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--generations") options.generations = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--threads") options.threads = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--direct") options.direct = true;
+        else if (arg == "--verify") options.verify = true;
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    return options;
+}
+
+// Seconds per generation of engine over generations steps
+double timeSteps(LeniaEngine& engine, uint32_t generations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    engine.step(generations);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds / std::max(generations, 1u);
+}
+
+void printRow(const char* method, uint32_t radius, const LeniaEngine& engine, double secondsPerGeneration)
+{
+    const double perSecond = secondsPerGeneration > 0.0 ? 1.0 / secondsPerGeneration : 0.0;
+    std::cout << std::left << std::setw(8) << method
+              << std::right << std::setw(7) << radius
+              << std::setw(6) << engine.getThreadCount()
+              << std::setw(7) << engine.getWidth()
+              << std::setw(12) << std::fixed << std::setprecision(3) << secondsPerGeneration * 1e3
+              << std::setw(10) << std::setprecision(1) << perSecond
+              << std::setw(12) << std::setprecision(1) << engine.mass()
+              << "  " << (perSecond >= REAL_TIME_GENERATIONS_PER_SECOND ? "yes" : "no") << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+        const LeniaRule baseRule = LeniaRule::parse(options.rule);
+        const std::vector<float> soup = LeniaEngine::makeSoup(options.size, options.size, options.seed, options.density);
+
+        std::cout << "method   radius  thr   size   ms/gen     gen/s        mass  real-time" << std::endl;
+        uint32_t mismatches = 0;
+        for (const uint32_t radius : options.radii) {
+            LeniaRule rule = baseRule;
+            rule.radius = radius;
+            if (radius < 1 || radius > LeniaRule::MAX_RADIUS) {
+                throw Engine::ConfigurationError("radius " + std::to_string(radius) + " is outside [1, " +
+                                                 std::to_string(LeniaRule::MAX_RADIUS) + "]");
+            }
+
+            LeniaEngine engine(rule, options.threads);
+            engine.load(soup, options.size, options.size);
+            printRow("fft", radius, engine, timeSteps(engine, options.generations));
+
+            if (options.direct) {
+                LeniaEngine direct(rule, options.threads);
+                direct.setConvolution(LeniaEngine::Convolution::Direct);
+                direct.load(soup, options.size, options.size);
+                printRow("direct", radius, direct, timeSteps(direct, options.generations));
+            }
+
+            if (options.verify) {
+                // Both step the same board every generation, so only one generation's rounding is compared
+                LeniaEngine fft(rule, options.threads);
+                LeniaEngine direct(rule, options.threads);
+                direct.setConvolution(LeniaEngine::Convolution::Direct);
+                fft.load(soup, options.size, options.size);
+                float worst = 0.0f;
+                for (uint32_t generation = 0; generation < options.generations; generation++) {
+                    direct.load(fft.getField(), options.size, options.size);
+                    fft.step();
+                    direct.step();
+                    for (size_t i = 0; i < fft.getField().size(); i++) {
+                        worst = std::max(worst, std::abs(fft.getField()[i] - direct.getField()[i]));
+                    }
+                }
+                const bool matches = worst <= VERIFY_TOLERANCE;
+                if (!matches) mismatches++;
+                std::cout << "verify radius " << radius << ": largest difference " << std::scientific
+                          << std::setprecision(2) << worst << std::defaultfloat
+                          << (matches ? "" : " MISMATCH") << std::endl;
+            }
+        }
+
+        if (!options.tracePath.empty()) Trace::save(options.tracePath);
+        if (options.verify) {
+            if (mismatches > 0) {
+                std::cout << mismatches << " radii differ from the direct convolution" << std::endl;
+                return 1;
+            }
+            std::cout << "verified: the FFT matches the direct convolution" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+// life_search: apgsearch-style soup search. Runs seeded 16x16 soups to stabilization on every core,
+// identifies the objects in the ash and writes the census (apgcode and count per line).
+// The headline number is soups per second per thread
+#include "SoupSearch.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Options {
+    SoupSearch::Options search;
+    uint64_t soups = 1000;
+    unsigned threads = 0;
+    size_t top = 20;
+    std::string censusPath;
+    std::string jsonPath;
+    std::string tracePath;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_search [options]\n"
+        "  --soups n             soups to run (default: 1000)\n"
+        "  --threads n           worker threads (default: hardware)\n"
+        "  --seed n              first soup seed, soup i is a pure function of (seed, i) (default: 0)\n"
+        "  --board n             torus size each soup runs on (default: 256)\n"
+        "  --engine name         engine stepping the soups (default: simd)\n"
+        "  --max-generations n   give up on soups that have not settled by then (default: 32768)\n"
+        "  --top n               objects listed in the summary (default: 20)\n"
+        "  --census path         write the full census, one 'apgcode count' line per object ('-' for stdout)\n"
+        "  --json path           write the run summary as JSON ('-' for stdout)\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--soups") options.soups = std::stoull(value());
+        else if (arg == "--threads") options.threads = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--seed") options.search.seed = std::stoull(value());
+        else if (arg == "--board") options.search.boardSize = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--engine") options.search.engine = value();
+        else if (arg == "--max-generations") options.search.maxGenerations = std::stoull(value());
+        else if (arg == "--top") options.top = std::stoul(value());
+        else if (arg == "--census") options.censusPath = value();
+        else if (arg == "--json") options.jsonPath = value();
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    return options;
+}
+
+void writeJson(std::ostream& out, const Options& options, unsigned threads, const SoupSearch::BatchResult& result,
+               double seconds, const Census& census)
+{
+    const double soupsPerSecond = seconds > 0.0 ? result.soups / seconds : 0.0;
+    out << "{\n";
+    out << "  \"schema\": 1,\n";
+    out << "  \"config\": {\"seed\": " << options.search.seed
+        << ", \"board\": " << options.search.boardSize
+        << ", \"engine\": \"" << options.search.engine << "\""
+        << ", \"maxGenerations\": " << options.search.maxGenerations
+        << ", \"threads\": " << threads << "},\n";
+    out << "  \"soups\": " << result.soups
+        << ", \"stabilized\": " << result.stabilized
+        << ", \"generations\": " << result.generations
+        << ", \"objects\": " << result.objects << ",\n";
+    out << "  \"seconds\": " << std::setprecision(9) << seconds
+        << ", \"soupsPerSecond\": " << std::fixed << std::setprecision(2) << soupsPerSecond
+        << ", \"soupsPerSecondPerThread\": " << soupsPerSecond / threads << std::defaultfloat << ",\n";
+    out << "  \"census\": {";
+    const auto entries = census.sorted();
+    for (size_t i = 0; i < entries.size(); i++) {
+        out << (i == 0 ? "\n" : ",\n") << "    \"" << entries[i].first << "\": " << entries[i].second;
+    }
+    out << "\n  }\n}\n";
+}
+
+template <typename Write>
+void writeTo(const std::string& path, Write&& write)
+{
+    if (path == "-") {
+        write(std::cout);
+        return;
+    }
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("cannot write " + path);
+    write(file);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+        ThreadPool pool {options.threads};
+        const unsigned threads = pool.getThreadCount();
+
+        Census census;
+        const auto start = std::chrono::steady_clock::now();
+        const SoupSearch::BatchResult result = SoupSearch::runBatch(options.search, options.soups, pool, census);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const double soupsPerSecond = seconds > 0.0 ? result.soups / seconds : 0.0;
+        std::cout << result.soups << " soups (" << result.soups - result.stabilized << " unsettled after "
+                  << options.search.maxGenerations << " generations), " << result.objects << " objects, "
+                  << std::fixed << std::setprecision(1) << static_cast<double>(result.generations) / std::max<uint64_t>(result.soups, 1)
+                  << " generations per soup" << std::endl;
+        std::cout << std::setprecision(2) << seconds << " s on " << threads << " thread(s): "
+                  << soupsPerSecond << " soups/s, " << soupsPerSecond / threads << " soups/s per thread" << std::endl;
+
+        const auto entries = census.sorted();
+        for (size_t i = 0; i < std::min(options.top, entries.size()); i++) {
+            std::cout << std::setw(12) << entries[i].second << "  " << entries[i].first << std::endl;
+        }
+
+        if (!options.censusPath.empty()) {
+            writeTo(options.censusPath, [&census](std::ostream& out) { census.write(out); });
+        }
+        if (!options.jsonPath.empty()) {
+            writeTo(options.jsonPath, [&](std::ostream& out) { writeJson(out, options, threads, result, seconds, census); });
+        }
+        if (!options.tracePath.empty()) {
+            if (!Trace::ENABLED) std::cerr << "Tracing is compiled out, rebuild with -DLIFE_ENABLE_TRACING=ON" << std::endl;
+            if (!Trace::save(options.tracePath)) throw std::runtime_error("cannot write " + options.tracePath);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
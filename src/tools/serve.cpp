@@ -0,0 +1,376 @@
+// life_serve: runs one board on the CPU and streams it over WebSocket to any number of pages (index.html?stream=...),
+// which draw it with the usual render pipeline instead of simulating. Each client asks for a window of the board
+// (ws://host:port/?x=0&y=0&width=256&height=256, x and width multiples of 64) and gets a DeltaStream: a keyframe when
+// it joins (and every --keyframe-interval generations), then the XOR delta of every generation, so its bandwidth
+// follows the activity inside its window rather than the window's area. Clients that fall behind skip generations
+// and catch up with a keyframe once their backlog has drained
+#include "DeltaStream.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "History.h"
+#include "Pattern.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "WebSocketServer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string address = "127.0.0.1";
+    uint16_t port = 8080;
+    std::string engine = "simd";
+    std::string board = "soup";
+    uint32_t width = 1024;
+    uint32_t height = 1024;
+    uint64_t seed = 1;
+    double density = 0.5;
+    Topology::Kind topology = Topology::Kind::Torus;
+    double rate = 10.0;
+    uint64_t generations = 0;
+    uint32_t keyframeInterval = 1000;
+    size_t maxQueueBytes = 1 << 20;
+    double statsSeconds = 5.0;
+    std::string tracePath;
+};
+
+// Part of the board a client shows, in board cells
+struct Window {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    auto key() const { return std::tuple(x, y, width, height); }
+};
+
+// Shared by every client showing the same window, each generation is encoded once
+struct WindowStream {
+    Window window;
+    History::Words board;
+    uint64_t generation = 0;
+    std::vector<uint8_t> delta;
+    // Encoded on demand, most generations nobody needs one
+    std::vector<uint8_t> keyframe;
+    uint32_t clients = 0;
+
+    const std::vector<uint8_t>& getKeyframe()
+    {
+        if (keyframe.empty()) DeltaStream::encodeKeyframe(generation, window.width, window.height, board, keyframe);
+        return keyframe;
+    }
+};
+
+struct Client {
+    WindowStream* stream = nullptr;
+    bool needsKeyframe = true;
+};
+
+struct Totals {
+    uint64_t deltaMessages = 0;
+    uint64_t deltaBytes = 0;
+    uint64_t keyframeMessages = 0;
+    uint64_t keyframeBytes = 0;
+    // Generations not sent to a client because its backlog was over --max-queue
+    uint64_t skipped = 0;
+};
+
+std::atomic<bool> g_stopRequested = false;
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_serve [options]\n"
+        "  --port n              port to listen on, 0 picks a free one (default: 8080)\n"
+        "  --bind address        IPv4 address to listen on (default: 127.0.0.1, loopback only)\n"
+        "  --board name          soup, empty, a builtin pattern name or an .rle file (default: soup)\n"
+        "  --width n             board width (default: 1024)\n"
+        "  --height n            board height (default: 1024)\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           soup density (default: 0.5)\n"
+        "  --topology name       torus, plane, klein, cross or sphere (default: torus)\n"
+        "  --engine name         engine stepping the board (default: simd)\n"
+        "  --rate r              generations per second, 0 for as fast as possible (default: 10)\n"
+        "  --generations n       stop after n generations, 0 runs until interrupted (default: 0)\n"
+        "  --keyframe-interval n generations between keyframes to every client, 0 for only on joining (default: 1000)\n"
+        "  --max-queue bytes     backlog at which a client skips generations (default: 1048576)\n"
+        "  --stats seconds       bandwidth report interval, 0 for none (default: 5)\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--port") options.port = static_cast<uint16_t>(std::stoul(value()));
+        else if (arg == "--bind") options.address = value();
+        else if (arg == "--board") options.board = value();
+        else if (arg == "--width") options.width = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--height") options.height = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--topology") options.topology = Topology::parse(value());
+        else if (arg == "--engine") options.engine = value();
+        else if (arg == "--rate") options.rate = std::stod(value());
+        else if (arg == "--generations") options.generations = std::stoull(value());
+        else if (arg == "--keyframe-interval") options.keyframeInterval = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--max-queue") options.maxQueueBytes = std::stoull(value());
+        else if (arg == "--stats") options.statsSeconds = std::stod(value());
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    return options;
+}
+
+Grid makeBoard(const Options& options)
+{
+    Grid grid(options.width, options.height);
+    if (options.board == "soup") {
+        ThreadPool fillPool;
+        grid.fillRandom(options.density, options.seed, fillPool);
+    } else if (options.board.ends_with(".rle")) {
+        std::ifstream file(options.board);
+        if (!file) throw std::runtime_error("cannot read " + options.board);
+        std::stringstream text;
+        text << file.rdbuf();
+        Pattern::fromRle(text.str(), options.board).stampCentered(grid);
+    } else if (options.board != "empty") {
+        Pattern::getBuiltin(options.board).stampCentered(grid);
+    }
+    return grid;
+}
+
+// "/?x=0&y=256&width=256&height=256", missing fields cover the whole board. Nothing for windows the stream cannot
+// carry: x and width have to be whole History words, and the window has to lie on the board
+std::optional<Window> parseWindow(const std::string& target, const Grid& board)
+{
+    Window window {0, 0, board.getWidth(), board.getHeight()};
+    const size_t query = target.find('?');
+    if (query != std::string::npos) {
+        std::stringstream stream(target.substr(query + 1));
+        std::string field;
+        while (std::getline(stream, field, '&')) {
+            const size_t equals = field.find('=');
+            if (equals == std::string::npos) continue;
+            const std::string name = field.substr(0, equals);
+            uint32_t value = 0;
+            try {
+                value = static_cast<uint32_t>(std::stoul(field.substr(equals + 1)));
+            } catch (const std::exception&) {
+                return std::nullopt;
+            }
+            if (name == "x") window.x = value;
+            else if (name == "y") window.y = value;
+            else if (name == "width") window.width = value;
+            else if (name == "height") window.height = value;
+        }
+    }
+    const bool aligned = window.x % 64 == 0 && window.width % 64 == 0;
+    const bool inside = window.width > 0 && window.height > 0 &&
+                        static_cast<uint64_t>(window.x) + window.width <= board.getWidth() &&
+                        static_cast<uint64_t>(window.y) + window.height <= board.getHeight();
+    if (!aligned || !inside) return std::nullopt;
+    return window;
+}
+
+History::Words packWindow(const Grid& board, const Window& window)
+{
+    TRACE_SCOPE("packWindow");
+    const uint32_t wordsPerRow = window.width / 64;
+    History::Words words(static_cast<size_t>(wordsPerRow) * window.height, 0);
+    for (uint32_t y = 0; y < window.height; y++) {
+        for (uint32_t x = 0; x < window.width; x++) {
+            if (board.getCell(window.x + x, window.y + y)) {
+                words[static_cast<size_t>(y) * wordsPerRow + x / 64] |= 1ull << (x % 64);
+            }
+        }
+    }
+    return words;
+}
+
+std::string formatBytes(double bytes)
+{
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    if (bytes >= 1 << 20) text << bytes / (1 << 20) << " MiB";
+    else if (bytes >= 1 << 10) text << bytes / (1 << 10) << " KiB";
+    else text << bytes << " B";
+    return text.str();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+        std::signal(SIGINT, [](int) { g_stopRequested = true; });
+        std::signal(SIGTERM, [](int) { g_stopRequested = true; });
+
+        std::unique_ptr<Engine> engine = Engine::create(options.engine);
+        engine->setTopology(options.topology);
+        engine->load(makeBoard(options));
+        Grid board;
+        engine->store(board);
+        uint64_t generation = 0;
+
+        std::map<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>, WindowStream> streams;
+        std::map<WebSocketServer::ConnectionId, Client> clients;
+        Totals totals;
+
+        WebSocketServer server(options.address, options.port);
+        server.setOnOpen([&](WebSocketServer::ConnectionId id, const std::string& target) {
+            const std::optional<Window> window = parseWindow(target, board);
+            if (!window) {
+                std::cerr << "Refused " << target << ": windows need x and width in multiples of 64 and to fit on the "
+                          << board.getWidth() << "x" << board.getHeight() << " board" << std::endl;
+                return false;
+            }
+            WindowStream& stream = streams[window->key()];
+            if (stream.clients++ == 0) {
+                stream.window = *window;
+                stream.board = packWindow(board, *window);
+                stream.generation = generation;
+                stream.delta.clear();
+                stream.keyframe.clear();
+            }
+            clients[id].stream = &stream;
+            std::cerr << "Client " << id << " joined for " << window->width << "x" << window->height << " at ("
+                      << window->x << ", " << window->y << ")" << std::endl;
+            return true;
+        });
+        server.setOnClose([&](WebSocketServer::ConnectionId id) {
+            auto it = clients.find(id);
+            if (it == clients.end()) return;
+            WindowStream* stream = it->second.stream;
+            clients.erase(it);
+            if (--stream->clients == 0) streams.erase(stream->window.key());
+            std::cerr << "Client " << id << " left" << std::endl;
+        });
+
+        // Sends generation's message of the client's window, or nothing while its backlog is too long
+        auto sendTo = [&](WebSocketServer::ConnectionId id, Client& client, bool keyframe) {
+            if (server.getQueuedBytes(id) > options.maxQueueBytes) {
+                client.needsKeyframe = true;
+                totals.skipped++;
+                return;
+            }
+            const std::vector<uint8_t>& message = keyframe ? client.stream->getKeyframe() : client.stream->delta;
+            if (!server.send(id, message.data(), message.size())) return;
+            client.needsKeyframe = false;
+            (keyframe ? totals.keyframeMessages : totals.deltaMessages)++;
+            (keyframe ? totals.keyframeBytes : totals.deltaBytes) += message.size();
+        };
+
+        std::cerr << "Serving a " << options.width << "x" << options.height << " board on ws://" << options.address
+                  << ":" << server.getPort() << "/ (open index.html?stream=ws://" << options.address << ":"
+                  << server.getPort() << "/)" << std::endl;
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        const auto interval = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(options.rate > 0.0 ? 1.0 / options.rate : 0.0));
+        auto nextStep = start + interval;
+        auto nextStats = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.statsSeconds));
+        Totals lastTotals;
+        auto lastStats = start;
+
+        while (!g_stopRequested && (options.generations == 0 || generation < options.generations)) {
+            const auto now = Clock::now();
+            const int timeoutMs = nextStep > now
+                ? static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextStep - now).count()) + 1
+                : 0;
+            server.poll(timeoutMs);
+
+            // New clients (and ones whose backlog drained) get the current board right away
+            for (auto& [id, client] : clients) {
+                if (client.needsKeyframe && server.getQueuedBytes(id) <= options.maxQueueBytes) sendTo(id, client, true);
+            }
+
+            if (Clock::now() >= nextStep) {
+                nextStep = std::max(nextStep + interval, Clock::now() - interval);
+                {
+                    TRACE_SCOPE("step");
+                    engine->step(1);
+                    engine->store(board);
+                    generation++;
+                }
+                {
+                    TRACE_SCOPE("encode");
+                    for (auto& [key, stream] : streams) {
+                        History::Words next = packWindow(board, stream.window);
+                        stream.delta.clear();
+                        stream.keyframe.clear();
+                        DeltaStream::encodeDelta(generation, stream.window.width, stream.window.height, stream.board,
+                                                 next, stream.delta);
+                        stream.board = std::move(next);
+                        stream.generation = generation;
+                    }
+                }
+                const bool periodic = options.keyframeInterval > 0 && generation % options.keyframeInterval == 0;
+                for (auto& [id, client] : clients) {
+                    sendTo(id, client, periodic || client.needsKeyframe);
+                }
+            }
+
+            if (options.statsSeconds > 0.0 && Clock::now() >= nextStats) {
+                const double seconds = std::chrono::duration<double>(Clock::now() - lastStats).count();
+                const uint64_t bytes = totals.deltaBytes + totals.keyframeBytes - lastTotals.deltaBytes - lastTotals.keyframeBytes;
+                const uint64_t deltas = totals.deltaMessages - lastTotals.deltaMessages;
+                std::cerr << "generation " << generation << ", " << clients.size() << " client(s), "
+                          << formatBytes(bytes / seconds) << "/s out, "
+                          << formatBytes(deltas > 0 ? static_cast<double>(totals.deltaBytes - lastTotals.deltaBytes) / deltas : 0.0)
+                          << " per delta, " << totals.keyframeMessages - lastTotals.keyframeMessages << " keyframe(s), "
+                          << totals.skipped - lastTotals.skipped << " skipped" << std::endl;
+                lastTotals = totals;
+                lastStats = Clock::now();
+                nextStats = lastStats + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.statsSeconds));
+            }
+        }
+
+        // Let the last messages out before saying goodbye
+        for (const auto& [id, client] : clients) server.close(id);
+        const auto drainDeadline = Clock::now() + std::chrono::seconds(1);
+        while (server.getConnectionCount() > 0 && Clock::now() < drainDeadline) server.poll(10);
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cerr << std::fixed << std::setprecision(2) << generation << " generations in " << seconds << " s. Sent "
+                  << totals.deltaMessages << " deltas (" << formatBytes(static_cast<double>(totals.deltaBytes)) << ", "
+                  << formatBytes(totals.deltaMessages > 0 ? static_cast<double>(totals.deltaBytes) / totals.deltaMessages : 0.0)
+                  << " each) and " << totals.keyframeMessages << " keyframes ("
+                  << formatBytes(static_cast<double>(totals.keyframeBytes)) << "), skipped " << totals.skipped
+                  << std::endl;
+
+        if (!options.tracePath.empty()) {
+            if (!Trace::ENABLED) std::cerr << "Tracing is compiled out, rebuild with -DLIFE_ENABLE_TRACING=ON" << std::endl;
+            if (!Trace::save(options.tracePath)) throw std::runtime_error("cannot write " + options.tracePath);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
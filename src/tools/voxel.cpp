@@ -0,0 +1,171 @@
+// life_voxel: steps 3D Life soups (VoxelEngine) on bricked cubic volumes and reports the time per generation and per
+// cell. With --verify every run is replayed cell by cell with a plain 26-neighbour count (wrapped with modulo
+// arithmetic) and the final volumes compared
+#include "Trace.h"
+#include "VoxelEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+    // 5,26,5,5 and 6,26,5,5 reach totals past 16 (the fifth bit plane) and have survive masks that only differ past
+    // six significant digits
+    std::vector<std::string> rules = {"4555", "5766", "5,26,5,5", "6,26,5,5"};
+    std::vector<uint32_t> sizes = {64, 256};
+    uint32_t generations = 20;
+    unsigned threads = 0;
+    uint64_t seed = 1;
+    double density = 0.3;
+    bool verify = false;
+    std::string tracePath;
+};
+
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: life_voxel [options]\n"
+        "  --rules a;b;...       3D rules in Bays' notation, like 4555 or 4,5,5,5\n"
+        "                        (default: 4555;5766;5,26,5,5;6,26,5,5)\n"
+        "  --sizes n,...         cube sides, multiples of 4 (default: 64,256)\n"
+        "  --generations n       generations per run (default: 20)\n"
+        "  --threads n           worker threads, 0 for all hardware threads (default: 0)\n"
+        "  --seed n              soup seed (default: 1)\n"
+        "  --density d           soup density in the middle cube of half the side (default: 0.3)\n"
+        "  --verify              check every run against a cell-by-cell reference (exit code 1 on a mismatch)\n"
+        "  --trace path          write a Chrome trace of the run (needs LIFE_ENABLE_TRACING)\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--rules") {
+            // Semicolons, the rules themselves may contain commas
+            options.rules.clear();
+            std::stringstream stream(value());
+            std::string rule;
+            while (std::getline(stream, rule, ';')) {
+                if (!rule.empty()) options.rules.push_back(rule);
+            }
+        }
+        else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& size : splitList(value())) options.sizes.push_back(static_cast<uint32_t>(std::stoul(size)));
+        }
+        else if (arg == "--generations") options.generations = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--threads") options.threads = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--density") options.density = std::stod(value());
+        else if (arg == "--verify") options.verify = true;
+        else if (arg == "--trace") options.tracePath = value();
+        else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        else throw std::runtime_error("unknown option " + arg);
+    }
+    return options;
+}
+
+// The same generations one cell at a time, no bricks
+VoxelVolume referenceRun(const VoxelVolume& volume, const VoxelRule& rule, uint32_t generations)
+{
+    const int64_t side = volume.getSide();
+    auto wrap = [side](int64_t value) { return static_cast<uint32_t>((value % side + side) % side); };
+    VoxelVolume current = volume;
+    VoxelVolume next(volume.getSide());
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        for (int64_t z = 0; z < side; z++) {
+            for (int64_t y = 0; y < side; y++) {
+                for (int64_t x = 0; x < side; x++) {
+                    uint32_t count = 0;
+                    for (int64_t dz = -1; dz <= 1; dz++) {
+                        for (int64_t dy = -1; dy <= 1; dy++) {
+                            for (int64_t dx = -1; dx <= 1; dx++) {
+                                if (dx == 0 && dy == 0 && dz == 0) continue;
+                                count += current.getCell(wrap(x + dx), wrap(y + dy), wrap(z + dz));
+                            }
+                        }
+                    }
+                    const bool alive = current.getCell(wrap(x), wrap(y), wrap(z));
+                    next.setCell(wrap(x), wrap(y), wrap(z), rule.nextState(alive, count));
+                }
+            }
+        }
+        std::swap(current, next);
+    }
+    return current;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    TRACE_THREAD_NAME("main");
+    try {
+        const Options options = parseOptions(argc, argv);
+        std::vector<VoxelRule> rules;
+        for (const auto& text : options.rules) rules.push_back(VoxelRule::parse(text));
+
+        std::cout << "rule        size   ms/gen    ns/cell  population" << std::endl;
+        uint32_t mismatches = 0;
+        for (const uint32_t size : options.sizes) {
+            const VoxelVolume soup = VoxelVolume::makeSoup(size, options.seed, options.density);
+            for (const VoxelRule& rule : rules) {
+                VoxelEngine engine(rule, options.threads);
+                engine.load(soup);
+                const auto start = std::chrono::steady_clock::now();
+                engine.step(options.generations);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                const double generations = std::max(options.generations, 1u);
+                const double cells = static_cast<double>(size) * size * size * generations;
+                std::cout << std::left << std::setw(10) << rule.toString()
+                          << std::right << std::setw(6) << size
+                          << std::setw(9) << std::fixed << std::setprecision(2) << seconds * 1e3 / generations
+                          << std::setw(11) << std::setprecision(3) << seconds * 1e9 / cells
+                          << std::setw(12) << engine.population() << std::endl;
+
+                if (options.verify && engine.getVolume() != referenceRun(soup, rule, options.generations)) {
+                    mismatches++;
+                    std::cout << "MISMATCH: " << rule.toString() << " at " << size << std::endl;
+                }
+            }
+        }
+
+        if (!options.tracePath.empty()) Trace::save(options.tracePath);
+        if (options.verify) {
+            if (mismatches > 0) {
+                std::cout << mismatches << " runs differ from the cell-by-cell reference" << std::endl;
+                return 1;
+            }
+            std::cout << "verified: every 3D run matches the cell-by-cell reference" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}